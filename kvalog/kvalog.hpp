@@ -1,28 +1,75 @@
 #pragma once
 
 #include <spdlog/async.h>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/pattern_formatter.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <compare>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <nlohmann/json.hpp>
+#include <optional>
+#include <ranges>
 #include <source_location>
-#include <sstream>
+#include <span>
+#include <stop_token>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 #define NOMINMAX
 #include <windows.h>
 #else
+#include <pthread.h>
 #include <sys/syscall.h>
+#include <time.h>
 #include <unistd.h>
 #endif
 
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace kvalog
 {
 
@@ -65,6 +112,31 @@ enum class LogLevel {
     Critical
 };
 
+/// @brief Encoding of the time field
+enum class TimestampStyle {
+    /// @brief Local time, "2025-10-06 21:58:46.529"
+    Local,
+    /// @brief UTC ISO-8601, "2025-10-06T18:58:46.529Z"
+    UtcIso8601,
+    /// @brief RFC 3339 local time with offset, "2025-10-06T21:58:46.529+03:00"
+    Rfc3339,
+    /// @brief Seconds since the Unix epoch as a number
+    EpochSeconds,
+    /// @brief Milliseconds since the Unix epoch as a number
+    EpochMilliseconds,
+    /// @brief Microseconds since the Unix epoch as a number
+    EpochMicroseconds,
+    /// @brief Nanoseconds since the Unix epoch as a number
+    EpochNanoseconds
+};
+
+/// @brief Returns whether a timestamp style is written as a number rather than a string
+constexpr bool IsNumericTimestamp(TimestampStyle style)
+{
+    return style == TimestampStyle::EpochSeconds || style == TimestampStyle::EpochMilliseconds ||
+           style == TimestampStyle::EpochMicroseconds || style == TimestampStyle::EpochNanoseconds;
+}
+
 /// @brief Configuration for which fields to include in logs
 struct LogFieldConfig {
     bool includeAppName = true;
@@ -75,14 +147,352 @@ struct LogFieldConfig {
     bool includeFile = true;
     bool includeMessage = true;
     bool includeTime = true;
+    /// @brief Emits the per-logger sequence number, assigned in call order starting at 1
+    bool includeSequence = false;
+
+    TimestampStyle timestampStyle = TimestampStyle::Local;
+};
+
+/// @brief Key names used by structured output formats
+struct FieldKeys {
+    std::string time = "time";
+    std::string appName = "app";
+    std::string processId = "process_id";
+    std::string threadId = "thread_id";
+    std::string moduleName = "module";
+    std::string level = "level";
+    std::string file = "file";
+    std::string message = "message";
+    std::string sequence = "seq";
+
+    /// @brief Returns short key names for high-volume structured logs
+    static FieldKeys Compact()
+    {
+        return FieldKeys{ .time = "t",
+                          .appName = "app",
+                          .processId = "pid",
+                          .threadId = "tid",
+                          .moduleName = "mod",
+                          .level = "l",
+                          .file = "f",
+                          .message = "m",
+                          .sequence = "seq" };
+    }
+};
+
+/// @brief Value types of JSON records
+struct JsonSchema {
+    /// @brief Emits process_id and thread_id as numbers instead of strings
+    bool numericIds = false;
+    /// @brief Emits the level as its numeric code (Trace = 1 ... Critical = 6) instead of a tag
+    bool numericLevel = false;
+
+    /// @brief Returns the compact schema with native numeric types
+    static JsonSchema Compact()
+    {
+        return JsonSchema{ .numericIds = true, .numericLevel = true };
+    }
 };
 
 /// @brief Output format type
 enum class OutputFormat {
     Json,
-    Terminal
+    Terminal,
+    Logfmt,
+    MessagePack,
+    Otlp,
+    Syslog,
+    Gelf
+};
+
+/// @brief Text encoding of binary data in formats other than the terminal one, which prints a
+/// hex dump
+enum class BinaryEncoding {
+    Hex,
+    Base64
+};
+
+/// @brief Syslog facility, the high part of the RFC 5424 priority
+enum class SyslogFacility {
+    Kernel = 0,
+    User = 1,
+    Mail = 2,
+    Daemon = 3,
+    Auth = 4,
+    Syslog = 5,
+    Lpr = 6,
+    News = 7,
+    Uucp = 8,
+    Cron = 9,
+    AuthPriv = 10,
+    Ftp = 11,
+    Local0 = 16,
+    Local1 = 17,
+    Local2 = 18,
+    Local3 = 19,
+    Local4 = 20,
+    Local5 = 21,
+    Local6 = 22,
+    Local7 = 23
+};
+
+/// @brief Text wrapped around a batch of records sent to a network adapter
+struct BatchEnvelope {
+    /// @brief Text sent before the first record
+    std::string prefix;
+    /// @brief Text sent between two records
+    std::string separator;
+    /// @brief Text sent after the last record
+    std::string suffix;
+
+    /// @brief Envelopes are equal when they wrap records alike
+    bool operator==(const BatchEnvelope &) const = default;
+};
+
+/// @brief Batching of records sent to a network adapter
+struct NetworkBatching {
+    /// @brief Records per batch, one sends every record on its own
+    std::size_t maxRecords = 1;
+    /// @brief Batch size in bytes at which a batch is sent early, zero for no limit
+    std::size_t maxBytes = 0;
+    /// @brief Longest time a record waits in a partial batch, zero to wait for a flush
+    std::chrono::milliseconds maxDelay = std::chrono::milliseconds(0);
+};
+
+/// @brief Usage of a memory budget
+struct MemoryBudgetStats {
+    /// @brief Bytes the call sites admit records up to
+    std::size_t limitBytes = 0;
+    /// @brief Bytes of log data in flight
+    std::size_t currentBytes = 0;
+    /// @brief Most bytes ever in flight
+    std::size_t peakBytes = 0;
+    /// @brief Records dropped to stay within the budget
+    std::uint64_t droppedRecords = 0;
+};
+
+///
+/// @brief
+/// MemoryBudget accounts the bytes of log data in flight: record payloads in async rings,
+/// formatted records in sink queues, pending network batches and socket send queues.
+/// Async call sites admit records against the limit and apply their logger's overflow policy:
+/// Block waits for in-flight bytes to be written, DropOldest drops queued records. Later stages
+/// charge what they hold without waiting, as only they could free it, and shed load on their
+/// own once the budget is exceeded. Bytes held by stages that send on their own schedule, such
+/// as a pending batch, count against the limit but never keep a record out while nothing else
+/// is on its way to a sink, so waiting call sites always make progress.
+/// One budget may be shared by several loggers and adapters.
+///
+class MemoryBudget
+{
+public:
+    /// [Fabric Methods]
+
+    /// @brief Creates a budget of the given size
+    static std::shared_ptr<MemoryBudget> Create(std::size_t limitBytes)
+    {
+        return std::make_shared<MemoryBudget>(limitBytes);
+    }
+
+    /// [Construction & Destruction]
+
+#pragma region MemoryBudget::Construct
+
+    /// @brief Constructor with the budget in bytes
+    /// @warning Avoid using this constructor since class has static fabric methods
+    explicit MemoryBudget(std::size_t limitBytes) : limit(limitBytes) {}
+
+    /// @brief Copy constructor is deleted
+    MemoryBudget(const MemoryBudget &) = delete;
+    /// @brief Copy operator is deleted
+    MemoryBudget & operator=(const MemoryBudget &) = delete;
+
+    /// @brief Destructor
+    ~MemoryBudget() = default;
+
+#pragma endregion
+
+    /// [Accounting]
+
+    /// @brief Charges bytes on their way to a sink when they fit, or when nothing else is on
+    /// its way so that a record larger than the budget still passes on its own
+    bool TryReserve(std::size_t bytes)
+    {
+        auto current = this->current.load(std::memory_order_relaxed);
+        do {
+            if (!this->fits(current, bytes)) {
+                return false;
+            }
+        } while (!this->current.compare_exchange_weak(current, current + bytes,
+                                                      std::memory_order_relaxed));
+        this->flowing.fetch_add(bytes, std::memory_order_relaxed);
+        this->raisePeak(current + bytes);
+        return true;
+    }
+
+    /// @brief Charges bytes, waiting until they fit
+    void Reserve(std::size_t bytes)
+    {
+        while (!this->TryReserve(bytes)) {
+            const auto signal = this->releaseSignal.load(std::memory_order_acquire);
+            this->waiters.fetch_add(1, std::memory_order_relaxed);
+            // Pairs with the fence in Release: either we see the bytes or it sees us waiting
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!this->fits(this->current.load(std::memory_order_relaxed), bytes)) {
+                this->releaseSignal.wait(signal, std::memory_order_acquire);
+            }
+            this->waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Charges bytes a later stage passes on to a sink, beyond the limit if need be
+    void Charge(std::size_t bytes)
+    {
+        this->flowing.fetch_add(bytes, std::memory_order_relaxed);
+        this->raisePeak(this->current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    }
+
+    /// @brief Returns reserved or charged bytes, waking call sites waiting for room
+    void Release(std::size_t bytes)
+    {
+        this->flowing.fetch_sub(bytes, std::memory_order_relaxed);
+        this->ReleaseHeld(bytes);
+    }
+
+    /// @brief Charges bytes a stage holds until it sends them on its own schedule
+    void Hold(std::size_t bytes)
+    {
+        this->raisePeak(this->current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    }
+
+    /// @brief Returns held bytes, waking call sites waiting for room
+    void ReleaseHeld(std::size_t bytes)
+    {
+        this->current.fetch_sub(bytes, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->waiters.load(std::memory_order_relaxed) > 0) {
+            this->releaseSignal.fetch_add(1, std::memory_order_release);
+            this->releaseSignal.notify_all();
+        }
+    }
+
+    /// @brief Returns whether more bytes are in flight than the budget allows
+    bool Exceeded() const
+    {
+        return this->current.load(std::memory_order_relaxed) > this->limit;
+    }
+
+    /// @brief Counts a record dropped to stay within the budget
+    void CountDropped()
+    {
+        this->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Returns the current and peak usage
+    MemoryBudgetStats Stats() const
+    {
+        return MemoryBudgetStats{ .limitBytes = this->limit,
+                                  .currentBytes = this->current.load(std::memory_order_relaxed),
+                                  .peakBytes = this->peak.load(std::memory_order_relaxed),
+                                  .droppedRecords = this->dropped.load(std::memory_order_relaxed) };
+    }
+
+private:
+    /// @brief Returns whether bytes may be admitted on top of the given usage
+    bool fits(std::size_t current, std::size_t bytes) const
+    {
+        return current + bytes <= this->limit || this->flowing.load(std::memory_order_relaxed) == 0;
+    }
+
+    /// @brief Raises the peak to the given usage
+    void raisePeak(std::size_t usage)
+    {
+        auto peak = this->peak.load(std::memory_order_relaxed);
+        while (usage > peak &&
+               !this->peak.compare_exchange_weak(peak, usage, std::memory_order_relaxed)) {
+        }
+    }
+
+    /// [Properties]
+
+    /// @brief Budget in bytes
+    std::size_t limit = 0;
+    /// @brief Bytes in flight
+    std::atomic<std::size_t> current = 0;
+    /// @brief Bytes in flight that are on their way to a sink rather than held by a stage
+    std::atomic<std::size_t> flowing = 0;
+    /// @brief Most bytes ever in flight
+    std::atomic<std::size_t> peak = 0;
+    /// @brief Records dropped to stay within the budget
+    std::atomic<std::uint64_t> dropped = 0;
+    /// @brief Call sites waiting for room
+    std::atomic<std::uint32_t> waiters = 0;
+    /// @brief Futex word waiting call sites sleep on
+    std::atomic<std::uint32_t> releaseSignal = 0;
+};
+
+/// @brief Default bytes of log covered by one index block
+inline constexpr std::size_t DefaultFileIndexBlockSize = std::size_t(64) * 1024;
+/// @brief Extension appended to a log file path to name its index
+inline constexpr auto FileIndexExtension = ".kvx";
+
+/// @brief Sparse index written next to the log file
+struct FileIndexing {
+    /// @brief Bytes of log per index block, zero writes no index
+    std::size_t blockSize = 0;
+};
+
+///
+/// @brief
+/// FileIndexHeader starts a log file index. It is followed by entries, each a FileIndexEntry
+/// and its payload: a FileIndexBlock, or a module id and name assigning a module its bit.
+/// Integers are stored in host byte order.
+///
+struct FileIndexHeader {
+    /// @brief Identifies a log file index
+    static constexpr std::uint64_t Magic = 0x6B76'616C'6F67'7831;  // "kvalogx1"
+    /// @brief Layout version
+    static constexpr std::uint32_t Version = 1;
+
+    std::uint64_t magic = Magic;
+    std::uint32_t version = Version;
+    /// @brief Bytes of log per block, the last block before a flush may be shorter
+    std::uint32_t blockSize = 0;
+};
+
+/// @brief Kind of a log file index entry
+enum class FileIndexEntryKind : std::uint32_t {
+    Block = 1,
+    Module = 2
 };
 
+/// @brief Log file index entry header, followed by size bytes of payload
+struct FileIndexEntry {
+    FileIndexEntryKind kind = FileIndexEntryKind::Block;
+    std::uint32_t size = 0;
+};
+
+/// @brief Statistics of a block of consecutive records in the log file
+struct FileIndexBlock {
+    /// @brief Byte offset of the first record
+    std::uint64_t offset = 0;
+    /// @brief Bytes of the records
+    std::uint64_t length = 0;
+    /// @brief Earliest record time in nanoseconds since the Unix epoch
+    std::int64_t minTime = 0;
+    /// @brief Latest record time in nanoseconds since the Unix epoch
+    std::int64_t maxTime = 0;
+    std::uint32_t records = 0;
+    /// @brief Bit per LogLevel present in the block
+    std::uint32_t levelMask = 0;
+    /// @brief Bit per module id present in the block, the last bit also stands for every
+    /// module with a higher id
+    std::uint64_t moduleMask = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<FileIndexBlock>,
+              "FileIndexBlock is written to index files bytewise");
+
 ///
 /// @brief
 /// INetworkSink defines the interface for network sink adapters
@@ -97,11 +507,24 @@ public:
     virtual void SendLog(const std::string & jsonLog) = 0;
     /// @brief Returns whether the network connection is active
     virtual bool IsConnected() const = 0;
+
+    /// @brief Sends a batch of formatted log entries, already wrapped in its envelope
+    /// @note Sends the batch as a single entry unless overridden
+    virtual void SendBatch(const std::string & batch, [[maybe_unused]] std::size_t recordCount)
+    {
+        this->SendLog(batch);
+    }
+
+    /// @brief Sends records the adapter holds back, called when the network sink is flushed
+    virtual void Flush() {}
 };
 
 ///
 /// @brief
-/// NetworkSink is a custom spdlog sink that forwards log messages to a network adapter
+/// NetworkSink is a custom spdlog sink that forwards log messages to a network adapter.
+/// Records are collected into batches wrapped in the envelope of their output format and sent
+/// when a batch is full, when it is flushed, or after the configured delay. Pending batches are
+/// charged to the memory budget, if any, and sent early while the budget is exceeded.
 ///
 class NetworkSink : public spdlog::sinks::base_sink<std::mutex>
 {
@@ -110,10 +533,32 @@ public:
 
 #pragma region NetworkSink::Construct
 
-    /// @brief Constructor with network adapter
-    explicit NetworkSink(std::shared_ptr<INetworkSink> initialAdapter)
-        : adapter(std::move(initialAdapter))
+    /// @brief Constructor with network adapter, batching and the memory budget pending batches
+    /// are charged to
+    explicit NetworkSink(std::shared_ptr<INetworkSink> initialAdapter,
+                         NetworkBatching initialBatching = NetworkBatching(),
+                         std::shared_ptr<MemoryBudget> initialBudget = nullptr)
+        : adapter(std::move(initialAdapter)), batching(initialBatching),
+          budget(std::move(initialBudget))
+    {
+        if (this->batching.maxRecords > 1 && this->batching.maxDelay.count() > 0) {
+            this->flusher = std::jthread([this](std::stop_token stopToken) {
+                this->flushPeriodically(stopToken);
+            });
+        }
+    }
+
+    /// @brief Destructor, sends the pending batch
+    ~NetworkSink() override
     {
+        if (this->flusher.joinable()) {
+            this->flusher.request_stop();
+            this->flusher.join();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        this->sendBatch();
+        this->flushAdapter();
     }
 
 #pragma endregion
@@ -121,415 +566,5106 @@ public:
     /// [Adapter Management]
 
     /// @brief Replaces the current network adapter with a new one
+    /// @note The pending batch is sent to the previous adapter first
     void SetAdapter(std::shared_ptr<INetworkSink> newAdapter)
     {
         std::lock_guard<std::mutex> lock(mutex_);
+        this->sendBatch();
+        this->flushAdapter();
         this->adapter = std::move(newAdapter);
     }
 
+    /// [Records]
+
+    /// @brief Queues an already formatted record under the envelope of its output format
+    /// @note The pending batch keeps a copy of its envelope; a different envelope starts a new one
+    void LogRecord(const spdlog::details::log_msg & message, const BatchEnvelope & envelope)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        this->appendRecord(std::string_view(message.payload.data(), message.payload.size()),
+                           envelope);
+    }
+
 protected:
-    /// @brief Formats and sends a log message through the network adapter
+    /// @brief Formats a log message and queues it without an envelope
     void sink_it_(const spdlog::details::log_msg & message) override
     {
+        static const auto plainEnvelope = BatchEnvelope();
+
+        spdlog::memory_buf_t formatted;
+        this->formatter_->format(message, formatted);
+        this->appendRecord(std::string_view(formatted.data(), formatted.size()), plainEnvelope);
+    }
+
+    /// @brief Sends the pending batch and flushes the adapter
+    void flush_() override
+    {
+        this->sendBatch();
+        this->flushAdapter();
+    }
+
+private:
+    /// [Batching]
+
+    /// @brief Appends a record to the pending batch and sends the batch once it is full
+    void appendRecord(std::string_view record, const BatchEnvelope & envelope)
+    {
+        if (!this->adapter || !this->adapter->IsConnected()) {
+            return;
+        }
+
+        if (this->pendingRecords > 0 && this->pendingEnvelope != envelope) {
+            this->sendBatch();
+        }
+
+        if (this->pendingRecords == 0) {
+            this->pendingEnvelope = envelope;
+            this->batch.append(envelope.prefix);
+        } else {
+            this->batch.append(envelope.separator);
+        }
+        this->batch.append(record);
+        this->pendingRecords += 1;
+
+        if (this->pendingRecords >= this->batching.maxRecords ||
+            (this->batching.maxBytes > 0 && this->batch.size() >= this->batching.maxBytes)) {
+            this->sendBatch();
+        } else if (this->budget) {
+            this->budget->Hold(this->batch.size() - this->chargedBytes);
+            this->chargedBytes = this->batch.size();
+            if (this->budget->Exceeded()) {
+                this->sendBatch();
+            }
+        }
+    }
+
+    /// @brief Closes the pending batch with its envelope suffix and sends it
+    /// @note Expects the sink mutex to be held
+    void sendBatch()
+    {
+        if (this->pendingRecords == 0) {
+            return;
+        }
+
+        this->batch.append(this->pendingEnvelope.suffix);
         if (this->adapter && this->adapter->IsConnected()) {
-            spdlog::memory_buf_t formatted;
-            this->formatter_->format(message, formatted);
-            this->adapter->SendLog(fmt::to_string(formatted));
+            this->adapter->SendBatch(this->batch, this->pendingRecords);
+        }
+
+        this->batch.clear();
+        this->pendingRecords = 0;
+        if (this->budget) {
+            this->budget->ReleaseHeld(std::exchange(this->chargedBytes, 0));
         }
     }
 
-    /// @brief Flushes the sink (no-op for network sinks)
-    void flush_() override {}
+    /// @brief Flushes the records the adapter holds back
+    /// @note Expects the sink mutex to be held
+    void flushAdapter()
+    {
+        if (this->adapter) {
+            this->adapter->Flush();
+        }
+    }
+
+    /// @brief Sends partial batches every maxDelay until stopped
+    void flushPeriodically(std::stop_token stopToken)
+    {
+        auto wakeMutex = std::mutex();
+        auto wake = std::condition_variable_any();
+
+        while (!stopToken.stop_requested()) {
+            {
+                auto wakeLock = std::unique_lock<std::mutex>(wakeMutex);
+                wake.wait_for(wakeLock, stopToken, this->batching.maxDelay, [] { return false; });
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            this->sendBatch();
+            this->flushAdapter();
+        }
+    }
 
-private:
     /// [Properties]
 
     /// @brief Network adapter for sending log messages
     std::shared_ptr<INetworkSink> adapter = nullptr;
+    /// @brief Batch limits
+    NetworkBatching batching = NetworkBatching();
+    /// @brief Pending batch, envelope prefix and records so far
+    std::string batch;
+    /// @brief Number of records in the pending batch
+    std::size_t pendingRecords = 0;
+    /// @brief Envelope of the pending batch
+    BatchEnvelope pendingEnvelope;
+    /// @brief Budget the pending batch is charged to
+    std::shared_ptr<MemoryBudget> budget;
+    /// @brief Bytes of the pending batch charged to the budget
+    std::size_t chargedBytes = 0;
+    /// @brief Thread sending partial batches after maxDelay, when enabled
+    std::jthread flusher;
 };
 
-/// @brief Default async queue size
-inline constexpr std::size_t DefaultAsyncQueueSize = 8192;
-/// @brief Default async thread count
-inline constexpr std::size_t DefaultAsyncThreadCount = 1;
-/// @brief Milliseconds divisor for time formatting
-inline constexpr int MillisecondsDivisor = 1000;
-/// @brief Millisecond field width for time formatting
-inline constexpr int MillisecondsFieldWidth = 3;
-
-/// @brief ANSI escape codes for terminal log coloring
-namespace AnsiColor
-{
-/// @brief Resets all terminal formatting
-inline constexpr auto Reset = "\033[0m";
-/// @brief Warm tint for the entire log line (bright white foreground)
-inline constexpr auto WarmTint = "\033[97m";
-/// @brief Trace level color (light velvet / light magenta)
-inline constexpr auto Trace = "\033[38;5;183m";
-/// @brief Debug level color (light cyan)
-inline constexpr auto Debug = "\033[96m";
-/// @brief Info level color (light blue)
-inline constexpr auto Info = "\033[94m";
-/// @brief Warning level color (yellow)
-inline constexpr auto Warning = "\033[33m";
-/// @brief Error level color (red)
-inline constexpr auto Error = "\033[31m";
-/// @brief Critical level color (bold red)
-inline constexpr auto Critical = "\033[1;31m";
-}  // namespace AnsiColor
-
 ///
 /// @brief
-/// Logger provides structured logging with configurable output formats, sinks, and fields
+/// IndexedFileSink writes records to a log file like spdlog's basic file sink and a sparse
+/// index of it next to the file. Records are accounted into the current block under the sink
+/// mutex, so the index follows the file exactly; a block is appended to the index once it
+/// covers blockSize bytes of log, or on flush. A block size of zero writes no index.
+/// Records may also be streamed in pieces, which are written as they are produced.
 ///
-class Logger
+class IndexedFileSink : public spdlog::sinks::base_sink<std::mutex>
 {
 public:
-    /// @brief Logging mode
-    enum class Mode {
-        Sync,
-        Async
-    };
+    /// [Construction & Destruction]
 
-    /// @brief Logger configuration
-    struct Config {
-        OutputFormat format = OutputFormat::Terminal;
-        LogFieldConfig fields = LogFieldConfig();
-        Mode asyncMode = Mode::Sync;
+#pragma region IndexedFileSink::Construct
 
-        bool logToConsole = true;
-        bool enableColors = false;
-        std::optional<std::string> logFilePath = std::nullopt;
-        std::shared_ptr<INetworkSink> networkAdapter = nullptr;
+    /// @brief Constructor with the log file path and the block size, truncates both files
+    /// @throws spdlog::spdlog_ex when the log file cannot be opened
+    IndexedFileSink(const std::string & path, std::size_t initialBlockSize)
+        : blockSize(std::max<std::size_t>(initialBlockSize, 1))
+    {
+        this->file.open(path, true);
+        if (initialBlockSize > 0) {
+            this->index = std::fopen((path + FileIndexExtension).c_str(), "wb");
+        }
+        if (this->index != nullptr) {
+            const auto header = FileIndexHeader{
+                .blockSize = static_cast<std::uint32_t>(this->blockSize) };
+            std::fwrite(&header, sizeof(header), 1, this->index);
+        }
+    }
 
-        std::size_t asyncQueueSize = DefaultAsyncQueueSize;
-        std::size_t asyncThreadCount = DefaultAsyncThreadCount;
-    };
+    /// @brief Destructor, appends the last block to the index
+    ~IndexedFileSink() override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        this->closeBlock();
+        if (this->index != nullptr) {
+            std::fclose(this->index);
+        }
+    }
 
-    /// @brief Context information for logs
-    struct Context {
-        std::string appName;
-        std::string moduleName;
-    };
+#pragma endregion
 
-    /// [Fabric Methods]
+    /// [Streaming]
 
-    /// @brief Creates a Logger instance with given configuration
-    static LoggerPtr Create(const Config & config)
+    /// @brief Writes a record produced piece by piece, holding the sink for the whole record
+    /// @param message Record metadata, its payload is ignored
+    /// @param produce Called once with a callable that writes one piece of the record
+    template <typename Producer>
+    void LogStreamed(const spdlog::details::log_msg & message, Producer && produce)
     {
-        return std::make_shared<Logger>(config);
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto length = std::size_t(0);
+        produce([this, &length](std::string_view piece) {
+            this->piece.clear();
+            this->piece.append(piece.data(), piece.data() + piece.size());
+            this->file.write(this->piece);
+            length += piece.size();
+        });
+        this->account(message, length);
     }
 
-    /// @brief Creates a Logger instance with given configuration and context
-    static LoggerPtr Create(const Config & config, const Context & context)
+protected:
+    /// @brief Writes a record to the log file and accounts it into the current block
+    void sink_it_(const spdlog::details::log_msg & message) override
     {
-        return std::make_shared<Logger>(config, context);
+        auto formatted = spdlog::memory_buf_t();
+        this->formatter_->format(message, formatted);
+        this->file.write(formatted);
+        this->account(message, formatted.size());
     }
 
-    /// @brief Creates a new Logger with configuration copied from an existing one
-    static Logger WithConfigFrom(const Logger & source, const Context & newContext)
+    /// @brief Flushes the log file and the index, ending the current block
+    void flush_() override
     {
-        const auto newConfig = source.config;
-        return Logger(newConfig, newContext);
+        this->closeBlock();
+        this->file.flush();
+        if (this->index != nullptr) {
+            std::fflush(this->index);
+        }
     }
 
-    /// [Field Configuration]
+private:
+    /// [Index]
 
-    /// @brief Updates field configuration at runtime
-    void SetFieldConfig(const LogFieldConfig & fields)
+    /// @brief Accounts a written record into the current block
+    void account(const spdlog::details::log_msg & message, std::size_t length)
     {
-        this->config.fields = fields;
+        const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              message.time.time_since_epoch())
+                              .count();
+        if (this->block.records == 0) {
+            this->block.offset = this->offset;
+            this->block.minTime = time;
+            this->block.maxTime = time;
+        }
+        this->block.minTime = std::min<std::int64_t>(this->block.minTime, time);
+        this->block.maxTime = std::max<std::int64_t>(this->block.maxTime, time);
+        this->block.records += 1;
+        const auto level = IndexedFileSink::toLogLevel(message.level);
+        this->block.levelMask |= 1U << static_cast<unsigned>(level);
+        this->block.moduleMask |= this->moduleBit(
+            std::string_view(message.logger_name.data(), message.logger_name.size()));
+        this->block.length += length;
+        this->offset += length;
+
+        if (this->block.length >= this->blockSize) {
+            this->closeBlock();
+        }
     }
 
-    /// @brief Returns current field configuration
-    LogFieldConfig GetFieldConfig() const
+    /// @brief Maps a spdlog level back to the level of the record
+    static LogLevel toLogLevel(spdlog::level::level_enum level)
     {
-        return this->config.fields;
+        switch (level) {
+            case spdlog::level::trace:
+                return LogLevel::Trace;
+            case spdlog::level::debug:
+                return LogLevel::Debug;
+            case spdlog::level::info:
+                return LogLevel::Info;
+            case spdlog::level::warn:
+                return LogLevel::Warning;
+            case spdlog::level::err:
+                return LogLevel::Error;
+            case spdlog::level::critical:
+                return LogLevel::Critical;
+            default:
+                return LogLevel::Off;
+        }
+    }
+
+    /// @brief Returns the bit of a module, announcing a new module in the index
+    std::uint64_t moduleBit(std::string_view module)
+    {
+        // A log file almost always holds the records of a single module
+        if (this->lastModule != nullptr && *this->lastModule == module) {
+            return this->lastModuleBit;
+        }
+
+        auto position = this->modules.find(std::string(module));
+        if (position == this->modules.end()) {
+            const auto id = static_cast<std::uint32_t>(this->modules.size());
+            position = this->modules.emplace(std::string(module), id).first;
+            this->appendEntry(FileIndexEntryKind::Module, &id, sizeof(id), module);
+        }
+
+        constexpr auto lastBit = std::uint32_t(63);
+        this->lastModule = &position->first;
+        this->lastModuleBit = std::uint64_t(1) << std::min(position->second, lastBit);
+        return this->lastModuleBit;
+    }
+
+    /// @brief Appends the current block to the index and starts a new one
+    void closeBlock()
+    {
+        if (this->block.records == 0) {
+            return;
+        }
+        this->appendEntry(FileIndexEntryKind::Block, &this->block, sizeof(this->block), {});
+        this->block = FileIndexBlock();
+    }
+
+    /// @brief Appends an entry made of a fixed part and a variable part
+    void appendEntry(FileIndexEntryKind kind, const void * fixed, std::size_t fixedSize,
+                     std::string_view variable)
+    {
+        if (this->index == nullptr) {
+            return;
+        }
+        const auto entry = FileIndexEntry{
+            .kind = kind, .size = static_cast<std::uint32_t>(fixedSize + variable.size()) };
+        std::fwrite(&entry, sizeof(entry), 1, this->index);
+        std::fwrite(fixed, fixedSize, 1, this->index);
+        std::fwrite(variable.data(), 1, variable.size(), this->index);
+    }
+
+    /// [Properties]
+
+    /// @brief Log file
+    spdlog::details::file_helper file;
+    /// @brief Piece of a streamed record being written
+    spdlog::memory_buf_t piece;
+    /// @brief Index file, nullptr when it could not be created
+    std::FILE * index = nullptr;
+    /// @brief Bytes of log per block
+    std::size_t blockSize = 0;
+    /// @brief Bytes written to the log file
+    std::uint64_t offset = 0;
+    /// @brief Block being filled
+    FileIndexBlock block = FileIndexBlock();
+    /// @brief Module ids announced in the index
+    std::unordered_map<std::string, std::uint32_t> modules;
+    /// @brief Module looked up last and its bit
+    const std::string * lastModule = nullptr;
+    std::uint64_t lastModuleBit = 0;
+};
+
+/// @brief Default async queue size
+inline constexpr std::size_t DefaultAsyncQueueSize = 8192;
+/// @brief Bytes of a binary record kept by default, the rest is only counted
+inline constexpr std::size_t DefaultHexLimit = 256;
+/// @brief Default async thread count
+inline constexpr std::size_t DefaultAsyncThreadCount = 1;
+
+/// @brief Handling of records logged while the async queue of their worker is full
+enum class AsyncOverflow {
+    /// @brief The call site waits for room
+    Block,
+    /// @brief The oldest queued record is dropped; sequence numbers show the gap
+    DropOldest
+};
+
+/// @brief How idle async workers wait for records
+enum class IdleStrategy {
+    /// @brief Spin on the queue, keeping a core busy for the lowest wake-up latency
+    BusySpin,
+    /// @brief Spin for a while, then yield the core between checks
+    SpinThenYield,
+    /// @brief Spin for a while, then sleep on a futex until a record arrives
+    Park
+};
+
+/// @brief Pages backing a PageMemory block
+enum class PageBacking {
+    /// @brief Base pages
+    Normal,
+    /// @brief Base pages aligned to a huge page and advised for transparent huge pages, which
+    /// the kernel backs with huge pages as it finds them
+    Transparent,
+    /// @brief Pages reserved from the hugetlbfs pool
+    HugeTlb
+};
+
+/// @brief Huge page size huge page blocks are rounded up and aligned to
+inline constexpr std::size_t HugePageSize = std::size_t(2) << 20;
+
+/// @brief Placement and waiting of async worker threads and their queues
+struct AsyncThreading {
+    /// @brief CPUs the workers are pinned to, worker i to cpus[i % size]; empty leaves them
+    /// floating
+    std::vector<int> cpus;
+    /// @brief NUMA node preferred for queue memory, -1 for the default policy (Linux only)
+    int numaNode = -1;
+    /// @brief How idle workers wait
+    IdleStrategy idle = IdleStrategy::Park;
+    /// @brief Back the rings with huge pages, falling back to base pages (Linux only)
+    bool hugePages = false;
+
+    /// @brief Compares every member, backends are shared by equal threading options
+    auto operator<=>(const AsyncThreading &) const = default;
+};
+
+/// @brief Pause instructions an idle worker spins before it yields or parks
+inline constexpr std::size_t IdleSpinLimit = 4096;
+/// @brief Yields an idle worker makes before it parks
+inline constexpr std::size_t IdleYieldLimit = 64;
+/// @brief Pause instructions and yields of a producer waiting for room before it parks;
+/// a full ring means the worker is behind, so producers give way early
+inline constexpr std::size_t FullQueueSpinLimit = 64;
+/// @brief Largest payload buffer a ring slot keeps for reuse, larger ones are freed once written
+/// so that a burst of large records does not stay allocated in every slot
+inline constexpr std::size_t MaxRetainedPayload = 4096;
+
+/// @brief Per-sink queues of async loggers
+struct SinkQueueing {
+    /// @brief Records queued per output sink, zero writes every sink on the logger's worker
+    std::size_t queueSize = 0;
+};
+
+/// @brief Queue metrics of one output sink
+struct SinkQueueStats {
+    /// @brief Sink name: "console", "file" or "network"
+    std::string name;
+    /// @brief Records waiting, including the one being written
+    std::size_t queuedRecords = 0;
+    /// @brief Most records ever waiting
+    std::size_t peakQueuedRecords = 0;
+    /// @brief Records dropped by a full queue under AsyncOverflow::DropOldest
+    std::uint64_t droppedRecords = 0;
+    /// @brief Age of the oldest waiting record, zero when the sink has caught up
+    std::chrono::nanoseconds lag = std::chrono::nanoseconds(0);
+};
+
+/// @brief Size limits of messages and formatted records, zero for no limit
+struct MessageLimits {
+    /// @brief Message bytes kept when formatting at the call site, the rest is never stored
+    std::size_t maxMessageBytes = 0;
+    /// @brief Formatted record bytes, the message of a longer record is cut to fit
+    std::size_t maxRecordBytes = 0;
+    /// @brief Piece size for streaming records whose message exceeds maxRecordBytes to the log
+    /// file uncut; zero cuts them for every sink
+    std::size_t streamChunkBytes = 0;
+};
+
+/// @brief Appended to a cut message, with the number of bytes cut
+inline constexpr auto TruncationMarker = "...[{} bytes truncated]";
+/// @brief Milliseconds divisor for time formatting
+inline constexpr int MillisecondsDivisor = 1000;
+/// @brief Millisecond field width for time formatting
+inline constexpr int MillisecondsFieldWidth = 3;
+
+/// @brief ANSI escape codes for terminal log coloring
+namespace AnsiColor
+{
+/// @brief Resets all terminal formatting
+inline constexpr auto Reset = "\033[0m";
+/// @brief Warm tint for the entire log line (bright white foreground)
+inline constexpr auto WarmTint = "\033[97m";
+/// @brief Trace level color (light velvet / light magenta)
+inline constexpr auto Trace = "\033[38;5;183m";
+/// @brief Debug level color (light cyan)
+inline constexpr auto Debug = "\033[96m";
+/// @brief Info level color (light blue)
+inline constexpr auto Info = "\033[94m";
+/// @brief Warning level color (yellow)
+inline constexpr auto Warning = "\033[33m";
+/// @brief Error level color (red)
+inline constexpr auto Error = "\033[31m";
+/// @brief Critical level color (bold red)
+inline constexpr auto Critical = "\033[1;31m";
+}  // namespace AnsiColor
+
+/// @brief MessagePack encoders that append straight into a byte buffer
+/// @note Every value uses its smallest encoding, multi-byte lengths and integers are big-endian
+namespace MessagePack
+{
+/// @brief Appends a marker byte followed by the value in the given number of big-endian bytes
+template <typename Buffer>
+inline void WriteBigEndian(Buffer & output, std::uint8_t marker, std::uint64_t value,
+                           std::size_t bytes)
+{
+    constexpr auto bitsPerByte = 8;
+    output.push_back(static_cast<char>(marker));
+    for (auto index = bytes; index > 0; --index) {
+        output.push_back(static_cast<char>((value >> ((index - 1) * bitsPerByte)) & 0xff));
+    }
+}
+
+/// @brief Appends a map header for the given number of key/value pairs
+template <typename Buffer>
+inline void WriteMapHeader(Buffer & output, std::size_t count)
+{
+    constexpr auto fixMapLimit = std::size_t(16);
+    constexpr auto map16Limit = std::size_t(0x10000);
+
+    if (count < fixMapLimit) {
+        output.push_back(static_cast<char>(0x80 | count));
+    } else if (count < map16Limit) {
+        MessagePack::WriteBigEndian(output, 0xde, count, 2);
+    } else {
+        MessagePack::WriteBigEndian(output, 0xdf, count, 4);
+    }
+}
+
+/// @brief Appends a string header for the given number of bytes
+template <typename Buffer>
+inline void WriteStringHeader(Buffer & output, std::size_t length)
+{
+    constexpr auto fixStrLimit = std::size_t(32);
+    constexpr auto str8Limit = std::size_t(0x100);
+    constexpr auto str16Limit = std::size_t(0x10000);
+
+    if (length < fixStrLimit) {
+        output.push_back(static_cast<char>(0xa0 | length));
+    } else if (length < str8Limit) {
+        MessagePack::WriteBigEndian(output, 0xd9, length, 1);
+    } else if (length < str16Limit) {
+        MessagePack::WriteBigEndian(output, 0xda, length, 2);
+    } else {
+        MessagePack::WriteBigEndian(output, 0xdb, length, 4);
+    }
+}
+
+/// @brief Appends a UTF-8 string, written as is with no escaping
+template <typename Buffer>
+inline void WriteString(Buffer & output, std::string_view text)
+{
+    MessagePack::WriteStringHeader(output, text.size());
+    output.append(text.data(), text.data() + text.size());
+}
+
+/// @brief Appends a signed integer
+template <typename Buffer>
+inline void WriteInteger(Buffer & output, std::int64_t value)
+{
+    constexpr auto positiveFixIntLimit = std::int64_t(0x80);
+    constexpr auto negativeFixIntLimit = std::int64_t(-32);
+
+    if (value >= 0) {
+        if (value < positiveFixIntLimit) {
+            output.push_back(static_cast<char>(value));
+        } else if (value <= std::numeric_limits<std::uint8_t>::max()) {
+            MessagePack::WriteBigEndian(output, 0xcc, static_cast<std::uint64_t>(value), 1);
+        } else if (value <= std::numeric_limits<std::uint16_t>::max()) {
+            MessagePack::WriteBigEndian(output, 0xcd, static_cast<std::uint64_t>(value), 2);
+        } else if (value <= std::numeric_limits<std::uint32_t>::max()) {
+            MessagePack::WriteBigEndian(output, 0xce, static_cast<std::uint64_t>(value), 4);
+        } else {
+            MessagePack::WriteBigEndian(output, 0xcf, static_cast<std::uint64_t>(value), 8);
+        }
+        return;
+    }
+
+    const auto bits = static_cast<std::uint64_t>(value);
+    if (value >= negativeFixIntLimit) {
+        output.push_back(static_cast<char>(bits & 0xff));
+    } else if (value >= std::numeric_limits<std::int8_t>::min()) {
+        MessagePack::WriteBigEndian(output, 0xd0, bits & 0xff, 1);
+    } else if (value >= std::numeric_limits<std::int16_t>::min()) {
+        MessagePack::WriteBigEndian(output, 0xd1, bits & 0xffff, 2);
+    } else if (value >= std::numeric_limits<std::int32_t>::min()) {
+        MessagePack::WriteBigEndian(output, 0xd2, bits & 0xffffffff, 4);
+    } else {
+        MessagePack::WriteBigEndian(output, 0xd3, bits, 8);
+    }
+}
+
+/// @brief Appends an unsigned integer
+template <typename Buffer>
+inline void WriteUnsigned(Buffer & output, std::uint64_t value)
+{
+    if (value <= static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+        MessagePack::WriteInteger(output, static_cast<std::int64_t>(value));
+        return;
+    }
+    MessagePack::WriteBigEndian(output, 0xcf, value, 8);
+}
+
+/// @brief Appends a 64-bit float
+template <typename Buffer>
+inline void WriteFloat(Buffer & output, double value)
+{
+    MessagePack::WriteBigEndian(output, 0xcb, std::bit_cast<std::uint64_t>(value), 8);
+}
+
+/// @brief Appends a boolean
+template <typename Buffer>
+inline void WriteBoolean(Buffer & output, bool value)
+{
+    output.push_back(static_cast<char>(value ? 0xc3 : 0xc2));
+}
+
+/// @brief Appends nil
+template <typename Buffer>
+inline void WriteNil(Buffer & output)
+{
+    output.push_back(static_cast<char>(0xc0));
+}
+
+/// @brief Appends an array header for the given number of elements
+template <typename Buffer>
+inline void WriteArrayHeader(Buffer & output, std::size_t count)
+{
+    constexpr auto fixArrayLimit = std::size_t(16);
+    constexpr auto array16Limit = std::size_t(0x10000);
+
+    if (count < fixArrayLimit) {
+        output.push_back(static_cast<char>(0x90 | count));
+    } else if (count < array16Limit) {
+        MessagePack::WriteBigEndian(output, 0xdc, count, 2);
+    } else {
+        MessagePack::WriteBigEndian(output, 0xdd, count, 4);
+    }
+}
+
+/// @brief Type of a decoded value
+enum class ValueType {
+    Nil,
+    Boolean,
+    Integer,
+    Unsigned,
+    Float,
+    String,
+    Array,
+    Map
+};
+
+/// @brief Value decoded from the front of a buffer, the elements of an array or a map follow
+/// it in the buffer
+struct Value {
+    ValueType type = ValueType::Nil;
+    bool boolean = false;
+    std::int64_t integer = 0;
+    std::uint64_t unsignedInteger = 0;
+    double number = 0.0;
+    std::string_view text;
+    /// @brief Elements of an array, pairs of a map
+    std::size_t count = 0;
+};
+
+/// @brief Reads the given number of big-endian bytes after the marker at the front of input
+inline std::uint64_t ReadBigEndian(std::string_view & input, std::size_t bytes)
+{
+    constexpr auto bitsPerByte = 8;
+    auto value = std::uint64_t(0);
+    for (auto index = std::size_t(1); index <= bytes; ++index) {
+        value = (value << bitsPerByte) | static_cast<unsigned char>(input[index]);
+    }
+    input.remove_prefix(1 + bytes);
+    return value;
+}
+
+/// @brief Decodes the value at the front of input written by the encoders above and consumes
+/// it, without the elements of an array or a map
+/// @note Input is trusted, ext and bin values and float32 are not decoded
+inline Value ReadValue(std::string_view & input)
+{
+    auto value = Value();
+    const auto marker = static_cast<unsigned char>(input.front());
+    const auto readString = [&input, &value](std::size_t length) {
+        value.type = ValueType::String;
+        value.text = input.substr(0, length);
+        input.remove_prefix(length);
+    };
+    const auto signExtend = [](std::uint64_t bits, std::size_t bytes) {
+        constexpr auto bitsPerByte = 8;
+        const auto shift = static_cast<int>(64 - bytes * bitsPerByte);
+        return static_cast<std::int64_t>(bits << shift) >> shift;
+    };
+
+    if (marker < 0x80 || marker >= 0xe0) {
+        value.type = ValueType::Integer;
+        value.integer = static_cast<std::int8_t>(marker);
+        input.remove_prefix(1);
+    } else if (marker < 0x90) {
+        value.type = ValueType::Map;
+        value.count = marker & 0x0f;
+        input.remove_prefix(1);
+    } else if (marker < 0xa0) {
+        value.type = ValueType::Array;
+        value.count = marker & 0x0f;
+        input.remove_prefix(1);
+    } else if (marker < 0xc0) {
+        input.remove_prefix(1);
+        readString(marker & 0x1f);
+    } else if (marker == 0xc2 || marker == 0xc3) {
+        value.type = ValueType::Boolean;
+        value.boolean = marker == 0xc3;
+        input.remove_prefix(1);
+    } else if (marker == 0xcb) {
+        value.type = ValueType::Float;
+        value.number = std::bit_cast<double>(MessagePack::ReadBigEndian(input, 8));
+    } else if (marker >= 0xcc && marker <= 0xcf) {
+        const auto bytes = std::size_t(1) << (marker - 0xcc);
+        value.type = ValueType::Unsigned;
+        value.unsignedInteger = MessagePack::ReadBigEndian(input, bytes);
+    } else if (marker >= 0xd0 && marker <= 0xd3) {
+        const auto bytes = std::size_t(1) << (marker - 0xd0);
+        value.type = ValueType::Integer;
+        value.integer = signExtend(MessagePack::ReadBigEndian(input, bytes), bytes);
+    } else if (marker >= 0xd9 && marker <= 0xdb) {
+        readString(MessagePack::ReadBigEndian(input, std::size_t(1) << (marker - 0xd9)));
+    } else if (marker == 0xdc || marker == 0xdd) {
+        value.type = ValueType::Array;
+        value.count = MessagePack::ReadBigEndian(input, marker == 0xdc ? 2 : 4);
+    } else if (marker == 0xde || marker == 0xdf) {
+        value.type = ValueType::Map;
+        value.count = MessagePack::ReadBigEndian(input, marker == 0xde ? 2 : 4);
+    } else {
+        input.remove_prefix(1);
+    }
+    return value;
+}
+}  // namespace MessagePack
+
+/// @brief Text encoders of binary data that append straight into a character buffer
+namespace BinaryText
+{
+/// @brief Lowercase hex digits
+inline constexpr auto HexDigits = std::string_view("0123456789abcdef");
+/// @brief Bytes per hex dump line
+inline constexpr std::size_t DumpLineBytes = 16;
+
+/// @brief Appends the bytes as lowercase hex, two digits per byte
+template <typename Buffer>
+inline void AppendHex(Buffer & output, std::string_view bytes)
+{
+    const auto start = output.size();
+    output.resize(start + bytes.size() * 2);
+    auto * out = output.data() + start;
+    const auto * in = bytes.data();
+    const auto * end = bytes.data() + bytes.size();
+#if defined(__SSE2__)
+    // A nibble becomes '0' + nibble, nibbles over 9 also get the gap between '9' and 'a'
+    const auto nibbleMask = _mm_set1_epi8(0x0f);
+    const auto nine = _mm_set1_epi8(9);
+    const auto zero = _mm_set1_epi8('0');
+    const auto letterGap = _mm_set1_epi8('a' - '0' - 10);
+    const auto toDigits = [&](__m128i nibbles) {
+        const auto letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, nine), letterGap);
+        return _mm_add_epi8(_mm_add_epi8(nibbles, zero), letters);
+    };
+    for (; end - in >= 16; in += 16, out += 32) {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+        const auto high = toDigits(_mm_and_si128(_mm_srli_epi16(chunk, 4), nibbleMask));
+        const auto low = toDigits(_mm_and_si128(chunk, nibbleMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), _mm_unpackhi_epi8(high, low));
+    }
+#endif
+    for (; in < end; ++in) {
+        const auto byte = static_cast<unsigned char>(*in);
+        *out++ = BinaryText::HexDigits[byte >> 4];
+        *out++ = BinaryText::HexDigits[byte & 0x0f];
+    }
+}
+
+/// @brief Appends the bytes as padded standard base64
+template <typename Buffer>
+inline void AppendBase64(Buffer & output, std::string_view bytes)
+{
+    constexpr auto alphabet =
+        std::string_view("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
+    constexpr auto sextetMask = 0x3fU;
+
+    const auto start = output.size();
+    output.resize(start + (bytes.size() + 2) / 3 * 4);
+    auto * out = output.data() + start;
+    const auto byteAt = [&bytes](std::size_t index) {
+        return static_cast<unsigned>(static_cast<unsigned char>(bytes[index]));
+    };
+
+    auto index = std::size_t(0);
+    for (; index + 3 <= bytes.size(); index += 3) {
+        const auto group = (byteAt(index) << 16) | (byteAt(index + 1) << 8) | byteAt(index + 2);
+        *out++ = alphabet[(group >> 18) & sextetMask];
+        *out++ = alphabet[(group >> 12) & sextetMask];
+        *out++ = alphabet[(group >> 6) & sextetMask];
+        *out++ = alphabet[group & sextetMask];
+    }
+    if (index < bytes.size()) {
+        const auto twoBytes = index + 1 < bytes.size();
+        const auto group = (byteAt(index) << 16) | (twoBytes ? byteAt(index + 1) << 8 : 0U);
+        *out++ = alphabet[(group >> 18) & sextetMask];
+        *out++ = alphabet[(group >> 12) & sextetMask];
+        *out++ = twoBytes ? alphabet[(group >> 6) & sextetMask] : '=';
+        *out++ = '=';
+    }
+}
+
+/// @brief Appends a classic dump of the bytes, one line of offset, hex and ASCII columns per
+/// 16 bytes, lines separated by newlines
+template <typename Buffer>
+inline void AppendHexDump(Buffer & output, std::string_view bytes)
+{
+    constexpr auto firstPrintable = 0x20;
+    constexpr auto lastPrintable = 0x7e;
+    constexpr auto halfLine = BinaryText::DumpLineBytes / 2;
+
+    for (auto offset = std::size_t(0); offset < bytes.size(); offset += DumpLineBytes) {
+        const auto line = bytes.substr(offset, DumpLineBytes);
+        if (offset > 0) {
+            output.push_back('\n');
+        }
+        fmt::format_to(std::back_inserter(output), "{:08x} ", offset);
+        for (auto index = std::size_t(0); index < DumpLineBytes; ++index) {
+            output.push_back(' ');
+            if (index == halfLine) {
+                output.push_back(' ');
+            }
+            if (index < line.size()) {
+                const auto byte = static_cast<unsigned char>(line[index]);
+                output.push_back(BinaryText::HexDigits[byte >> 4]);
+                output.push_back(BinaryText::HexDigits[byte & 0x0f]);
+            } else {
+                output.push_back(' ');
+                output.push_back(' ');
+            }
+        }
+        output.push_back(' ');
+        output.push_back(' ');
+        output.push_back('|');
+        for (const auto character : line) {
+            const auto byte = static_cast<unsigned char>(character);
+            output.push_back(byte >= firstPrintable && byte <= lastPrintable ? character : '.');
+        }
+        output.push_back('|');
+    }
+}
+}  // namespace BinaryText
+
+/// @brief Per-record log fields that a format plan can emit
+enum class LogField {
+    Time,
+    ThreadId,
+    /// @brief Per-logger sequence number
+    Sequence,
+    Level,
+    File,
+    Message,
+    /// @brief Full source file path
+    SourcePath,
+    /// @brief Source line number
+    SourceLine,
+    /// @brief OpenTelemetry severity number
+    SeverityNumber,
+    /// @brief OpenTelemetry severity text
+    SeverityText,
+    /// @brief Syslog priority: facility and severity
+    SyslogPriority,
+    /// @brief Syslog severity
+    SyslogSeverity,
+    /// @brief Seconds since the epoch with a millisecond fraction
+    UnixSeconds,
+    /// @brief Structured fields of the record, each with the separator in front of it
+    Fields
+};
+
+/// @brief Alignment of a padded field inside its width
+enum class PatternAlign {
+    Left,
+    Right,
+    Center
+};
+
+/// @brief Escaping applied to per-record string values
+enum class ValueEscaping {
+    /// @brief Written verbatim
+    None,
+    /// @brief Written as JSON string contents
+    Json,
+    /// @brief Written bare, or quoted and escaped when the value requires it
+    Logfmt,
+    /// @brief Written as length-prefixed MessagePack values, never escaped
+    MessagePack,
+    /// @brief Written as RFC 5424 structured data parameter values; the message stays verbatim
+    StructuredData
+};
+
+/// @brief Single step of a format plan: a literal followed by a per-record field
+struct FormatStep {
+    /// @brief Text emitted verbatim before the field value
+    std::string literal;
+    /// @brief Per-record field emitted after the literal
+    LogField field = LogField::Message;
+    /// @brief Minimum width of the field value, zero for no padding
+    std::uint16_t width = 0;
+    /// @brief Padding character
+    char fill = ' ';
+    /// @brief Alignment of the value inside its width
+    PatternAlign align = PatternAlign::Left;
+};
+
+///
+/// @brief
+/// FormatPlan is the precomputed layout of a record for one configuration.
+/// Fields that are constant for a logger (app, module, process id) are folded into literals
+/// when the plan is built, so formatting a record only walks the steps and fills in the rest.
+///
+struct FormatPlan {
+    /// @brief Ordered steps of the record layout
+    std::vector<FormatStep> steps;
+    /// @brief Text emitted after the last step
+    std::string suffix;
+    /// @brief Escaping of per-record string values
+    ValueEscaping escaping = ValueEscaping::None;
+    /// @brief Whether the level tag is wrapped in ANSI colors
+    bool colored = false;
+    /// @brief Encoding of the time field
+    TimestampStyle timestampStyle = TimestampStyle::Local;
+    /// @brief Whether the level is written as its numeric code
+    bool numericLevel = false;
+    /// @brief Whether the thread id is written as a number in binary plans
+    bool numericIds = false;
+    /// @brief Syslog facility of the priority field
+    SyslogFacility facility = SyslogFacility::User;
+    /// @brief Whether structured fields are appended to the message text, for formats whose
+    /// records have no place of their own for them
+    bool fieldsInMessage = false;
+    /// @brief Text wrapped around batches of these records by the network sink
+    BatchEnvelope envelope;
+
+    /// @brief Appends a literal to the plan, merging it into the pending step
+    void AppendLiteral(std::string_view text)
+    {
+        this->suffix.append(text);
+    }
+
+    /// @brief Appends a per-record field, flushing pending literal text in front of it
+    void AppendField(LogField field, std::uint16_t width = 0, char fill = ' ',
+                     PatternAlign align = PatternAlign::Left)
+    {
+        this->steps.push_back(FormatStep{ .literal = std::move(this->suffix),
+                                          .field = field,
+                                          .width = width,
+                                          .fill = fill,
+                                          .align = align });
+        this->suffix.clear();
+    }
+};
+
+/// @brief Placeholders understood by terminal patterns
+enum class PatternField {
+    Literal,
+    Time,
+    AppName,
+    ModuleName,
+    ProcessId,
+    ThreadId,
+    Sequence,
+    Level,
+    File,
+    Message
+};
+
+/// @brief Parsed element of a terminal pattern; literals refer to a range of the pattern text
+struct PatternOp {
+    PatternField field = PatternField::Literal;
+    std::uint32_t offset = 0;
+    std::uint32_t length = 0;
+    std::uint16_t width = 0;
+    char fill = ' ';
+    PatternAlign align = PatternAlign::Left;
+};
+
+/// @brief Maps a placeholder name to its pattern field
+constexpr PatternField PatternFieldFromName(std::string_view name)
+{
+    if (name == "time") {
+        return PatternField::Time;
+    }
+    if (name == "app") {
+        return PatternField::AppName;
+    }
+    if (name == "module") {
+        return PatternField::ModuleName;
+    }
+    if (name == "pid") {
+        return PatternField::ProcessId;
+    }
+    if (name == "tid") {
+        return PatternField::ThreadId;
+    }
+    if (name == "seq") {
+        return PatternField::Sequence;
+    }
+    if (name == "level") {
+        return PatternField::Level;
+    }
+    if (name == "file") {
+        return PatternField::File;
+    }
+    if (name == "msg" || name == "message") {
+        return PatternField::Message;
+    }
+    throw std::invalid_argument("kvalog: unknown pattern placeholder");
+}
+
+///
+/// @brief
+/// Parses a terminal pattern such as "{time} {level:>3} [{module}] {file}: {msg}" and hands
+/// every element to the emit callback. Placeholders accept an optional "[[fill]align]width"
+/// spec with '<', '>' or '^' alignment; "{{" and "}}" produce literal braces.
+/// Usable in constant expressions, where a malformed pattern fails compilation.
+///
+template <typename Emit>
+constexpr void ParsePattern(std::string_view text, Emit && emit)
+{
+    const auto isAlign = [](char character) {
+        return character == '<' || character == '>' || character == '^';
+    };
+    const auto toAlign = [](char character) {
+        return character == '<' ? PatternAlign::Left
+                                : (character == '>' ? PatternAlign::Right : PatternAlign::Center);
+    };
+
+    auto literalStart = std::size_t(0);
+    const auto flushLiteral = [&emit, &literalStart](std::size_t end) {
+        if (end > literalStart) {
+            emit(PatternOp{ .field = PatternField::Literal,
+                            .offset = static_cast<std::uint32_t>(literalStart),
+                            .length = static_cast<std::uint32_t>(end - literalStart) });
+        }
+    };
+
+    auto index = std::size_t(0);
+    while (index < text.size()) {
+        const auto character = text[index];
+
+        if (character == '}') {
+            if (index + 1 >= text.size() || text[index + 1] != '}') {
+                throw std::invalid_argument("kvalog: unmatched '}' in pattern");
+            }
+            flushLiteral(index + 1);
+            index += 2;
+            literalStart = index;
+            continue;
+        }
+
+        if (character != '{') {
+            ++index;
+            continue;
+        }
+
+        if (index + 1 < text.size() && text[index + 1] == '{') {
+            flushLiteral(index + 1);
+            index += 2;
+            literalStart = index;
+            continue;
+        }
+
+        flushLiteral(index);
+
+        const auto close = text.find('}', index);
+        if (close == std::string_view::npos) {
+            throw std::invalid_argument("kvalog: unterminated placeholder in pattern");
+        }
+
+        auto placeholder = text.substr(index + 1, close - index - 1);
+        auto spec = std::string_view();
+        if (const auto colon = placeholder.find(':'); colon != std::string_view::npos) {
+            spec = placeholder.substr(colon + 1);
+            placeholder = placeholder.substr(0, colon);
+        }
+
+        auto op = PatternOp{ .field = PatternFieldFromName(placeholder) };
+        if (spec.size() >= 2 && isAlign(spec[1])) {
+            op.fill = spec[0];
+            op.align = toAlign(spec[1]);
+            spec.remove_prefix(2);
+        } else if (!spec.empty() && isAlign(spec[0])) {
+            op.align = toAlign(spec[0]);
+            spec.remove_prefix(1);
+        }
+        constexpr auto maxWidth = 0xFFFF;
+        auto width = 0;
+        for (const auto digit : spec) {
+            if (digit < '0' || digit > '9') {
+                throw std::invalid_argument("kvalog: invalid width in pattern placeholder");
+            }
+            width = width * 10 + (digit - '0');
+            if (width > maxWidth) {
+                throw std::invalid_argument("kvalog: pattern width is too large");
+            }
+        }
+        op.width = static_cast<std::uint16_t>(width);
+
+        emit(op);
+        index = close + 1;
+        literalStart = index;
+    }
+
+    flushLiteral(text.size());
+}
+
+/// @brief Returns the number of elements a pattern parses into
+constexpr std::size_t CountPatternOps(std::string_view text)
+{
+    auto count = std::size_t(0);
+    ParsePattern(text, [&count](const PatternOp &) { ++count; });
+    return count;
+}
+
+/// @brief Pattern text usable as a template argument for compile-time parsing
+template <std::size_t Size>
+struct PatternLiteral {
+    char text[Size] = {};
+
+    /// @brief Implicit conversion from a string literal
+    consteval PatternLiteral(const char (&value)[Size])
+    {
+        std::copy_n(value, Size, this->text);
+    }
+
+    /// @brief Returns the pattern text without the terminating null
+    constexpr std::string_view View() const
+    {
+        return std::string_view(this->text, Size - 1);
+    }
+};
+
+/// @brief Elements of a pattern parsed at compile time
+template <PatternLiteral Text>
+inline constexpr auto CompiledPatternOps = []() {
+    auto ops = std::array<PatternOp, CountPatternOps(Text.View())>();
+    auto index = std::size_t(0);
+    ParsePattern(Text.View(), [&ops, &index](const PatternOp & op) { ops[index++] = op; });
+    return ops;
+}();
+
+///
+/// @brief
+/// TerminalPattern is a terminal layout parsed once into pattern elements.
+/// Runtime patterns are parsed by Parse; patterns known at build time go through Compile,
+/// which validates them during compilation and performs no parsing at runtime.
+///
+class TerminalPattern
+{
+public:
+    /// [Fabric Methods]
+
+    /// @brief Parses a pattern at runtime, throws std::invalid_argument when it is malformed
+    static TerminalPattern Parse(std::string_view text)
+    {
+        auto ops = std::vector<PatternOp>();
+        ParsePattern(text, [&ops](const PatternOp & op) { ops.push_back(op); });
+        return TerminalPattern(std::string(text), std::move(ops));
+    }
+
+    /// @brief Returns a pattern parsed at compile time
+    template <PatternLiteral Text>
+    static TerminalPattern Compile()
+    {
+        const auto & ops = CompiledPatternOps<Text>;
+        return TerminalPattern(std::string(Text.View()),
+                               std::vector<PatternOp>(ops.begin(), ops.end()));
+    }
+
+    /// [Access]
+
+    /// @brief Returns the pattern text
+    const std::string & Text() const
+    {
+        return this->text;
+    }
+
+    /// @brief Returns the parsed pattern elements
+    const std::vector<PatternOp> & Ops() const
+    {
+        return this->ops;
+    }
+
+    /// @brief Returns the literal text of a pattern element
+    std::string_view LiteralOf(const PatternOp & op) const
+    {
+        return std::string_view(this->text).substr(op.offset, op.length);
+    }
+
+private:
+    /// @brief Constructor with pattern text and its parsed elements
+    TerminalPattern(std::string patternText, std::vector<PatternOp> patternOps)
+        : text(std::move(patternText)), ops(std::move(patternOps))
+    {
+    }
+
+    /// [Properties]
+
+    /// @brief Pattern text that literal elements refer to
+    std::string text;
+    /// @brief Parsed pattern elements
+    std::vector<PatternOp> ops;
+};
+
+///
+/// @brief
+/// SnapshotStore holds an immutable snapshot that readers take a counted reference to without
+/// locking. Writers build a new snapshot and publish it with an exchange; they serialize among
+/// themselves but never block readers. Every thread keeps a reference of its own to the snapshot
+/// it last read, so a reader loads the current snapshot once and, while it is still the one the
+/// thread holds, counts on a reference no other reading thread touches. Only the first read
+/// after a publish takes the writer lock, to reference the snapshot that replaced it. A replaced
+/// snapshot is freed once its last reference is released: queued records release theirs when
+/// written or dropped, threads theirs when they next read the store or exit.
+///
+template <typename T>
+class SnapshotStore
+{
+    struct Counted;
+
+public:
+    ///
+    /// @brief
+    /// Reference holds a reference to a snapshot on behalf of one thread and counts the leases
+    /// taken through it; it releases the snapshot with its last lease
+    ///
+    struct alignas(64) Reference {
+        explicit Reference(const Counted * initialSnapshot) : snapshot(initialSnapshot) {}
+
+        const Counted * snapshot = nullptr;
+        /// @brief Leases, including the one of the thread while the snapshot is its current
+        mutable std::atomic<std::size_t> leases = 1;
+    };
+
+    ///
+    /// @brief
+    /// Lease owns one reference to a snapshot and releases it when it goes away
+    ///
+    class Lease
+    {
+    public:
+        /// @brief Constructor with no snapshot
+        Lease() = default;
+
+        /// @brief Constructor adopting a lease taken with Acquire or Retain
+        explicit Lease(const Reference * initialReference) : reference(initialReference) {}
+
+        /// @brief Copy constructor is deleted
+        Lease(const Lease &) = delete;
+        /// @brief Copy operator is deleted
+        Lease & operator=(const Lease &) = delete;
+
+        /// @brief Move constructor
+        Lease(Lease && other) noexcept : reference(std::exchange(other.reference, nullptr)) {}
+
+        /// @brief Move assignment operator
+        Lease & operator=(Lease && other) noexcept
+        {
+            if (this != &other) {
+                SnapshotStore::Release(this->reference);
+                this->reference = std::exchange(other.reference, nullptr);
+            }
+            return *this;
+        }
+
+        /// @brief Destructor, releases the lease
+        ~Lease()
+        {
+            SnapshotStore::Release(this->reference);
+        }
+
+        /// @brief Returns the snapshot
+        const T & operator*() const noexcept
+        {
+            return *this->reference->snapshot;
+        }
+
+        /// @brief Returns the snapshot
+        const T * operator->() const noexcept
+        {
+            return this->reference->snapshot;
+        }
+
+        /// @brief Returns the snapshot
+        const T * Get() const noexcept
+        {
+            return this->reference->snapshot;
+        }
+
+        /// @brief Returns the reference the lease was taken through
+        const Reference * GetReference() const noexcept
+        {
+            return this->reference;
+        }
+
+        /// @brief Hands the lease to the caller, who releases it with SnapshotStore::Release
+        const Reference * Detach() noexcept
+        {
+            return std::exchange(this->reference, nullptr);
+        }
+
+    private:
+        /// @brief Reference the lease was taken through, nullptr once detached
+        const Reference * reference = nullptr;
+    };
+
+    /// [Construction & Destruction]
+
+#pragma region SnapshotStore::Construct
+
+    /// @brief Constructor with the initial snapshot
+    explicit SnapshotStore(T initial)
+        : current(new Counted(std::move(initial))), identity(SnapshotStore::nextIdentity())
+    {
+    }
+
+    /// @brief Copy constructor is deleted
+    SnapshotStore(const SnapshotStore &) = delete;
+    /// @brief Copy operator is deleted
+    SnapshotStore & operator=(const SnapshotStore &) = delete;
+
+    /// @brief Destructor, releases the references of the store and of the threads that read it
+    ~SnapshotStore()
+    {
+        for (auto * slot : this->slots) {
+            SnapshotStore::dropSlot(slot);
+        }
+        SnapshotStore::unreference(this->current.load(std::memory_order_acquire));
+    }
+
+#pragma endregion
+
+    /// [Access]
+
+    /// @brief Returns a lease on the current snapshot
+    Lease Acquire() const
+    {
+        auto & slot = this->threadSlot();
+        const auto * reference = slot.reference.load(std::memory_order_relaxed);
+        // The thread references its snapshot, so its address cannot be reused while held
+        if (reference == nullptr ||
+            reference->snapshot != this->current.load(std::memory_order_acquire)) {
+            reference = this->refresh(slot);
+        }
+        reference->leases.fetch_add(1, std::memory_order_relaxed);
+        return Lease(reference);
+    }
+
+    /// @brief Takes another lease through a reference the caller holds a lease on
+    static void Retain(const Reference * reference) noexcept
+    {
+        reference->leases.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Releases a lease, freeing the reference and its snapshot reference with the last one
+    static void Release(const Reference * reference) noexcept
+    {
+        if (reference == nullptr) {
+            return;
+        }
+        if (reference->leases.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            SnapshotStore::unreference(reference->snapshot);
+            delete reference;
+        }
+    }
+
+    /// @brief Publishes a snapshot derived from the current one by the given update
+    template <typename Updater>
+    void Update(Updater && update)
+    {
+        std::lock_guard<std::mutex> lock(this->writerMutex);
+        auto next = T(*this->current.load(std::memory_order_relaxed));
+        update(next);
+        const auto * previous =
+            this->current.exchange(new Counted(std::move(next)), std::memory_order_acq_rel);
+        SnapshotStore::unreference(previous);
+        // Slots of exited threads hold no reference, they only wait to be dropped
+        std::erase_if(this->slots, [](Slot * slot) {
+            if (slot->owners.load(std::memory_order_acquire) != 1) {
+                return false;
+            }
+            delete slot;
+            return true;
+        });
+    }
+
+private:
+    /// @brief Snapshot with the count of its references, the store holds one on the current one
+    struct Counted : T {
+        explicit Counted(T value) : T(std::move(value)) {}
+
+        mutable std::atomic<std::size_t> references = 1;
+    };
+
+    /// @brief Reference of one thread to the snapshots of one store, owned by both of them
+    struct Slot {
+        explicit Slot(std::uint64_t storeIdentity) : store(storeIdentity) {}
+
+        /// @brief Identity of the store, addresses of destroyed stores may be reused
+        const std::uint64_t store = 0;
+        /// @brief Lease of the thread, taken by whichever of thread and store goes first
+        std::atomic<const Reference *> reference = nullptr;
+        /// @brief The thread and the store, the last one to let go frees the slot
+        std::atomic<int> owners = 2;
+    };
+
+    /// @brief Slots of the calling thread, released when the thread exits
+    struct ThreadSlots {
+        ThreadSlots() = default;
+        ThreadSlots(const ThreadSlots &) = delete;
+        ThreadSlots & operator=(const ThreadSlots &) = delete;
+
+        ~ThreadSlots()
+        {
+            for (auto * slot : this->slots) {
+                SnapshotStore::dropSlot(slot);
+            }
+        }
+
+        std::vector<Slot *> slots;
+        /// @brief Slot read last, the one a thread logging to a single logger always hits
+        Slot * last = nullptr;
+    };
+
+    /// @brief Returns a process wide unique identity for a store
+    static std::uint64_t nextIdentity() noexcept
+    {
+        static auto identities = std::atomic<std::uint64_t>(0);
+        return identities.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    /// @brief Releases one reference to a snapshot, freeing it with the last one
+    static void unreference(const Counted * snapshot) noexcept
+    {
+        if (snapshot->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete snapshot;
+        }
+    }
+
+    /// @brief Releases the lease of a slot and gives up its ownership
+    static void dropSlot(Slot * slot) noexcept
+    {
+        SnapshotStore::Release(slot->reference.exchange(nullptr, std::memory_order_acq_rel));
+        if (slot->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete slot;
+        }
+    }
+
+    /// @brief Returns the slot of the calling thread, registering one on its first read
+    Slot & threadSlot() const
+    {
+        thread_local auto threadSlots = ThreadSlots();
+        if (threadSlots.last != nullptr && threadSlots.last->store == this->identity) {
+            return *threadSlots.last;
+        }
+        const auto found = std::ranges::find_if(threadSlots.slots, [this](const Slot * slot) {
+            return slot->store == this->identity;
+        });
+        if (found != threadSlots.slots.end()) {
+            threadSlots.last = *found;
+            return **found;
+        }
+
+        // Slots of destroyed stores hold no reference, they only wait to be dropped
+        threadSlots.last = nullptr;
+        std::erase_if(threadSlots.slots, [](Slot * slot) {
+            if (slot->owners.load(std::memory_order_acquire) != 1) {
+                return false;
+            }
+            delete slot;
+            return true;
+        });
+        auto slot = std::make_unique<Slot>(this->identity);
+        threadSlots.slots.reserve(threadSlots.slots.size() + 1);
+        {
+            std::lock_guard<std::mutex> lock(this->writerMutex);
+            this->slots.push_back(slot.get());
+        }
+        threadSlots.slots.push_back(slot.get());
+        threadSlots.last = slot.release();
+        return *threadSlots.last;
+    }
+
+    /// @brief Points the slot of the calling thread at the current snapshot
+    const Reference * refresh(Slot & slot) const
+    {
+        auto reference = std::make_unique<Reference>(nullptr);
+        {
+            // Writers free a replaced snapshot under the lock, the current one stays alive
+            std::lock_guard<std::mutex> lock(this->writerMutex);
+            reference->snapshot = this->current.load(std::memory_order_relaxed);
+            reference->snapshot->references.fetch_add(1, std::memory_order_relaxed);
+        }
+        SnapshotStore::Release(slot.reference.exchange(reference.get(), std::memory_order_acq_rel));
+        return reference.release();
+    }
+
+    /// [Properties]
+
+    /// @brief Snapshot visible to readers
+    std::atomic<const Counted *> current = nullptr;
+    /// @brief Identity the slots of the store are found by
+    const std::uint64_t identity = 0;
+    /// @brief Slots of the threads that read the store, guarded by writerMutex
+    mutable std::vector<Slot *> slots;
+    /// @brief Serializes writers and the reads that follow a publish
+    mutable std::mutex writerMutex;
+};
+
+/// @brief Clock read at the call site to timestamp records
+enum class ClockSource {
+    /// @brief std::chrono::system_clock, converted on the calling thread
+    System,
+    /// @brief Raw TSC ticks converted to wall time by the thread that formats the record;
+    /// falls back to the coarse realtime clock on CPUs without an invariant TSC
+    Tsc
+};
+
+///
+/// @brief
+/// TscClock converts invariant TSC readings to nanoseconds since the Unix epoch.
+/// The call site only executes rdtsc; the conversion runs where records are formatted and uses
+/// a TSC-to-realtime mapping that is recalibrated against the realtime clock once per
+/// CalibrationInterval. Readers access the mapping through a seqlock and never block.
+///
+class TscClock
+{
+public:
+    /// @brief Result of the current calibration
+    struct Calibration {
+        /// @brief Length of one TSC tick
+        double nanosecondsPerTick = 0.0;
+        /// @brief Uncertainty of the realtime anchor, half the tightest rdtsc bracket
+        double anchorErrorNanoseconds = 0.0;
+        /// @brief Realtime of the last calibration
+        std::int64_t calibratedAtNanoseconds = 0;
+    };
+
+    /// @brief Interval between recalibrations against the realtime clock
+    static constexpr auto CalibrationInterval = std::chrono::seconds(1);
+    /// @brief Interval of the initial two-point calibration
+    static constexpr auto InitialCalibrationInterval = std::chrono::milliseconds(10);
+
+    /// [Access]
+
+    /// @brief Returns the process-wide clock, calibrating it on first use
+    static TscClock & Instance()
+    {
+        static auto clock = TscClock();
+        return clock;
+    }
+
+    /// @brief Returns whether the CPU provides an invariant TSC usable as a wall clock source
+    static bool IsInvariant() noexcept
+    {
+        static const auto invariant = TscClock::detectInvariant();
+        return invariant;
+    }
+
+    /// @brief Reads the TSC
+    static std::uint64_t ReadTicks() noexcept
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    /// @brief Reads the realtime clock in nanoseconds since the Unix epoch
+    static std::int64_t ReadRealtimeNanoseconds() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /// @brief Reads the cheapest realtime clock available, with tick-level resolution
+    static std::int64_t ReadCoarseNanoseconds() noexcept
+    {
+#ifdef CLOCK_REALTIME_COARSE
+        auto time = timespec();
+        clock_gettime(CLOCK_REALTIME_COARSE, &time);
+        return static_cast<std::int64_t>(time.tv_sec) * NanosecondsPerSecond + time.tv_nsec;
+#else
+        return TscClock::ReadRealtimeNanoseconds();
+#endif
+    }
+
+    /// @brief Converts TSC ticks to nanoseconds since the Unix epoch
+    std::int64_t ToNanoseconds(std::uint64_t ticks) noexcept
+    {
+        if (ticks >= this->nextCalibrationTicks.load(std::memory_order_relaxed)) {
+            this->tryRecalibrate();
+        }
+
+        const auto mapping = this->loadMapping();
+        const auto elapsed = static_cast<double>(static_cast<std::int64_t>(ticks - mapping.ticks));
+        return mapping.nanoseconds + std::llround(elapsed * mapping.nanosecondsPerTick);
+    }
+
+    /// @brief Returns the current calibration
+    Calibration GetCalibration() const noexcept
+    {
+        const auto mapping = this->loadMapping();
+        return Calibration{ .nanosecondsPerTick = mapping.nanosecondsPerTick,
+                            .anchorErrorNanoseconds = mapping.errorNanoseconds,
+                            .calibratedAtNanoseconds = mapping.nanoseconds };
+    }
+
+    /// [Construction & Destruction]
+
+#pragma region TscClock::Construct
+
+    /// @brief Copy constructor is deleted
+    TscClock(const TscClock &) = delete;
+    /// @brief Copy operator is deleted
+    TscClock & operator=(const TscClock &) = delete;
+
+#pragma endregion
+
+private:
+    /// @brief Nanoseconds in one second
+    static constexpr std::int64_t NanosecondsPerSecond = 1'000'000'000;
+    /// @brief Number of samples taken to find the tightest anchor bracket
+    static constexpr int AnchorSamples = 8;
+    /// @brief Largest relative frequency change accepted over the long calibration baseline
+    static constexpr double MaxFrequencyDrift = 0.001;
+
+    /// @brief Simultaneous TSC and realtime readings
+    struct Anchor {
+        std::uint64_t ticks = 0;
+        std::int64_t nanoseconds = 0;
+        double errorTicks = 0.0;
+    };
+
+    /// @brief Linear TSC-to-realtime mapping
+    struct Mapping {
+        std::uint64_t ticks = 0;
+        std::int64_t nanoseconds = 0;
+        double nanosecondsPerTick = 0.0;
+        double errorNanoseconds = 0.0;
+    };
+
+    /// @brief Constructor performs the initial two-point calibration
+    TscClock()
+    {
+        this->baseline = TscClock::sampleAnchor();
+        std::this_thread::sleep_for(InitialCalibrationInterval);
+        const auto anchor = TscClock::sampleAnchor();
+
+        const auto nanosecondsPerTick =
+            static_cast<double>(anchor.nanoseconds - this->baseline.nanoseconds) /
+            static_cast<double>(anchor.ticks - this->baseline.ticks);
+        this->publish(anchor, nanosecondsPerTick);
+    }
+
+    /// @brief Recalibrates unless another thread is already doing so
+    void tryRecalibrate() noexcept
+    {
+        auto lock = std::unique_lock<std::mutex>(this->calibrationMutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return;
+        }
+
+        const auto anchor = TscClock::sampleAnchor();
+        const auto current = this->loadMapping();
+        auto nanosecondsPerTick =
+            static_cast<double>(anchor.nanoseconds - this->baseline.nanoseconds) /
+            static_cast<double>(anchor.ticks - this->baseline.ticks);
+
+        // A step of the realtime clock (NTP, manual change) skews the long baseline,
+        // so restart it and keep the previous frequency until the next calibration
+        if (std::abs(nanosecondsPerTick / current.nanosecondsPerTick - 1.0) > MaxFrequencyDrift) {
+            this->baseline = anchor;
+            nanosecondsPerTick = current.nanosecondsPerTick;
+        }
+
+        this->publish(anchor, nanosecondsPerTick);
+    }
+
+    /// @brief Publishes a new mapping anchored at the given readings
+    void publish(const Anchor & anchor, double nanosecondsPerTick) noexcept
+    {
+        const auto sequence = this->mappingSequence.load(std::memory_order_relaxed);
+        this->mappingSequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        this->mappingTicks.store(anchor.ticks, std::memory_order_relaxed);
+        this->mappingNanoseconds.store(anchor.nanoseconds, std::memory_order_relaxed);
+        this->mappingNanosecondsPerTick.store(nanosecondsPerTick, std::memory_order_relaxed);
+        this->mappingError.store(anchor.errorTicks * nanosecondsPerTick,
+                                 std::memory_order_relaxed);
+
+        this->mappingSequence.store(sequence + 2, std::memory_order_release);
+
+        const auto intervalTicks = static_cast<std::uint64_t>(
+            static_cast<double>(std::chrono::nanoseconds(CalibrationInterval).count()) /
+            nanosecondsPerTick);
+        this->nextCalibrationTicks.store(anchor.ticks + intervalTicks, std::memory_order_relaxed);
+    }
+
+    /// @brief Reads a consistent copy of the mapping
+    Mapping loadMapping() const noexcept
+    {
+        auto mapping = Mapping();
+        auto before = std::uint64_t(0);
+        auto after = std::uint64_t(0);
+        do {
+            before = this->mappingSequence.load(std::memory_order_acquire);
+            mapping.ticks = this->mappingTicks.load(std::memory_order_relaxed);
+            mapping.nanoseconds = this->mappingNanoseconds.load(std::memory_order_relaxed);
+            mapping.nanosecondsPerTick =
+                this->mappingNanosecondsPerTick.load(std::memory_order_relaxed);
+            mapping.errorNanoseconds = this->mappingError.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = this->mappingSequence.load(std::memory_order_relaxed);
+        } while (before != after || (before & 1) != 0);
+        return mapping;
+    }
+
+    /// @brief Reads the realtime clock bracketed by two TSC reads, keeping the tightest bracket
+    static Anchor sampleAnchor() noexcept
+    {
+        auto best = Anchor();
+        auto bestBracket = std::numeric_limits<std::uint64_t>::max();
+
+        for (auto sample = 0; sample < AnchorSamples; ++sample) {
+            const auto before = TscClock::ReadTicks();
+            const auto nanoseconds = TscClock::ReadRealtimeNanoseconds();
+            const auto after = TscClock::ReadTicks();
+
+            const auto bracket = after - before;
+            if (bracket < bestBracket) {
+                bestBracket = bracket;
+                best = Anchor{ .ticks = before + bracket / 2,
+                               .nanoseconds = nanoseconds,
+                               .errorTicks = static_cast<double>(bracket) / 2.0 };
+            }
+        }
+        return best;
+    }
+
+    /// @brief Checks CPUID for the invariant TSC flag
+    static bool detectInvariant() noexcept
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        constexpr auto powerManagementLeaf = 0x80000007U;
+        constexpr auto invariantTscBit = 1U << 8;
+#ifdef _MSC_VER
+        int registers[4] = {};
+        __cpuid(registers, static_cast<int>(0x80000000U));
+        if (static_cast<unsigned>(registers[0]) < powerManagementLeaf) {
+            return false;
+        }
+        __cpuid(registers, static_cast<int>(powerManagementLeaf));
+        return (static_cast<unsigned>(registers[3]) & invariantTscBit) != 0;
+#else
+        auto eax = 0U;
+        auto ebx = 0U;
+        auto ecx = 0U;
+        auto edx = 0U;
+        if (__get_cpuid(powerManagementLeaf, &eax, &ebx, &ecx, &edx) == 0) {
+            return false;
+        }
+        return (edx & invariantTscBit) != 0;
+#endif
+#else
+        return false;
+#endif
+    }
+
+    /// [Properties]
+
+    /// @brief Start of the long baseline used to estimate the TSC frequency
+    Anchor baseline;
+    /// @brief Serializes recalibrations
+    std::mutex calibrationMutex;
+    /// @brief TSC value after which the next conversion triggers a recalibration
+    std::atomic<std::uint64_t> nextCalibrationTicks = std::numeric_limits<std::uint64_t>::max();
+    /// @brief Seqlock sequence guarding the mapping fields, odd while a write is in progress
+    std::atomic<std::uint64_t> mappingSequence = 0;
+    /// @brief TSC value of the mapping anchor
+    std::atomic<std::uint64_t> mappingTicks = 0;
+    /// @brief Realtime of the mapping anchor
+    std::atomic<std::int64_t> mappingNanoseconds = 0;
+    /// @brief Mapping slope
+    std::atomic<double> mappingNanosecondsPerTick = 0.0;
+    /// @brief Anchor uncertainty in nanoseconds
+    std::atomic<double> mappingError = 0.0;
+};
+
+/// @brief Hints the CPU that the thread is spinning
+inline void CpuRelax() noexcept
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+///
+/// @brief
+/// PageMemory is a block of anonymous memory for queues and ring buffers. Huge page blocks are
+/// taken from the hugetlbfs pool when it has room, else aligned to a huge page and advised for
+/// transparent huge pages, else left on base pages. Large rings touched round-robin then miss
+/// the TLB once per huge page instead of once per base page.
+///
+class PageMemory
+{
+public:
+    /// [Construction & Destruction]
+
+#pragma region PageMemory::Construct
+
+    /// @brief Default constructor, no block
+    PageMemory() = default;
+
+    /// @brief Constructor mapping a block of at least the given size, preferring the given
+    /// NUMA node when it is not -1 (Linux only)
+    /// @throws std::bad_alloc when no memory can be mapped
+    PageMemory(std::size_t bytes, bool hugePages, int numaNode)
+    {
+#if defined(__linux__)
+        if (hugePages) {
+            this->mapHuge(bytes);
+        } else {
+            this->size = bytes;
+            this->data = PageMemory::mapAnonymous(bytes, 0);
+        }
+        if (numaNode >= 0) {
+            PageMemory::bindNode(this->data, this->size, numaNode);
+        }
+#else
+        // Large pages elsewhere need privileges a logger should not ask for
+        static_cast<void>(hugePages);
+        static_cast<void>(numaNode);
+        this->size = bytes;
+        this->data = ::operator new(bytes, std::align_val_t(BaseAlignment));
+#endif
+    }
+
+    /// @brief Copy constructor is deleted
+    PageMemory(const PageMemory &) = delete;
+    /// @brief Copy operator is deleted
+    PageMemory & operator=(const PageMemory &) = delete;
+
+    /// @brief Move constructor
+    PageMemory(PageMemory && other) noexcept
+        : data(std::exchange(other.data, nullptr)),
+          size(std::exchange(other.size, 0)),
+          backing(other.backing)
+    {
+    }
+
+    /// @brief Move operator
+    PageMemory & operator=(PageMemory && other) noexcept
+    {
+        if (this != &other) {
+            this->release();
+            this->data = std::exchange(other.data, nullptr);
+            this->size = std::exchange(other.size, 0);
+            this->backing = other.backing;
+        }
+        return *this;
+    }
+
+    /// @brief Destructor, unmaps the block
+    ~PageMemory()
+    {
+        this->release();
+    }
+
+#pragma endregion
+
+    /// [Properties]
+
+    /// @brief Returns the start of the block
+    void * Data() const noexcept
+    {
+        return this->data;
+    }
+
+    /// @brief Returns the size of the block, rounded up to whole huge pages for huge blocks
+    std::size_t Size() const noexcept
+    {
+        return this->size;
+    }
+
+    /// @brief Returns the pages backing the block
+    PageBacking Backing() const noexcept
+    {
+        return this->backing;
+    }
+
+private:
+    /// @brief Alignment of blocks not mapped by mmap
+    static constexpr std::size_t BaseAlignment = 4096;
+
+#if defined(__linux__)
+    /// @brief Maps anonymous memory with extra mmap flags
+    static void * mapAnonymous(std::size_t bytes, int flags)
+    {
+        auto * memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+        if (memory == MAP_FAILED) {
+            if (flags != 0) {
+                return nullptr;
+            }
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    /// @brief Maps the block on hugetlbfs pages, or on huge page aligned base pages
+    void mapHuge(std::size_t bytes)
+    {
+        this->size = (bytes + HugePageSize - 1) / HugePageSize * HugePageSize;
+        this->data = PageMemory::mapAnonymous(this->size, MAP_HUGETLB);
+        if (this->data != nullptr) {
+            this->backing = PageBacking::HugeTlb;
+            return;
+        }
+
+        // The pool is empty: map one huge page more and trim both ends to an aligned block
+        auto * mapping = static_cast<char *>(
+            PageMemory::mapAnonymous(this->size + HugePageSize, 0));
+        const auto address = reinterpret_cast<std::uintptr_t>(mapping);
+        const auto lead = (HugePageSize - address % HugePageSize) % HugePageSize;
+        if (lead != 0) {
+            munmap(mapping, lead);
+        }
+        munmap(mapping + lead + this->size, HugePageSize - lead);
+        this->data = mapping + lead;
+        this->backing = madvise(this->data, this->size, MADV_HUGEPAGE) == 0
+                            ? PageBacking::Transparent
+                            : PageBacking::Normal;
+    }
+
+    /// @brief Prefers a NUMA node for the block, before any page of it is touched
+    static void bindNode(void * memory, std::size_t bytes, int numaNode)
+    {
+        // MPOL_PREFERRED: the node's memory while it has some, other nodes after that
+        constexpr auto preferredPolicy = 1;
+        constexpr auto nodeBits = sizeof(unsigned long) * 8;
+        auto nodes = std::array<unsigned long, 16>();
+        const auto node = static_cast<std::size_t>(numaNode);
+        if (node < nodes.size() * nodeBits) {
+            nodes[node / nodeBits] = 1UL << (node % nodeBits);
+            syscall(SYS_mbind, memory, bytes, preferredPolicy, nodes.data(),
+                    nodes.size() * nodeBits, 0);
+        }
+    }
+#endif
+
+    /// @brief Unmaps the block
+    void release() noexcept
+    {
+        if (this->data == nullptr) {
+            return;
+        }
+#if defined(__linux__)
+        munmap(this->data, this->size);
+#else
+        ::operator delete(this->data, std::align_val_t(BaseAlignment));
+#endif
+        this->data = nullptr;
+    }
+
+    /// [Properties]
+
+    /// @brief Start of the block
+    void * data = nullptr;
+    /// @brief Size of the block
+    std::size_t size = 0;
+    /// @brief Pages backing the block
+    PageBacking backing = PageBacking::Normal;
+};
+
+///
+/// @brief
+/// AsyncWorker is one async backend thread draining a bounded multi-producer ring of record
+/// payloads. Slots keep their buffers between records, so a warm ring does not allocate.
+/// The worker waits for records with the configured idle strategy; parked workers sleep on a
+/// futex and producers only pay for a wake-up when the worker is actually parked.
+///
+class AsyncWorker
+{
+public:
+    /// @brief Kind of a queued task
+    enum class TaskKind : std::uint8_t {
+        Record,
+        Flush
+    };
+
+    /// @brief Called with the payload of a record that is dropped instead of written
+    using Discard = void (*)(std::string_view payload);
+
+    /// [Construction & Destruction]
+
+#pragma region AsyncWorker::Construct
+
+    /// @brief Constructor with the ring capacity, rounded up to a power of two, the threading
+    /// options and the position of the worker in its backend
+    AsyncWorker(std::size_t queueSize, const AsyncThreading & threading, std::size_t index)
+        : capacity(std::bit_ceil(std::max<std::size_t>(2, queueSize))),
+          idle(threading.idle),
+          spinLimit(std::thread::hardware_concurrency() > 1 ? IdleSpinLimit : 0)
+    {
+        this->memory =
+            PageMemory(this->capacity * sizeof(Slot), threading.hugePages, threading.numaNode);
+        this->slots = AsyncWorker::constructSlots(this->memory, this->capacity);
+        for (auto position = std::size_t(0); position < this->capacity; ++position) {
+            this->slots[position].sequence.store(position, std::memory_order_relaxed);
+        }
+
+        const auto cpu = threading.cpus.empty()
+                             ? std::nullopt
+                             : std::optional<int>(threading.cpus[index % threading.cpus.size()]);
+        this->thread = std::jthread([this, cpu](std::stop_token stopToken) {
+            if (cpu) {
+                AsyncWorker::pinCurrentThread(*cpu);
+            }
+            this->run(stopToken);
+        });
+    }
+
+    /// @brief Copy constructor is deleted
+    AsyncWorker(const AsyncWorker &) = delete;
+    /// @brief Copy operator is deleted
+    AsyncWorker & operator=(const AsyncWorker &) = delete;
+
+    /// @brief Destructor, the worker writes the queued records before it stops
+    ~AsyncWorker()
+    {
+        this->thread.request_stop();
+        this->wake();
+        this->thread.join();
+        for (auto index = std::size_t(0); index < this->capacity; ++index) {
+            this->slots[index].~Slot();
+        }
+    }
+
+#pragma endregion
+
+    /// [Tasks]
+
+    /// @brief Queues a task for the sink, waiting for room or dropping the oldest task when the
+    /// ring is full or the record does not fit in the memory budget
+    /// @param discard Called for the record if it is dropped, also when it is dropped here
+    void Push(const spdlog::sink_ptr & sink, TaskKind kind, spdlog::level::level_enum level,
+              std::string_view payload, AsyncOverflow overflow,
+              const std::shared_ptr<MemoryBudget> & budget = nullptr, Discard discard = nullptr)
+    {
+        const auto charged = budget && kind == TaskKind::Record;
+        if (charged && !this->admit(*budget, payload.size(), overflow)) {
+            if (discard != nullptr) {
+                discard(payload);
+            }
+            return;
+        }
+
+        auto spins = std::size_t(0);
+        auto * slot = this->tryClaim();
+        while (slot == nullptr) {
+            if (overflow == AsyncOverflow::DropOldest && kind == TaskKind::Record &&
+                this->dropOldest()) {
+                this->dropped.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                this->waitForRoom(spins++);
+            }
+            slot = this->tryClaim();
+        }
+
+        slot->task.sink = sink;
+        if (charged) {
+            slot->task.budget = budget;
+        }
+        slot->task.kind.store(kind, std::memory_order_relaxed);
+        slot->task.discard = discard;
+        slot->task.level = level;
+        slot->task.payload.clear();
+        slot->task.payload.append(payload.data(), payload.data() + payload.size());
+        slot->sequence.store(slot->claimed + 1, std::memory_order_release);
+
+        if (this->idle == IdleStrategy::Park) {
+            // Pairs with the fence of a parking worker: either it sees the task or we see it parked
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (this->parked.load(std::memory_order_relaxed)) {
+                this->wake();
+            }
+        }
+    }
+
+    /// @brief Returns the number of records dropped by a full ring
+    std::uint64_t DroppedRecords() const
+    {
+        return this->dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// @brief Queued record payload or flush request
+    struct Task {
+        spdlog::sink_ptr sink;
+        /// @brief Budget the payload is charged to, if any
+        std::shared_ptr<MemoryBudget> budget;
+        /// @brief Atomic so that a producer looking for a record to drop may read it ahead of
+        /// taking the slot
+        std::atomic<TaskKind> kind = TaskKind::Record;
+        /// @brief Called when the record is dropped, if set
+        Discard discard = nullptr;
+        spdlog::level::level_enum level = spdlog::level::info;
+        /// @brief Record header and message; short records stay inline in the slot
+        fmt::basic_memory_buffer<char, 256> payload;
+    };
+
+    /// @brief Ring slot, its sequence tells producers and the consumer whose turn it is
+    struct alignas(64) Slot {
+        std::atomic<std::size_t> sequence = 0;
+        /// @brief Ring position the slot was claimed for
+        std::size_t claimed = 0;
+        Task task;
+    };
+
+    /// [Ring]
+
+    /// @brief Claims the slot at the tail of the ring, nullptr when the ring is full
+    Slot * tryClaim()
+    {
+        auto position = this->tail.load(std::memory_order_relaxed);
+        while (true) {
+            auto & slot = this->slots[position & (this->capacity - 1)];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto difference =
+                static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                if (this->tail.compare_exchange_weak(position, position + 1,
+                                                     std::memory_order_relaxed)) {
+                    slot.claimed = position;
+                    return &slot;
+                }
+            } else if (difference < 0) {
+                return nullptr;
+            } else {
+                position = this->tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief Takes the slot at the head of the ring, nullptr when the ring is empty or, with
+    /// recordsOnly, when the head is a flush
+    Slot * tryTake(bool recordsOnly = false)
+    {
+        auto position = this->head.load(std::memory_order_relaxed);
+        while (true) {
+            auto & slot = this->slots[position & (this->capacity - 1)];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto difference =
+                static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+            if (difference == 0) {
+                // Should the slot be taken and refilled meanwhile, the head has moved on and the
+                // exchange below fails
+                if (recordsOnly &&
+                    slot.task.kind.load(std::memory_order_relaxed) == TaskKind::Flush) {
+                    return nullptr;
+                }
+                if (this->head.compare_exchange_weak(position, position + 1,
+                                                     std::memory_order_relaxed)) {
+                    slot.claimed = position;
+                    return &slot;
+                }
+            } else if (difference < 0) {
+                return nullptr;
+            } else {
+                position = this->head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief Hands a taken slot back to producers, waking those parked on a full ring
+    void release(Slot & slot)
+    {
+        auto & task = slot.task;
+        task.sink.reset();
+        if (task.budget) {
+            task.budget->Release(task.payload.size());
+            task.budget.reset();
+        }
+        if (task.payload.capacity() > MaxRetainedPayload) {
+            task.payload = fmt::basic_memory_buffer<char, 256>();
+        }
+        slot.sequence.store(slot.claimed + this->capacity, std::memory_order_release);
+
+        // Pairs with the fence of a parking producer: either it sees the slot or we see it
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (this->waitingProducers.load(std::memory_order_relaxed) > 0) {
+            this->roomSignal.fetch_add(1, std::memory_order_release);
+            this->roomSignal.notify_all();
+        }
+    }
+
+    /// @brief Charges a record payload to the budget, returns false when the record is dropped
+    bool admit(MemoryBudget & budget, std::size_t bytes, AsyncOverflow overflow)
+    {
+        if (overflow == AsyncOverflow::Block) {
+            budget.Reserve(bytes);
+            return true;
+        }
+        while (!budget.TryReserve(bytes)) {
+            // The bytes may be held further down, so the record itself goes once the ring is empty
+            budget.CountDropped();
+            if (!this->dropOldest()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Discards the oldest queued record, returns whether there was one
+    /// @note A flush at the head is never discarded, it stops the dropping until the worker has
+    /// run it
+    bool dropOldest()
+    {
+        auto * slot = this->tryTake(true);
+        if (slot == nullptr) {
+            return false;
+        }
+        auto & task = slot->task;
+        if (task.discard != nullptr) {
+            task.discard(std::string_view(task.payload.data(), task.payload.size()));
+        }
+        this->release(*slot);
+        return true;
+    }
+
+    /// [Worker]
+
+    /// @brief Runs queued tasks until stopped and drained
+    void run(std::stop_token stopToken)
+    {
+        auto idleRounds = std::size_t(0);
+        while (true) {
+            if (auto * slot = this->tryTake()) {
+                auto & task = slot->task;
+                if (task.kind.load(std::memory_order_relaxed) == TaskKind::Flush) {
+                    task.sink->flush();
+                } else {
+                    task.sink->log(spdlog::details::log_msg(
+                        spdlog::log_clock::time_point(), spdlog::source_loc(),
+                        spdlog::string_view_t(), task.level,
+                        spdlog::string_view_t(task.payload.data(), task.payload.size())));
+                }
+                this->release(*slot);
+                idleRounds = 0;
+                continue;
+            }
+
+            if (stopToken.stop_requested()) {
+                return;
+            }
+            this->waitIdle(stopToken, idleRounds++);
+        }
+    }
+
+    /// @brief Waits once while the ring is empty, following the idle strategy
+    void waitIdle(const std::stop_token & stopToken, std::size_t idleRounds)
+    {
+        if (this->idle == IdleStrategy::BusySpin || idleRounds < this->spinLimit) {
+            CpuRelax();
+            return;
+        }
+        if (this->idle == IdleStrategy::SpinThenYield ||
+            idleRounds < this->spinLimit + IdleYieldLimit) {
+            std::this_thread::yield();
+            return;
+        }
+
+        const auto signal = this->wakeSignal.load(std::memory_order_acquire);
+        this->parked.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto head = this->head.load(std::memory_order_relaxed);
+        const auto & slot = this->slots[head & (this->capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1 &&
+            !stopToken.stop_requested()) {
+            this->wakeSignal.wait(signal, std::memory_order_acquire);
+        }
+        this->parked.store(false, std::memory_order_relaxed);
+    }
+
+    /// @brief Wakes a parked worker
+    void wake()
+    {
+        this->wakeSignal.fetch_add(1, std::memory_order_release);
+        this->wakeSignal.notify_one();
+    }
+
+    /// @brief Waits for room in a full ring: spinning first, then yielding, then parking until
+    /// the worker frees a slot
+    void waitForRoom(std::size_t attempt)
+    {
+        if (attempt < std::min(FullQueueSpinLimit, this->spinLimit)) {
+            CpuRelax();
+            return;
+        }
+        if (attempt < 2 * FullQueueSpinLimit) {
+            std::this_thread::yield();
+            return;
+        }
+
+        const auto signal = this->roomSignal.load(std::memory_order_acquire);
+        this->waitingProducers.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const auto tail = this->tail.load(std::memory_order_relaxed);
+        const auto & slot = this->slots[tail & (this->capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != tail) {
+            this->roomSignal.wait(signal, std::memory_order_acquire);
+        }
+        this->waitingProducers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// [Placement]
+
+    /// @brief Pins the calling thread to a CPU
+    static void pinCurrentThread(int cpu)
+    {
+#if defined(__linux__)
+        auto set = cpu_set_t();
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+        SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+#else
+        static_cast<void>(cpu);
+#endif
+    }
+
+    /// @brief Constructs the ring slots in the ring memory
+    static Slot * constructSlots(const PageMemory & memory, std::size_t count)
+    {
+        auto * slots = static_cast<Slot *>(memory.Data());
+        for (auto index = std::size_t(0); index < count; ++index) {
+            new (slots + index) Slot();
+        }
+        return slots;
+    }
+
+    /// [Properties]
+
+    /// @brief Ring memory
+    PageMemory memory;
+    /// @brief Ring slots, constructed in the ring memory
+    Slot * slots = nullptr;
+    /// @brief Number of slots, a power of two
+    std::size_t capacity = 0;
+    /// @brief How the worker waits for records
+    IdleStrategy idle = IdleStrategy::Park;
+    /// @brief Pause instructions before yielding, none on a single CPU where nobody could fill
+    /// the ring meanwhile
+    std::size_t spinLimit = 0;
+    /// @brief Next position producers claim
+    alignas(64) std::atomic<std::size_t> tail = 0;
+    /// @brief Next position the worker takes
+    alignas(64) std::atomic<std::size_t> head = 0;
+    /// @brief Whether the worker is about to sleep or sleeping on the wake signal
+    alignas(64) std::atomic<bool> parked = false;
+    /// @brief Futex word a parked worker sleeps on
+    std::atomic<std::uint32_t> wakeSignal = 0;
+    /// @brief Producers parked on a full ring
+    alignas(64) std::atomic<std::uint32_t> waitingProducers = 0;
+    /// @brief Futex word producers parked on a full ring sleep on
+    std::atomic<std::uint32_t> roomSignal = 0;
+    /// @brief Records dropped by a full ring
+    std::atomic<std::uint64_t> dropped = 0;
+    /// @brief Worker thread
+    std::jthread thread;
+};
+
+///
+/// @brief
+/// BackendSink is the sink of async loggers: it copies each record payload into the ring of
+/// the logger's worker, which hands it to the target sink on the worker thread. Flushes are
+/// queued behind the records logged before them.
+///
+class BackendSink : public spdlog::sinks::sink
+{
+public:
+    /// @brief Constructor with the worker, the sink the worker writes to, the handling of a
+    /// full ring, the memory budget payloads are admitted against and the cleanup of dropped
+    /// payloads
+    BackendSink(std::shared_ptr<AsyncWorker> initialWorker, spdlog::sink_ptr initialTarget,
+                AsyncOverflow initialOverflow, std::shared_ptr<MemoryBudget> initialBudget,
+                AsyncWorker::Discard initialDiscard = nullptr)
+        : worker(std::move(initialWorker)), target(std::move(initialTarget)),
+          overflow(initialOverflow), budget(std::move(initialBudget)), discard(initialDiscard)
+    {
+    }
+
+    /// @brief Queues a record payload
+    void log(const spdlog::details::log_msg & message) override
+    {
+        this->worker->Push(this->target, AsyncWorker::TaskKind::Record, message.level,
+                           std::string_view(message.payload.data(), message.payload.size()),
+                           this->overflow, this->budget, this->discard);
+    }
+
+    /// @brief Queues a flush of the target sink
+    void flush() override
+    {
+        this->worker->Push(this->target, AsyncWorker::TaskKind::Flush, spdlog::level::off,
+                           std::string_view(), this->overflow);
+    }
+
+    /// @brief Patterns are ignored, records are laid out by format plans
+    void set_pattern(const std::string &) override {}
+
+    /// @brief Formatters are ignored, records are laid out by format plans
+    void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
+
+private:
+    /// @brief Worker writing the records
+    std::shared_ptr<AsyncWorker> worker;
+    /// @brief Sink the worker hands records to
+    spdlog::sink_ptr target;
+    /// @brief Handling of a full ring
+    AsyncOverflow overflow = AsyncOverflow::Block;
+    /// @brief Budget payloads are admitted against, if any
+    std::shared_ptr<MemoryBudget> budget;
+    /// @brief Cleanup of dropped payloads
+    AsyncWorker::Discard discard = nullptr;
+};
+
+///
+/// @brief
+/// AsyncBackend runs the sinks of async loggers on worker threads that each drain their own
+/// bounded ring. A logger is bound to one worker for its lifetime, so its records keep their
+/// call order while loggers bound to different workers write in parallel. Loggers with the
+/// same queue size, worker count, overflow handling and threading options share a backend,
+/// which stops once the last of them is gone. Keeping the overflow handling apart means a
+/// DropOldest logger never drops the records of a Block logger.
+///
+class AsyncBackend
+{
+public:
+    /// [Fabric Methods]
+
+    /// @brief Returns the backend shared by loggers with the given queue size, worker count,
+    /// overflow handling and threading options
+    static std::shared_ptr<AsyncBackend> Acquire(std::size_t queueSize, std::size_t workerCount,
+                                                 AsyncOverflow overflow,
+                                                 const AsyncThreading & threading)
+    {
+        using Key = std::tuple<std::size_t, std::size_t, AsyncOverflow, AsyncThreading>;
+        static auto registryMutex = std::mutex();
+        static auto registry = std::map<Key, std::weak_ptr<AsyncBackend>>();
+
+        const auto lock = std::lock_guard<std::mutex>(registryMutex);
+        auto & slot = registry[Key(queueSize, workerCount, overflow, threading)];
+        auto backend = slot.lock();
+        if (!backend) {
+            backend = std::make_shared<AsyncBackend>(queueSize, workerCount, threading);
+            slot = backend;
+        }
+        return backend;
+    }
+
+    /// [Workers]
+
+    /// @brief Returns the worker of a new logger, assigned round robin
+    std::shared_ptr<AsyncWorker> Assign()
+    {
+        const auto index = this->nextWorker.fetch_add(1, std::memory_order_relaxed);
+        return this->workers[index % this->workers.size()];
+    }
+
+    /// @brief Returns the number of records dropped by full queues since the backend started
+    std::size_t DroppedRecords() const
+    {
+        auto dropped = std::size_t(0);
+        for (const auto & worker : this->workers) {
+            dropped += worker->DroppedRecords();
+        }
+        return dropped;
+    }
+
+    /// [Construction & Destruction]
+
+#pragma region AsyncBackend::Construct
+
+    /// @brief Constructor with the queue size of every worker, the worker count and the
+    /// threading options
+    /// @warning Avoid using this constructor since class has static fabric methods
+    AsyncBackend(std::size_t queueSize, std::size_t workerCount, const AsyncThreading & threading)
+    {
+        for (auto index = std::size_t(0); index < std::max<std::size_t>(1, workerCount); ++index) {
+            this->workers.push_back(std::make_shared<AsyncWorker>(queueSize, threading, index));
+        }
+    }
+
+    /// @brief Copy constructor is deleted
+    AsyncBackend(const AsyncBackend &) = delete;
+    /// @brief Copy operator is deleted
+    AsyncBackend & operator=(const AsyncBackend &) = delete;
+
+    /// @brief Destructor, workers write their queued records before they stop
+    ~AsyncBackend() = default;
+
+#pragma endregion
+
+private:
+    /// [Properties]
+
+    /// @brief Workers, each with its own ring and thread
+    std::vector<std::shared_ptr<AsyncWorker>> workers;
+    /// @brief Worker of the next logger
+    std::atomic<std::size_t> nextWorker = 0;
+};
+
+/// @brief Formatted record shared by the sink queues of a logger, written once and never copied
+struct QueuedRecord {
+    /// @brief Destructor, returns the text to the budget it is charged to and releases the
+    /// owner of the envelope and the logger name
+    ~QueuedRecord()
+    {
+        if (this->budget) {
+            this->budget->Release(this->text.size());
+        }
+        if (this->releaseOwner != nullptr) {
+            this->releaseOwner(this->owner);
+        }
+    }
+
+    /// @brief Formatted text, the message payload refers to it
+    fmt::memory_buffer text;
+    /// @brief Message handed to the sinks
+    spdlog::details::log_msg message;
+    /// @brief Batch envelope for the network sink, owned by the owner
+    const BatchEnvelope * envelope = nullptr;
+    /// @brief Object the envelope and the logger name of the message belong to, referenced by
+    /// the record and released through releaseOwner
+    const void * owner = nullptr;
+    void (*releaseOwner)(const void *) = nullptr;
+    /// @brief Time the record was queued
+    std::chrono::steady_clock::time_point queued;
+    /// @brief Budget the text is charged to, if any
+    std::shared_ptr<MemoryBudget> budget;
+};
+
+///
+/// @brief
+/// QueuedSink gives one output sink a bounded queue and a worker thread of its own, so a slow
+/// sink falls behind alone instead of delaying the others. Queues hold shared references to
+/// records formatted once. The worker writes the queued records before it stops.
+///
+class QueuedSink
+{
+public:
+    /// @brief Writes a record to the wrapped sink
+    using Writer = std::function<void(const QueuedRecord &)>;
+    /// @brief Flushes the wrapped sink
+    using Flusher = std::function<void()>;
+
+    /// [Construction & Destruction]
+
+#pragma region QueuedSink::Construct
+
+    /// @brief Constructor with the sink name, its write and flush operations, the queue capacity
+    /// and the handling of a full queue
+    QueuedSink(std::string initialName, Writer initialWrite, Flusher initialFlush,
+               std::size_t initialCapacity, AsyncOverflow initialOverflow)
+        : name(std::move(initialName)),
+          write(std::move(initialWrite)),
+          flush(std::move(initialFlush)),
+          capacity(std::max<std::size_t>(1, initialCapacity)),
+          overflow(initialOverflow),
+          worker([this](std::stop_token stopToken) { this->run(stopToken); })
+    {
+    }
+
+    /// @brief Copy constructor is deleted
+    QueuedSink(const QueuedSink &) = delete;
+    /// @brief Copy operator is deleted
+    QueuedSink & operator=(const QueuedSink &) = delete;
+
+    /// @brief Destructor, the worker writes the queued records and stops
+    ~QueuedSink() = default;
+
+#pragma endregion
+
+    /// [Records]
+
+    /// @brief Queues a record, waiting for room or dropping the oldest one when full
+    /// @note Under DropOldest, older records no other sink waits for are also dropped while the
+    /// budget is exceeded
+    void Push(std::shared_ptr<const QueuedRecord> record)
+    {
+        {
+            auto lock = std::unique_lock<std::mutex>(this->mutex);
+            if (this->overflow == AsyncOverflow::Block) {
+                this->spaceAvailable.wait(
+                    lock, [this] { return this->records.size() < this->capacity; });
+            } else {
+                if (this->records.size() >= this->capacity) {
+                    this->records.pop_front();
+                    this->dropped += 1;
+                }
+                const auto & budget = record->budget;
+                while (budget && budget->Exceeded() && !this->records.empty() &&
+                       this->records.front().use_count() == 1) {
+                    this->records.pop_front();
+                    this->dropped += 1;
+                    budget->CountDropped();
+                }
+            }
+            this->records.push_back(std::move(record));
+            this->peak = std::max(this->peak, this->records.size() + (this->writing ? 1 : 0));
+        }
+        this->recordsAvailable.notify_one();
+    }
+
+    /// @brief Waits until the queued records are written, then flushes the sink
+    void Flush()
+    {
+        {
+            auto lock = std::unique_lock<std::mutex>(this->mutex);
+            this->drained.wait(lock, [this] { return this->records.empty() && !this->writing; });
+        }
+        this->flush();
+    }
+
+    /// @brief Returns the queue metrics
+    SinkQueueStats Stats() const
+    {
+        const auto lock = std::lock_guard<std::mutex>(this->mutex);
+        auto stats = SinkQueueStats{ .name = this->name,
+                                     .queuedRecords =
+                                         this->records.size() + (this->writing ? 1 : 0),
+                                     .peakQueuedRecords = this->peak,
+                                     .droppedRecords = this->dropped };
+        if (this->writing || !this->records.empty()) {
+            const auto oldest = this->writing ? this->writingQueued : this->records.front()->queued;
+            stats.lag = std::chrono::steady_clock::now() - oldest;
+        }
+        return stats;
+    }
+
+private:
+    /// @brief Writes queued records until stopped and drained
+    void run(std::stop_token stopToken)
+    {
+        auto lock = std::unique_lock<std::mutex>(this->mutex);
+        while (true) {
+            const auto available = this->recordsAvailable.wait(
+                lock, stopToken, [this] { return !this->records.empty(); });
+            if (!available) {
+                return;
+            }
+
+            auto record = std::move(this->records.front());
+            this->records.pop_front();
+            this->writing = true;
+            this->writingQueued = record->queued;
+            lock.unlock();
+            this->spaceAvailable.notify_one();
+
+            this->write(*record);
+            record.reset();
+
+            lock.lock();
+            this->writing = false;
+            if (this->records.empty()) {
+                this->drained.notify_all();
+            }
+        }
+    }
+
+    /// [Properties]
+
+    /// @brief Sink name reported in metrics
+    std::string name;
+    /// @brief Write operation of the wrapped sink
+    Writer write;
+    /// @brief Flush operation of the wrapped sink
+    Flusher flush;
+    /// @brief Most records waiting before the overflow policy applies
+    std::size_t capacity = 0;
+    /// @brief Handling of a full queue
+    AsyncOverflow overflow = AsyncOverflow::Block;
+
+    /// @brief Guards the queue and the metrics
+    mutable std::mutex mutex;
+    /// @brief Signals queued records to the worker
+    std::condition_variable_any recordsAvailable;
+    /// @brief Signals room in the queue to blocked producers
+    std::condition_variable_any spaceAvailable;
+    /// @brief Signals an empty queue to flushes
+    std::condition_variable_any drained;
+    /// @brief Records waiting for the worker
+    std::deque<std::shared_ptr<const QueuedRecord>> records;
+    /// @brief Whether the worker is writing a record taken from the queue
+    bool writing = false;
+    /// @brief Queue time of the record being written
+    std::chrono::steady_clock::time_point writingQueued;
+    /// @brief Most records ever waiting
+    std::size_t peak = 0;
+    /// @brief Records dropped by a full queue
+    std::uint64_t dropped = 0;
+
+    /// @brief Worker thread, declared last so it stops before the members it uses go away
+    std::jthread worker;
+};
+
+/// @brief Last element of a cut array field, with the number of elements left out
+inline constexpr auto ElidedElements = "...{} more";
+/// @brief Key of the last entry of a cut object field, its value is the number of entries left
+/// out
+inline constexpr auto ElidedEntriesKey = "...";
+
+/// @brief Range field cut to its first elements, see limited()
+template <typename Range>
+struct Limited {
+    const Range & range;
+    std::size_t limit = 0;
+};
+
+/// @brief Marks a range for a structured field of which only the first limit elements are
+/// copied into the record, the rest only counted
+template <typename Range>
+Limited<Range> limited(const Range & range, std::size_t limit)
+{
+    return Limited<Range>{ .range = range, .limit = limit };
+}
+
+/// @brief Structured field of a record, see kv()
+template <typename Value>
+struct KeyValue {
+    std::string_view key;
+    Value value;
+};
+
+/// @brief Makes a structured field out of a trailing log argument
+/// @note Fields are not part of the message, placeholders refer to the other arguments only.
+/// A temporary value is moved into the field, anything else is referenced until the call ends
+template <typename Value>
+KeyValue<Value> kv(std::string_view key, Value && value)
+{
+    return KeyValue<Value>{ .key = key, .value = std::forward<Value>(value) };
+}
+
+/// @brief Log argument computed only for records that are written, see lazy()
+template <typename Callable>
+struct Lazy {
+    Callable callable;
+};
+
+/// @brief Defers an expensive log argument, the callable runs at the call site while the message
+/// or the field is encoded, so only for records that passed the level check
+template <typename Callable>
+Lazy<std::decay_t<Callable>> lazy(Callable && callable)
+{
+    return Lazy<std::decay_t<Callable>>{ .callable = std::forward<Callable>(callable) };
+}
+
+/// @brief Call-site encoding of structured field values as MessagePack, text formatting is left
+/// to the thread that formats records
+namespace FieldValue
+{
+template <typename T>
+inline constexpr bool IsLimited = false;
+template <typename Range>
+inline constexpr bool IsLimited<Limited<Range>> = true;
+
+template <typename T>
+inline constexpr bool IsLazy = false;
+template <typename Callable>
+inline constexpr bool IsLazy<Lazy<Callable>> = true;
+
+template <typename T>
+inline constexpr bool IsKeyValue = false;
+template <typename Value>
+inline constexpr bool IsKeyValue<KeyValue<Value>> = true;
+
+/// @brief Types written as MessagePack strings as they are
+template <typename T>
+concept StringLike = std::is_convertible_v<const T &, std::string_view>;
+
+/// @brief Range elements written as object entries
+template <typename T>
+concept PairLike = requires(const T & value) {
+    value.first;
+    value.second;
+};
+
+template <typename Buffer, typename Value>
+void Encode(Buffer & output, const Value & value);
+
+/// @brief Appends a value formatted with fmt as a string
+template <typename Buffer, typename Value>
+inline void EncodeFormatted(Buffer & output, const Value & value)
+{
+    auto text = fmt::memory_buffer();
+    fmt::format_to(std::back_inserter(text), "{}", value);
+    MessagePack::WriteString(output, std::string_view(text.data(), text.size()));
+}
+
+/// @brief Appends at most limit elements of a range as an array, or as a map when the elements
+/// are pairs, followed by the elision entry when elements were left out
+template <typename Buffer, typename Range>
+inline void EncodeRange(Buffer & output, const Range & range, std::size_t limit)
+{
+    using Element = std::ranges::range_value_t<const Range>;
+    constexpr auto isMap = PairLike<Element>;
+
+    const auto total = static_cast<std::size_t>(std::ranges::distance(range));
+    const auto kept = std::min(total, limit);
+    const auto elided = total - kept;
+    const auto count = kept + (elided > 0 ? 1 : 0);
+    if constexpr (isMap) {
+        MessagePack::WriteMapHeader(output, count);
+    } else {
+        MessagePack::WriteArrayHeader(output, count);
+    }
+
+    auto written = std::size_t(0);
+    for (auto it = std::ranges::begin(range); written < kept; ++it, ++written) {
+        if constexpr (isMap) {
+            // Object keys are strings
+            if constexpr (StringLike<decltype(it->first)>) {
+                MessagePack::WriteString(output, std::string_view(it->first));
+            } else {
+                FieldValue::EncodeFormatted(output, it->first);
+            }
+            FieldValue::Encode(output, it->second);
+        } else {
+            FieldValue::Encode(output, *it);
+        }
+    }
+
+    if (elided == 0) {
+        return;
+    }
+    if constexpr (isMap) {
+        MessagePack::WriteString(output, ElidedEntriesKey);
+        MessagePack::WriteUnsigned(output, elided);
+    } else {
+        auto marker = fmt::memory_buffer();
+        fmt::format_to(std::back_inserter(marker), ElidedElements, elided);
+        MessagePack::WriteString(output, std::string_view(marker.data(), marker.size()));
+    }
+}
+
+/// @brief Appends a value: booleans, numbers, strings and ranges natively, limited ranges cut,
+/// lazy values computed, anything else formatted with fmt at the call site
+template <typename Buffer, typename Value>
+void Encode(Buffer & output, const Value & value)
+{
+    if constexpr (IsLimited<Value>) {
+        FieldValue::EncodeRange(output, value.range, value.limit);
+    } else if constexpr (IsLazy<Value>) {
+        FieldValue::Encode(output, value.callable());
+    } else if constexpr (std::is_same_v<Value, bool>) {
+        MessagePack::WriteBoolean(output, value);
+    } else if constexpr (std::is_integral_v<Value> && std::is_signed_v<Value>) {
+        MessagePack::WriteInteger(output, value);
+    } else if constexpr (std::is_integral_v<Value>) {
+        MessagePack::WriteUnsigned(output, value);
+    } else if constexpr (std::is_floating_point_v<Value>) {
+        MessagePack::WriteFloat(output, static_cast<double>(value));
+    } else if constexpr (std::is_null_pointer_v<Value>) {
+        MessagePack::WriteNil(output);
+    } else if constexpr (StringLike<Value>) {
+        MessagePack::WriteString(output, std::string_view(value));
+    } else if constexpr (std::ranges::forward_range<const Value>) {
+        FieldValue::EncodeRange(output, value, std::numeric_limits<std::size_t>::max());
+    } else {
+        FieldValue::EncodeFormatted(output, value);
+    }
+}
+}  // namespace FieldValue
+
+/// @brief Decoded record handed to formatters
+struct LogRecord {
+    LogLevel level = LogLevel::Info;
+    /// @brief Wall time in nanoseconds since the Unix epoch
+    std::int64_t timestamp = 0;
+    int threadId = 0;
+    std::source_location location;
+    std::string_view message;
+    /// @brief Sequence number, zero unless the logger includes the sequence field
+    std::uint64_t sequence = 0;
+    /// @brief Structured fields as a MessagePack map, empty when the record has none
+    std::string_view fields;
+};
+
+///
+/// @brief
+/// IStructuredSink defines the interface for sinks consuming records before formatting, such
+/// as binary or columnar stores. Records are handed over on the thread that formats records,
+/// the backend thread in async mode.
+///
+class IStructuredSink
+{
+public:
+    /// @brief Destructor
+    virtual ~IStructuredSink() = default;
+
+    /// @brief Consumes a record, the record and the names are only valid during the call
+    virtual void WriteRecord(const LogRecord & record, std::string_view appName,
+                             std::string_view moduleName) = 0;
+    /// @brief Makes consumed records durable
+    virtual void Flush() {}
+};
+
+///
+/// @brief
+/// Logger provides structured logging with configurable output formats, sinks, and fields
+///
+class Logger
+{
+public:
+    /// @brief Logging mode
+    enum class Mode {
+        Sync,
+        Async
+    };
+
+    /// @brief Logger configuration
+    struct Config {
+        OutputFormat format = OutputFormat::Terminal;
+        LogFieldConfig fields = LogFieldConfig();
+        FieldKeys keys = FieldKeys();
+        JsonSchema json = JsonSchema();
+        ClockSource clock = ClockSource::System;
+        Mode asyncMode = Mode::Sync;
+
+        bool logToConsole = true;
+        bool enableColors = false;
+        std::optional<TerminalPattern> terminalPattern = std::nullopt;
+        std::optional<std::string> logFilePath = std::nullopt;
+        std::shared_ptr<INetworkSink> networkAdapter = nullptr;
+        NetworkBatching networkBatching = NetworkBatching();
+        FileIndexing logFileIndex = FileIndexing();
+        std::shared_ptr<IStructuredSink> structuredSink = nullptr;
+        SyslogFacility syslogFacility = SyslogFacility::User;
+
+        std::size_t asyncQueueSize = DefaultAsyncQueueSize;
+        std::size_t asyncThreadCount = DefaultAsyncThreadCount;
+        AsyncOverflow asyncOverflow = AsyncOverflow::Block;
+        AsyncThreading asyncThreading = AsyncThreading();
+        SinkQueueing sinkQueueing = SinkQueueing();
+        std::shared_ptr<MemoryBudget> memoryBudget = nullptr;
+        MessageLimits messageLimits = MessageLimits();
+        BinaryEncoding binaryEncoding = BinaryEncoding::Hex;
+    };
+
+    /// @brief Context information for logs
+    struct Context {
+        std::string appName = std::string();
+        std::string moduleName = std::string();
+        /// @brief Host name for syslog and GELF, the system host name when empty
+        std::string hostName = std::string();
+    };
+
+    /// @brief Immutable view of the configuration together with its precomputed format plan
+    struct Snapshot {
+        Config config;
+        Context context;
+        FormatPlan plan;
+    };
+
+    /// [Fabric Methods]
+
+    /// @brief Creates a Logger instance with given configuration
+    static LoggerPtr Create(const Config & config)
+    {
+        return std::make_shared<Logger>(config);
+    }
+
+    /// @brief Creates a Logger instance with given configuration and context
+    static LoggerPtr Create(const Config & config, const Context & context)
+    {
+        return std::make_shared<Logger>(config, context);
+    }
+
+    /// @brief Creates a new Logger with configuration copied from an existing one
+    static Logger WithConfigFrom(const Logger & source, const Context & newContext)
+    {
+        const auto newConfig = source.snapshots->Acquire()->config;
+        return Logger(newConfig, newContext);
+    }
+
+    /// [Field Configuration]
+
+    /// @brief Updates field configuration at runtime
+    void SetFieldConfig(const LogFieldConfig & fields)
+    {
+        this->reconfigure([&fields](Config & config) { config.fields = fields; });
+    }
+
+    /// @brief Returns current field configuration
+    LogFieldConfig GetFieldConfig() const
+    {
+        return this->snapshots->Acquire()->config.fields;
+    }
+
+    /// @brief Updates output format at runtime
+    void SetOutputFormat(OutputFormat format)
+    {
+        this->reconfigure([format](Config & config) { config.format = format; });
+    }
+
+    /// @brief Replaces the terminal layout, std::nullopt restores the default bracketed layout
+    void SetTerminalPattern(std::optional<TerminalPattern> pattern)
+    {
+        this->reconfigure(
+            [&pattern](Config & config) { config.terminalPattern = std::move(pattern); });
+    }
+
+    /// @brief Updates message and record size limits at runtime
+    /// @note Streaming to the log file needs streamChunkBytes at creation, else records are cut
+    void SetMessageLimits(const MessageLimits & limits)
+    {
+        this->reconfigure([&limits](Config & config) { config.messageLimits = limits; });
+    }
+
+    /// [Logging]
+
+    /// @brief Returns whether records of the level are written, for guarding work done only to
+    /// log it
+    bool IsEnabled(LogLevel level) const
+    {
+        if (!this->logger || level == LogLevel::Off) {
+            return false;
+        }
+        const auto minimum = this->level->load(std::memory_order_relaxed);
+        return minimum != LogLevel::Off && static_cast<int>(minimum) <= static_cast<int>(level);
+    }
+
+    /// @brief Logs a message at Trace level with optional format arguments
+    template <typename... Args>
+    void Trace(FormatString format, Args &&... args)
+    {
+        this->log(LogLevel::Trace, format, std::forward<Args>(args)...);
+    }
+
+    /// @brief Logs a message at Debug level with optional format arguments
+    template <typename... Args>
+    void Debug(FormatString format, Args &&... args)
+    {
+        this->log(LogLevel::Debug, format, std::forward<Args>(args)...);
+    }
+
+    /// @brief Logs binary data at Debug level, the call site copies at most limit bytes and the
+    /// formatting thread encodes them as a hex dump in the terminal format, otherwise as
+    /// Config::binaryEncoding
+    void DebugHex(std::string_view label, std::span<const std::byte> bytes,
+                  std::size_t limit = DefaultHexLimit,
+                  const std::source_location & location = std::source_location::current())
+    {
+        if (!this->IsEnabled(LogLevel::Debug)) {
+            return;
+        }
+
+        // The payload owns a lease on the snapshot, the record sink releases it
+        auto lease = this->snapshots->Acquire();
+        const auto & snapshot = *lease;
+
+        auto header = RecordHeader{ .snapshot = &snapshot,
+                                    .reference = lease.GetReference(),
+                                    .kind = RecordKind::Binary,
+                                    .level = LogLevel::Debug,
+                                    .threadId = Logger::getThreadId(),
+                                    .location = location };
+        if (snapshot.config.fields.includeSequence) {
+            header.sequence = this->sequence->fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+        Logger::captureTimestamp(snapshot.config.clock, header);
+
+        // The message limit also bounds the copied bytes, the text they encode to is longer
+        const auto maxMessage = snapshot.config.messageLimits.maxMessageBytes;
+        const auto kept = std::min({ bytes.size(), limit,
+                                     maxMessage > 0 ? maxMessage : bytes.size() });
+        const auto prefix = BinaryPrefix{ .totalBytes = bytes.size(),
+                                          .labelBytes = static_cast<std::uint32_t>(label.size()) };
+
+        auto payload = fmt::memory_buffer();
+        payload.reserve(sizeof(RecordHeader) + sizeof(BinaryPrefix) + label.size() + kept);
+        payload.append(reinterpret_cast<const char *>(&header),
+                       reinterpret_cast<const char *>(&header) + sizeof(RecordHeader));
+        payload.append(reinterpret_cast<const char *>(&prefix),
+                       reinterpret_cast<const char *>(&prefix) + sizeof(BinaryPrefix));
+        Logger::appendText(payload, label);
+        payload.append(reinterpret_cast<const char *>(bytes.data()),
+                       reinterpret_cast<const char *>(bytes.data()) + kept);
+
+        lease.Detach();
+        this->logger->log(spdlog::log_clock::time_point(), spdlog::source_loc(),
+                          Logger::toSpdlogLevel(LogLevel::Debug),
+                          spdlog::string_view_t(payload.data(), payload.size()));
+    }
+
+    /// @brief Logs a message at Info level with optional format arguments
+    template <typename... Args>
+    void Info(FormatString format, Args &&... args)
+    {
+        this->log(LogLevel::Info, format, std::forward<Args>(args)...);
+    }
+
+    /// @brief Logs a message at Warning level with optional format arguments
+    template <typename... Args>
+    void Warning(FormatString format, Args &&... args)
+    {
+        this->log(LogLevel::Warning, format, std::forward<Args>(args)...);
+    }
+
+    /// @brief Logs a message at Error level with optional format arguments
+    template <typename... Args>
+    void Error(FormatString format, Args &&... args)
+    {
+        this->log(LogLevel::Error, format, std::forward<Args>(args)...);
+    }
+
+    /// @brief Logs a message at Critical level with optional format arguments
+    template <typename... Args>
+    void Critical(FormatString format, Args &&... args)
+    {
+        this->log(LogLevel::Critical, format, std::forward<Args>(args)...);
+    }
+
+    /// [Level Management]
+
+    /// @brief Sets minimum log level
+    /// @note The spdlog logger stays at trace: every captured payload has to reach the record
+    /// sink, which releases the snapshot the payload refers to
+    void SetLevel(LogLevel level)
+    {
+        if (this->logger) {
+            this->level->store(level, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Flushes all pending log messages
+    void Flush()
+    {
+        if (this->logger) {
+            this->logger->flush();
+        }
+    }
+
+    /// @brief Returns the queue metrics of every output sink, empty unless sinks are queued
+    std::vector<SinkQueueStats> SinkStats() const
+    {
+        return this->recordSink ? this->recordSink->QueueStats() : std::vector<SinkQueueStats>();
+    }
+
+    /// @brief Returns the number of records dropped because the fields other than the message
+    /// alone exceed MessageLimits::maxRecordBytes
+    std::uint64_t OversizedRecords() const
+    {
+        return this->recordSink ? this->recordSink->OversizedRecords() : 0;
+    }
+
+    /// [Construction & Destruction]
+
+#pragma region Logger::Construct
+
+    /// @brief Copy constructor is deleted
+    Logger(const Logger &) = delete;
+    /// @brief Copy operator is deleted
+    Logger & operator=(const Logger &) = delete;
+
+    /// @brief Move constructor
+    Logger(Logger &&) = default;
+    /// @brief Move assignment operator
+    Logger & operator=(Logger &&) = default;
+
+    /// @brief Constructor with configuration
+    /// @warning Avoid using this constructor since class has static fabric methods
+    explicit Logger(const Config & initialConfig) : Logger(initialConfig, Context()) {}
+
+    /// @brief Constructor with configuration and context
+    /// @warning Avoid using this constructor since class has static fabric methods
+    explicit Logger(const Config & initialConfig, const Context & initialContext)
+        : processId(Logger::getProcessId()),
+          snapshots(std::make_shared<SnapshotStore<Snapshot>>(
+              Logger::makeSnapshot(initialConfig, initialContext, this->processId)))
+    {
+        this->initializeLogger();
+    }
+
+    /// @brief Destructor
+    ~Logger() = default;
+
+#pragma endregion
+
+private:
+#pragma region Logger::PrivateMethods
+
+    /// [Initialization]
+
+    /// @brief Creates the output sink formatter: the formatted record verbatim
+    /// @note The line terminator is part of the format plan, binary records must not get one
+    static std::unique_ptr<spdlog::formatter> makeRecordFormatter()
+    {
+        return std::make_unique<spdlog::pattern_formatter>(
+            "%v", spdlog::pattern_time_type::local, std::string());
+    }
+
+    /// @brief Initializes the spdlog logger with configured sinks
+    void initializeLogger()
+    {
+        const auto snapshot = this->snapshots->Acquire();
+        const auto & config = snapshot->config;
+        auto sinks = std::vector<spdlog::sink_ptr>();
+        auto sinkNames = std::vector<std::string>();
+
+        if (config.logToConsole) {
+            auto consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+            consoleSink->set_formatter(Logger::makeRecordFormatter());
+            sinks.push_back(consoleSink);
+            sinkNames.emplace_back("console");
+        }
+
+        if (config.logFilePath) {
+            auto fileSink = spdlog::sink_ptr();
+            // Oversized records are streamed through the indexed sink, with or without an index
+            if (config.logFileIndex.blockSize > 0 || config.messageLimits.streamChunkBytes > 0) {
+                fileSink = std::make_shared<IndexedFileSink>(*config.logFilePath,
+                                                             config.logFileIndex.blockSize);
+            } else {
+                fileSink =
+                    std::make_shared<spdlog::sinks::basic_file_sink_mt>(*config.logFilePath, true);
+            }
+            fileSink->set_formatter(Logger::makeRecordFormatter());
+            sinks.push_back(fileSink);
+            sinkNames.emplace_back("file");
+        }
+
+        auto networkSink = std::shared_ptr<NetworkSink>();
+        if (config.networkAdapter) {
+            networkSink =
+                std::make_shared<NetworkSink>(config.networkAdapter, config.networkBatching,
+                                              config.memoryBudget);
+            networkSink->set_formatter(Logger::makeRecordFormatter());
+        }
+
+        if (config.clock == ClockSource::Tsc && TscClock::IsInvariant()) {
+            TscClock::Instance();
+        }
+
+        auto recordSink = std::make_shared<RecordSink>(
+            std::move(sinks), std::move(networkSink), config.structuredSink);
+        this->recordSink = recordSink;
+
+        if (config.asyncMode == Mode::Async) {
+            if (config.sinkQueueing.queueSize > 0) {
+                recordSink->QueueSinks(sinkNames, config.sinkQueueing.queueSize,
+                                       config.asyncOverflow);
+            }
+            this->backend = AsyncBackend::Acquire(config.asyncQueueSize, config.asyncThreadCount,
+                                                  config.asyncOverflow, config.asyncThreading);
+            this->logger = std::make_shared<spdlog::logger>(
+                "async_logger",
+                std::make_shared<BackendSink>(this->backend->Assign(), recordSink,
+                                              config.asyncOverflow, config.memoryBudget,
+                                              &Logger::discardRecord));
+        } else {
+            this->logger = std::make_shared<spdlog::logger>("sync_logger", recordSink);
+        }
+
+        this->level->store(LogLevel::Trace, std::memory_order_relaxed);
+        this->logger->set_level(spdlog::level::trace);
     }
 
-    /// @brief Updates output format at runtime
-    void SetOutputFormat(OutputFormat format)
+    /// [Records]
+
+    /// @brief Origin of a record timestamp
+    enum class TimestampKind : std::uint8_t {
+        Nanoseconds,
+        TscTicks
+    };
+
+    /// @brief Content of the bytes after a record header
+    enum class RecordKind : std::uint8_t {
+        /// @brief The formatted message
+        Text,
+        /// @brief A BinaryPrefix, the label and the kept bytes, encoded on the formatting thread
+        Binary
+    };
+
+    /// @brief Fixed-size header preceding the message bytes of a record payload
+    struct RecordHeader {
+        /// @brief Snapshot current at the call site
+        const Snapshot * snapshot = nullptr;
+        /// @brief Reference to the snapshot the payload owns a lease through
+        const SnapshotStore<Snapshot>::Reference * reference = nullptr;
+        std::uint64_t timestamp = 0;
+        TimestampKind timestampKind = TimestampKind::Nanoseconds;
+        RecordKind kind = RecordKind::Text;
+        LogLevel level = LogLevel::Info;
+        int threadId = 0;
+        /// @brief Size of the structured fields map at the end of the payload
+        std::uint32_t fieldBytes = 0;
+        std::uint64_t sequence = 0;
+        std::source_location location;
+    };
+
+    static_assert(std::is_trivially_copyable_v<RecordHeader>,
+                  "RecordHeader is copied into record payloads bytewise");
+
+    /// @brief Sizes leading the body of a binary record
+    struct BinaryPrefix {
+        /// @brief Size of the logged span, the kept bytes may be fewer
+        std::uint64_t totalBytes = 0;
+        std::uint32_t labelBytes = 0;
+    };
+
+    ///
+    /// @brief
+    /// RecordSink is the only sink attached to the spdlog logger. It receives raw record
+    /// payloads, resolves timestamps, formats each record once with the plan of its snapshot
+    /// and forwards the text to the configured sinks. In async mode this runs on the backend
+    /// thread, so the call site only captures the record. With queued sinks the formatted record
+    /// is shared by the sink queues instead and each sink writes it on its own worker.
+    ///
+    class RecordSink : public spdlog::sinks::sink
+    {
+    public:
+        /// @brief Constructor with the output sinks, the network sink and the structured sink
+        RecordSink(std::vector<spdlog::sink_ptr> initialSinks,
+                   std::shared_ptr<NetworkSink> initialNetworkSink,
+                   std::shared_ptr<IStructuredSink> initialStructuredSink)
+            : sinks(std::move(initialSinks)),
+              networkSink(std::move(initialNetworkSink)),
+              structuredSink(std::move(initialStructuredSink))
+        {
+        }
+
+        /// @brief Formats a record payload and forwards it to the output sinks
+        void log(const spdlog::details::log_msg & message) override
+        {
+            auto header = RecordHeader();
+            std::memcpy(&header, message.payload.data(), sizeof(RecordHeader));
+            const auto lease = SnapshotStore<Snapshot>::Lease(header.reference);
+
+            auto body = std::string_view(message.payload.data() + sizeof(RecordHeader),
+                                         message.payload.size() - sizeof(RecordHeader));
+            const auto fields = body.substr(body.size() - header.fieldBytes);
+            body.remove_suffix(header.fieldBytes);
+            // Binary records are encoded here, off the call site
+            auto decoded = fmt::memory_buffer();
+            if (header.kind == RecordKind::Binary) {
+                Logger::encodeBinary(header.snapshot->config, body, decoded);
+                body = std::string_view(decoded.data(), decoded.size());
+            }
+
+            const auto record = LogRecord{
+                .level = header.level,
+                .timestamp = RecordSink::resolveTimestamp(header),
+                .threadId = header.threadId,
+                .location = header.location,
+                .message = body,
+                .sequence = header.sequence,
+                .fields = fields,
+            };
+
+            if (this->structuredSink) {
+                const auto & context = header.snapshot->context;
+                this->structuredSink->WriteRecord(record, context.appName, context.moduleName);
+            }
+            // A logger writing only structured records never needs their text
+            if (this->sinks.empty() && !this->networkSink && this->queues.empty()) {
+                return;
+            }
+            if (!this->queues.empty()) {
+                this->pushRecord(header, record, message.level);
+                return;
+            }
+
+            const auto & plan = header.snapshot->plan;
+            const auto & limits = header.snapshot->config.messageLimits;
+            // A message over the record limit cannot fit, the log file may take it uncut
+            const auto streamed = limits.streamChunkBytes > 0 && limits.maxRecordBytes > 0 &&
+                                  record.message.size() > limits.maxRecordBytes;
+
+            auto output = fmt::memory_buffer();
+            if (!Logger::formatLimitedRecord(plan, record, limits, output)) {
+                this->oversized.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            auto formatted = spdlog::details::log_msg(
+                spdlog::log_clock::time_point(std::chrono::duration_cast<
+                                              spdlog::log_clock::duration>(
+                    std::chrono::nanoseconds(record.timestamp))),
+                spdlog::source_loc(record.location.file_name(),
+                                   static_cast<int>(record.location.line()),
+                                   record.location.function_name()),
+                header.snapshot->context.moduleName, message.level,
+                spdlog::string_view_t(output.data(), output.size()));
+
+            for (const auto & sink : this->sinks) {
+                if (!sink->should_log(formatted.level)) {
+                    continue;
+                }
+                auto * file = streamed ? dynamic_cast<IndexedFileSink *>(sink.get()) : nullptr;
+                if (file == nullptr) {
+                    sink->log(formatted);
+                    continue;
+                }
+                file->LogStreamed(formatted, [&plan, &record, &limits](const auto & write) {
+                    Logger::streamRecord(plan, record, limits.streamChunkBytes, write);
+                });
+            }
+
+            if (this->networkSink && this->networkSink->should_log(formatted.level)) {
+                this->networkSink->LogRecord(formatted, header.snapshot->plan.envelope);
+            }
+        }
+
+        /// @brief Moves every output sink behind a queue and a worker of its own
+        /// @param names Metric names of the output sinks, in order
+        void QueueSinks(const std::vector<std::string> & names, std::size_t queueSize,
+                        AsyncOverflow overflow)
+        {
+            for (auto index = std::size_t(0); index < this->sinks.size(); ++index) {
+                auto sink = this->sinks[index];
+                this->queues.push_back(std::make_unique<QueuedSink>(
+                    names.at(index),
+                    [sink](const QueuedRecord & record) {
+                        if (sink->should_log(record.message.level)) {
+                            sink->log(record.message);
+                        }
+                    },
+                    [sink] { sink->flush(); }, queueSize, overflow));
+            }
+            if (this->networkSink) {
+                auto sink = this->networkSink;
+                this->queues.push_back(std::make_unique<QueuedSink>(
+                    "network",
+                    [sink](const QueuedRecord & record) {
+                        if (sink->should_log(record.message.level)) {
+                            sink->LogRecord(record.message, *record.envelope);
+                        }
+                    },
+                    [sink] { sink->flush(); }, queueSize, overflow));
+            }
+            this->sinks.clear();
+            this->networkSink.reset();
+        }
+
+        /// @brief Returns the metrics of the sink queues, empty when sinks are not queued
+        std::vector<SinkQueueStats> QueueStats() const
+        {
+            auto stats = std::vector<SinkQueueStats>();
+            for (const auto & queue : this->queues) {
+                stats.push_back(queue->Stats());
+            }
+            return stats;
+        }
+
+        /// @brief Returns the number of records dropped for not fitting maxRecordBytes
+        std::uint64_t OversizedRecords() const
+        {
+            return this->oversized.load(std::memory_order_relaxed);
+        }
+
+        /// @brief Flushes the output sinks
+        void flush() override
+        {
+            for (const auto & queue : this->queues) {
+                queue->Flush();
+            }
+            for (const auto & sink : this->sinks) {
+                sink->flush();
+            }
+            if (this->networkSink) {
+                this->networkSink->flush();
+            }
+            if (this->structuredSink) {
+                this->structuredSink->Flush();
+            }
+        }
+
+        /// @brief Patterns are ignored, records are laid out by format plans
+        void set_pattern(const std::string &) override {}
+
+        /// @brief Formatters are ignored, records are laid out by format plans
+        void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
+
+    private:
+        /// @brief Formats a record once and hands the shared result to every sink queue
+        void pushRecord(const RecordHeader & header, const LogRecord & record,
+                        spdlog::level::level_enum level)
+        {
+            const auto & snapshot = *header.snapshot;
+            auto queued = std::make_shared<QueuedRecord>();
+            if (!Logger::formatLimitedRecord(snapshot.plan, record,
+                                             snapshot.config.messageLimits, queued->text)) {
+                this->oversized.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            queued->message = spdlog::details::log_msg(
+                spdlog::log_clock::time_point(std::chrono::duration_cast<
+                                              spdlog::log_clock::duration>(
+                    std::chrono::nanoseconds(record.timestamp))),
+                spdlog::source_loc(record.location.file_name(),
+                                   static_cast<int>(record.location.line()),
+                                   record.location.function_name()),
+                snapshot.context.moduleName, level,
+                spdlog::string_view_t(queued->text.data(), queued->text.size()));
+            queued->envelope = &snapshot.plan.envelope;
+            SnapshotStore<Snapshot>::Retain(header.reference);
+            queued->owner = header.reference;
+            queued->releaseOwner = [](const void * owner) {
+                using Reference = SnapshotStore<Snapshot>::Reference;
+                SnapshotStore<Snapshot>::Release(static_cast<const Reference *>(owner));
+            };
+            queued->queued = std::chrono::steady_clock::now();
+            if (snapshot.config.memoryBudget) {
+                queued->budget = snapshot.config.memoryBudget;
+                queued->budget->Charge(queued->text.size());
+            }
+
+            auto shared = std::shared_ptr<const QueuedRecord>(std::move(queued));
+            for (const auto & queue : this->queues) {
+                queue->Push(shared);
+            }
+        }
+
+        /// @brief Converts the captured timestamp to nanoseconds since the Unix epoch
+        static std::int64_t resolveTimestamp(const RecordHeader & header)
+        {
+            if (header.timestampKind == TimestampKind::TscTicks) {
+                return TscClock::Instance().ToNanoseconds(header.timestamp);
+            }
+            return static_cast<std::int64_t>(header.timestamp);
+        }
+
+        /// @brief Output sinks receiving formatted records
+        std::vector<spdlog::sink_ptr> sinks;
+        /// @brief Network sink receiving formatted records in batches
+        std::shared_ptr<NetworkSink> networkSink;
+        /// @brief Structured sink receiving records before formatting
+        std::shared_ptr<IStructuredSink> structuredSink;
+        /// @brief Records dropped for not fitting maxRecordBytes
+        std::atomic<std::uint64_t> oversized = 0;
+        /// @brief Queued output sinks, replacing the sinks above when sink queueing is on
+        /// @note Declared last, so their workers stop before the sinks above go away
+        std::vector<std::unique_ptr<QueuedSink>> queues;
+    };
+
+    /// [Configuration Snapshots]
+
+    /// @brief Builds a snapshot for the given configuration and context
+    static Snapshot makeSnapshot(const Config & config, const Context & context, int processId)
     {
-        this->config.format = format;
+        auto snapshot = Snapshot{ .config = config, .context = context, .plan = FormatPlan() };
+        snapshot.plan = Logger::buildPlan(snapshot.config, snapshot.context, processId);
+        return snapshot;
     }
 
-    /// [Logging]
+    /// @brief Publishes a new snapshot with the updated configuration and a rebuilt plan
+    template <typename Updater>
+    void reconfigure(Updater && update)
+    {
+        const auto currentProcessId = this->processId;
+        this->snapshots->Update([&update, currentProcessId](Snapshot & snapshot) {
+            update(snapshot.config);
+            snapshot.plan = Logger::buildPlan(snapshot.config, snapshot.context, currentProcessId);
+        });
+    }
 
-    /// @brief Logs a message at Trace level with optional format arguments
-    template <typename... Args>
-    void Trace(FormatString format, Args &&... args)
+    /// [Format Plans]
+
+    /// @brief Builds the format plan for the configured output format
+    /// @note Text records end with the line terminator here; binary records and the
+    /// network formats framed by their transport (syslog, GELF) are not terminated
+    static FormatPlan buildPlan(const Config & config, const Context & context, int processId)
     {
-        this->log(LogLevel::Trace, format, std::forward<Args>(args)...);
+        auto plan = FormatPlan();
+        switch (config.format) {
+            case OutputFormat::Json:
+                plan = Logger::buildJsonPlan(config, context, processId);
+                break;
+            case OutputFormat::Logfmt:
+                plan = Logger::buildLogfmtPlan(config, context, processId);
+                break;
+            case OutputFormat::MessagePack:
+                return Logger::buildMessagePackPlan(config, context, processId);
+            case OutputFormat::Otlp:
+                plan = Logger::buildOtlpPlan(config, context, processId);
+                break;
+            case OutputFormat::Syslog:
+                return Logger::buildSyslogPlan(config, context, processId);
+            case OutputFormat::Gelf:
+                return Logger::buildGelfPlan(config, context, processId);
+            default:
+                plan = Logger::buildTerminalPlan(config, context, processId);
+                break;
+        }
+
+        plan.AppendLiteral(SPDLOG_EOL);
+        return plan;
     }
 
-    /// @brief Logs a message at Debug level with optional format arguments
-    template <typename... Args>
-    void Debug(FormatString format, Args &&... args)
+    /// @brief Builds a JSON object plan, fields ordered as their default keys sort
+    static FormatPlan buildJsonPlan(const Config & config, const Context & context, int processId)
     {
-        this->log(LogLevel::Debug, format, std::forward<Args>(args)...);
+        const auto & fields = config.fields;
+        const auto & keys = config.keys;
+        const auto & schema = config.json;
+        auto plan = FormatPlan();
+        plan.escaping = ValueEscaping::Json;
+        plan.timestampStyle = fields.timestampStyle;
+        plan.numericLevel = schema.numericLevel;
+
+        auto separator = std::string_view("{");
+        const auto key = [&plan, &separator](std::string_view name) {
+            auto quoted = std::string(separator);
+            quoted.push_back('"');
+            Logger::appendJsonEscaped(quoted, name);
+            quoted.append("\":");
+            plan.AppendLiteral(quoted);
+            separator = ",";
+        };
+        const auto constant = [&plan](std::string_view value) {
+            auto quoted = std::string("\"");
+            Logger::appendJsonEscaped(quoted, value);
+            quoted.push_back('"');
+            plan.AppendLiteral(quoted);
+        };
+        const auto field = [&plan](LogField value) {
+            plan.AppendLiteral("\"");
+            plan.AppendField(value);
+            plan.AppendLiteral("\"");
+        };
+
+        if (fields.includeAppName && !context.appName.empty()) {
+            key(keys.appName);
+            constant(context.appName);
+        }
+        if (fields.includeFile) {
+            key(keys.file);
+            field(LogField::File);
+        }
+        if (fields.includeLogLevel) {
+            key(keys.level);
+            if (schema.numericLevel) {
+                plan.AppendField(LogField::Level);
+            } else {
+                field(LogField::Level);
+            }
+        }
+        if (fields.includeMessage) {
+            key(keys.message);
+            field(LogField::Message);
+        }
+        if (fields.includeModuleName && !context.moduleName.empty()) {
+            key(keys.moduleName);
+            constant(context.moduleName);
+        }
+        if (fields.includeProcessId) {
+            key(keys.processId);
+            if (schema.numericIds) {
+                plan.AppendLiteral(std::to_string(processId));
+            } else {
+                constant(std::to_string(processId));
+            }
+        }
+        if (fields.includeSequence) {
+            key(keys.sequence);
+            plan.AppendField(LogField::Sequence);
+        }
+        if (fields.includeThreadId) {
+            key(keys.threadId);
+            if (schema.numericIds) {
+                plan.AppendField(LogField::ThreadId);
+            } else {
+                field(LogField::ThreadId);
+            }
+        }
+        if (fields.includeTime) {
+            key(keys.time);
+            if (IsNumericTimestamp(fields.timestampStyle)) {
+                plan.AppendField(LogField::Time);
+            } else {
+                field(LogField::Time);
+            }
+        }
+
+        if (separator == "{") {
+            plan.AppendLiteral(separator);
+        }
+        plan.AppendField(LogField::Fields);
+        plan.AppendLiteral("}");
+        return plan;
     }
 
-    /// @brief Logs a message at Info level with optional format arguments
-    template <typename... Args>
-    void Info(FormatString format, Args &&... args)
+    /// @brief Builds an OTLP/JSON LogRecord plan
+    /// @note App, module and process id are resource and scope data, so they go into the batch
+    /// envelope once instead of into every record
+    static FormatPlan buildOtlpPlan(const Config & config, const Context & context,
+                                    int processId)
     {
-        this->log(LogLevel::Info, format, std::forward<Args>(args)...);
+        const auto & fields = config.fields;
+        auto plan = FormatPlan();
+        plan.escaping = ValueEscaping::Json;
+        plan.fieldsInMessage = true;
+        plan.timestampStyle = TimestampStyle::EpochNanoseconds;
+
+        auto separator = std::string_view("{");
+        const auto key = [&plan, &separator](std::string_view name) {
+            plan.AppendLiteral(separator);
+            plan.AppendLiteral(name);
+            separator = ",";
+        };
+
+        if (fields.includeTime) {
+            key("\"timeUnixNano\":\"");
+            plan.AppendField(LogField::Time);
+            plan.AppendLiteral("\"");
+        }
+        if (fields.includeLogLevel) {
+            key("\"severityNumber\":");
+            plan.AppendField(LogField::SeverityNumber);
+            plan.AppendLiteral(",\"severityText\":\"");
+            plan.AppendField(LogField::SeverityText);
+            plan.AppendLiteral("\"");
+        }
+        if (fields.includeMessage) {
+            key("\"body\":{\"stringValue\":\"");
+            plan.AppendField(LogField::Message);
+            plan.AppendLiteral("\"}");
+        }
+        if (fields.includeThreadId || fields.includeFile || fields.includeSequence) {
+            key("\"attributes\":[");
+            auto attributeSeparator = std::string_view();
+            if (fields.includeThreadId) {
+                plan.AppendLiteral("{\"key\":\"thread.id\",\"value\":{\"intValue\":\"");
+                plan.AppendField(LogField::ThreadId);
+                plan.AppendLiteral("\"}}");
+                attributeSeparator = ",";
+            }
+            if (fields.includeSequence) {
+                plan.AppendLiteral(attributeSeparator);
+                plan.AppendLiteral("{\"key\":\"kvalog.seq\",\"value\":{\"intValue\":\"");
+                plan.AppendField(LogField::Sequence);
+                plan.AppendLiteral("\"}}");
+                attributeSeparator = ",";
+            }
+            if (fields.includeFile) {
+                plan.AppendLiteral(attributeSeparator);
+                plan.AppendLiteral("{\"key\":\"code.filepath\",\"value\":{\"stringValue\":\"");
+                plan.AppendField(LogField::SourcePath);
+                plan.AppendLiteral("\"}},{\"key\":\"code.lineno\",\"value\":{\"intValue\":\"");
+                plan.AppendField(LogField::SourceLine);
+                plan.AppendLiteral("\"}}");
+            }
+            plan.AppendLiteral("]");
+        }
+        plan.AppendLiteral(separator == "{" ? "{}" : "}");
+
+        auto resource = std::string();
+        const auto attribute = [&resource](std::string_view name, std::string_view value) {
+            resource.append(resource.empty() ? "" : ",");
+            resource.append("{\"key\":\"");
+            resource.append(name);
+            resource.append(value);
+            resource.append("}}");
+        };
+        if (fields.includeAppName && !context.appName.empty()) {
+            auto value = std::string("\",\"value\":{\"stringValue\":\"");
+            Logger::appendJsonEscaped(value, context.appName);
+            value.push_back('"');
+            attribute("service.name", value);
+        }
+        if (fields.includeProcessId) {
+            attribute("process.pid",
+                      "\",\"value\":{\"intValue\":\"" + std::to_string(processId) + "\"");
+        }
+
+        auto scope = std::string();
+        if (fields.includeModuleName && !context.moduleName.empty()) {
+            scope.append("\"name\":\"");
+            Logger::appendJsonEscaped(scope, context.moduleName);
+            scope.push_back('"');
+        }
+
+        plan.envelope.prefix = "{\"resourceLogs\":[{\"resource\":{\"attributes\":[" + resource +
+                               "]},\"scopeLogs\":[{\"scope\":{" + scope + "},\"logRecords\":[";
+        plan.envelope.separator = ",";
+        plan.envelope.suffix = "]}]}]}";
+        return plan;
     }
 
-    /// @brief Logs a message at Warning level with optional format arguments
+    /// @brief Builds an RFC 5424 syslog message plan:
+    /// "<PRI>1 TIMESTAMP HOSTNAME APP-NAME PROCID MSGID [SD] MSG"
+    /// @note The module is the MSGID; thread id, sequence and file go into the kvalog structured
+    /// data element. Missing header fields are written as the nil value "-".
+    static FormatPlan buildSyslogPlan(const Config & config, const Context & context,
+                                      int processId)
+    {
+        constexpr auto hostNameLimit = std::size_t(255);
+        constexpr auto appNameLimit = std::size_t(48);
+        constexpr auto processIdLimit = std::size_t(128);
+        constexpr auto messageIdLimit = std::size_t(32);
+
+        const auto & fields = config.fields;
+        auto plan = FormatPlan();
+        plan.escaping = ValueEscaping::StructuredData;
+        plan.fieldsInMessage = true;
+        plan.timestampStyle = TimestampStyle::UtcIso8601;
+        plan.facility = config.syslogFacility;
+
+        // Header fields are printable ASCII without spaces, bounded in length
+        const auto header = [&plan](std::string_view value, std::size_t limit) {
+            auto token = std::string(value.substr(0, limit));
+            for (auto & character : token) {
+                const auto code = static_cast<unsigned char>(character);
+                character = code > ' ' && code < 0x7F ? character : '_';
+            }
+            plan.AppendLiteral(" ");
+            plan.AppendLiteral(token.empty() ? std::string_view("-") : std::string_view(token));
+        };
+
+        plan.AppendLiteral("<");
+        plan.AppendField(LogField::SyslogPriority);
+        plan.AppendLiteral(">1 ");
+        if (fields.includeTime) {
+            plan.AppendField(LogField::Time);
+        } else {
+            plan.AppendLiteral("-");
+        }
+        header(context.hostName.empty() ? Logger::getHostName() : context.hostName,
+               hostNameLimit);
+        header(fields.includeAppName ? context.appName : std::string(), appNameLimit);
+        header(fields.includeProcessId ? std::to_string(processId) : std::string(), processIdLimit);
+        header(fields.includeModuleName ? context.moduleName : std::string(), messageIdLimit);
+
+        if (fields.includeThreadId || fields.includeFile || fields.includeSequence) {
+            plan.AppendLiteral(" [kvalog@32473");
+            if (fields.includeThreadId) {
+                plan.AppendLiteral(" tid=\"");
+                plan.AppendField(LogField::ThreadId);
+                plan.AppendLiteral("\"");
+            }
+            if (fields.includeSequence) {
+                plan.AppendLiteral(" seq=\"");
+                plan.AppendField(LogField::Sequence);
+                plan.AppendLiteral("\"");
+            }
+            if (fields.includeFile) {
+                plan.AppendLiteral(" file=\"");
+                plan.AppendField(LogField::File);
+                plan.AppendLiteral("\"");
+            }
+            plan.AppendLiteral("]");
+        } else {
+            plan.AppendLiteral(" -");
+        }
+
+        if (fields.includeMessage) {
+            plan.AppendLiteral(" ");
+            plan.AppendField(LogField::Message);
+        }
+        return plan;
+    }
+
+    /// @brief Builds a GELF 1.1 JSON message plan
+    /// @note short_message is required by GELF and always present; kvalog fields other than
+    /// the GELF ones are additional fields with a leading underscore
+    static FormatPlan buildGelfPlan(const Config & config, const Context & context,
+                                    int processId)
+    {
+        const auto & fields = config.fields;
+        auto plan = FormatPlan();
+        plan.escaping = ValueEscaping::Json;
+        plan.fieldsInMessage = true;
+
+        const auto constant = [&plan](std::string_view key, std::string_view value) {
+            auto quoted = std::string(",\"");
+            quoted.append(key);
+            quoted.append("\":\"");
+            Logger::appendJsonEscaped(quoted, value);
+            quoted.push_back('"');
+            plan.AppendLiteral(quoted);
+        };
+
+        plan.AppendLiteral("{\"version\":\"1.1\"");
+        constant("host", context.hostName.empty() ? Logger::getHostName() : context.hostName);
+        plan.AppendLiteral(",\"short_message\":\"");
+        if (fields.includeMessage) {
+            plan.AppendField(LogField::Message);
+        }
+        plan.AppendLiteral("\"");
+        if (fields.includeTime) {
+            plan.AppendLiteral(",\"timestamp\":");
+            plan.AppendField(LogField::UnixSeconds);
+        }
+        if (fields.includeLogLevel) {
+            plan.AppendLiteral(",\"level\":");
+            plan.AppendField(LogField::SyslogSeverity);
+        }
+        if (fields.includeAppName && !context.appName.empty()) {
+            constant("_app", context.appName);
+        }
+        if (fields.includeModuleName && !context.moduleName.empty()) {
+            constant("_module", context.moduleName);
+        }
+        if (fields.includeProcessId) {
+            plan.AppendLiteral(",\"_process_id\":" + std::to_string(processId));
+        }
+        if (fields.includeThreadId) {
+            plan.AppendLiteral(",\"_thread_id\":");
+            plan.AppendField(LogField::ThreadId);
+        }
+        if (fields.includeSequence) {
+            plan.AppendLiteral(",\"_seq\":");
+            plan.AppendField(LogField::Sequence);
+        }
+        if (fields.includeFile) {
+            plan.AppendLiteral(",\"_file\":\"");
+            plan.AppendField(LogField::SourcePath);
+            plan.AppendLiteral("\",\"_line\":");
+            plan.AppendField(LogField::SourceLine);
+        }
+        plan.AppendLiteral("}");
+        return plan;
+    }
+
+    /// @brief Builds a MessagePack map plan with the same keys, order and schema as JSON
+    /// @note Keys and constant values are encoded once, here; the map header counts the fields
+    static FormatPlan buildMessagePackPlan(const Config & config, const Context & context,
+                                           int processId)
+    {
+        const auto & fields = config.fields;
+        const auto & keys = config.keys;
+        const auto & schema = config.json;
+        auto plan = FormatPlan();
+        plan.escaping = ValueEscaping::MessagePack;
+        plan.timestampStyle = fields.timestampStyle;
+        plan.numericLevel = schema.numericLevel;
+        plan.numericIds = schema.numericIds;
+
+        auto entries = std::string();
+        auto count = std::size_t(0);
+        const auto key = [&plan, &entries, &count](std::string_view name) {
+            MessagePack::WriteString(entries, name);
+            plan.AppendLiteral(entries);
+            entries.clear();
+            ++count;
+        };
+        const auto constant = [&plan, &entries](std::string_view value) {
+            MessagePack::WriteString(entries, value);
+            plan.AppendLiteral(entries);
+            entries.clear();
+        };
+
+        if (fields.includeAppName && !context.appName.empty()) {
+            key(keys.appName);
+            constant(context.appName);
+        }
+        if (fields.includeFile) {
+            key(keys.file);
+            plan.AppendField(LogField::File);
+        }
+        if (fields.includeLogLevel) {
+            key(keys.level);
+            plan.AppendField(LogField::Level);
+        }
+        if (fields.includeMessage) {
+            key(keys.message);
+            plan.AppendField(LogField::Message);
+        }
+        if (fields.includeModuleName && !context.moduleName.empty()) {
+            key(keys.moduleName);
+            constant(context.moduleName);
+        }
+        if (fields.includeProcessId) {
+            key(keys.processId);
+            if (schema.numericIds) {
+                MessagePack::WriteInteger(entries, processId);
+                plan.AppendLiteral(entries);
+                entries.clear();
+            } else {
+                constant(std::to_string(processId));
+            }
+        }
+        if (fields.includeSequence) {
+            key(keys.sequence);
+            plan.AppendField(LogField::Sequence);
+        }
+        if (fields.includeThreadId) {
+            key(keys.threadId);
+            plan.AppendField(LogField::ThreadId);
+        }
+        if (fields.includeTime) {
+            key(keys.time);
+            plan.AppendField(LogField::Time);
+        }
+
+        plan.AppendField(LogField::Fields);
+
+        // The header goes in front of everything appended so far, records with fields enlarge it
+        auto header = std::string();
+        MessagePack::WriteMapHeader(header, count);
+        auto & front = plan.steps.empty() ? plan.suffix : plan.steps.front().literal;
+        front.insert(0, header);
+        return plan;
+    }
+
+    /// @brief Builds a logfmt line plan: space-separated key=value pairs
+    static FormatPlan buildLogfmtPlan(const Config & config, const Context & context,
+                                      int processId)
+    {
+        const auto & fields = config.fields;
+        const auto & keys = config.keys;
+        auto plan = FormatPlan();
+        plan.escaping = ValueEscaping::Logfmt;
+        plan.timestampStyle = fields.timestampStyle;
+
+        auto separator = std::string_view();
+        const auto key = [&plan, &separator](std::string_view name) {
+            plan.AppendLiteral(separator);
+            plan.AppendLiteral(name);
+            plan.AppendLiteral("=");
+            separator = " ";
+        };
+        const auto constant = [&plan](std::string_view value) {
+            auto encoded = std::string();
+            Logger::appendLogfmtValue(encoded, value);
+            plan.AppendLiteral(encoded);
+        };
+
+        if (fields.includeTime) {
+            key(keys.time);
+            // Local time contains a space, every other style is a bare token
+            if (fields.timestampStyle == TimestampStyle::Local) {
+                plan.AppendLiteral("\"");
+                plan.AppendField(LogField::Time);
+                plan.AppendLiteral("\"");
+            } else {
+                plan.AppendField(LogField::Time);
+            }
+        }
+        if (fields.includeLogLevel) {
+            key(keys.level);
+            plan.AppendField(LogField::Level);
+        }
+        if (fields.includeAppName && !context.appName.empty()) {
+            key(keys.appName);
+            constant(context.appName);
+        }
+        if (fields.includeModuleName && !context.moduleName.empty()) {
+            key(keys.moduleName);
+            constant(context.moduleName);
+        }
+        if (fields.includeProcessId) {
+            key(keys.processId);
+            plan.AppendLiteral(std::to_string(processId));
+        }
+        if (fields.includeThreadId) {
+            key(keys.threadId);
+            plan.AppendField(LogField::ThreadId);
+        }
+        if (fields.includeSequence) {
+            key(keys.sequence);
+            plan.AppendField(LogField::Sequence);
+        }
+        if (fields.includeFile) {
+            key(keys.file);
+            plan.AppendField(LogField::File);
+        }
+        if (fields.includeMessage) {
+            key(keys.message);
+            plan.AppendField(LogField::Message);
+        }
+        plan.AppendField(LogField::Fields);
+
+        return plan;
+    }
+
+    /// @brief Builds a bracketed terminal line plan
+    static FormatPlan buildTerminalPlan(const Config & config, const Context & context,
+                                        int processId)
+    {
+        if (config.terminalPattern) {
+            return Logger::buildPatternPlan(config, context, processId);
+        }
+
+        const auto & fields = config.fields;
+        auto plan = FormatPlan();
+        plan.colored = config.enableColors && config.logToConsole;
+        plan.timestampStyle = fields.timestampStyle;
+
+        const auto section = [&plan](std::string_view content) {
+            plan.AppendLiteral("[");
+            plan.AppendLiteral(content);
+            plan.AppendLiteral("]");
+        };
+        const auto field = [&plan](std::string_view prefix, LogField value) {
+            plan.AppendLiteral("[");
+            plan.AppendLiteral(prefix);
+            plan.AppendField(value);
+            plan.AppendLiteral("]");
+        };
+
+        if (plan.colored) {
+            plan.AppendLiteral(AnsiColor::WarmTint);
+        }
+
+        if (fields.includeTime) {
+            field("", LogField::Time);
+        }
+        if (fields.includeAppName && !context.appName.empty()) {
+            section(context.appName);
+        }
+        if (fields.includeModuleName && !context.moduleName.empty()) {
+            section(context.moduleName);
+        }
+        if (fields.includeProcessId) {
+            section("PID:" + std::to_string(processId));
+        }
+        if (fields.includeThreadId) {
+            field("TID:", LogField::ThreadId);
+        }
+        if (fields.includeSequence) {
+            field("SEQ:", LogField::Sequence);
+        }
+        if (fields.includeLogLevel) {
+            field("", LogField::Level);
+        }
+        if (fields.includeFile) {
+            field("", LogField::File);
+        }
+        if (fields.includeMessage) {
+            plan.AppendLiteral(" ");
+            plan.AppendField(LogField::Message);
+        }
+        plan.AppendField(LogField::Fields);
+
+        if (plan.colored) {
+            plan.AppendLiteral(AnsiColor::Reset);
+        }
+
+        return plan;
+    }
+
+    /// @brief Builds a terminal plan from the configured pattern, skipping disabled fields
+    static FormatPlan buildPatternPlan(const Config & config, const Context & context,
+                                       int processId)
+    {
+        const auto & fields = config.fields;
+        const auto & pattern = *config.terminalPattern;
+        auto plan = FormatPlan();
+        plan.colored = config.enableColors && config.logToConsole;
+        plan.timestampStyle = fields.timestampStyle;
+
+        const auto constant = [&plan](std::string_view value, const PatternOp & op) {
+            auto padded = std::string(value);
+            Logger::applyPadding(padded, 0, op.width, op.fill, op.align);
+            plan.AppendLiteral(padded);
+        };
+        const auto field = [&plan](LogField value, const PatternOp & op) {
+            plan.AppendField(value, op.width, op.fill, op.align);
+        };
+
+        if (plan.colored) {
+            plan.AppendLiteral(AnsiColor::WarmTint);
+        }
+
+        for (const auto & op : pattern.Ops()) {
+            switch (op.field) {
+                case PatternField::Literal:
+                    plan.AppendLiteral(pattern.LiteralOf(op));
+                    break;
+                case PatternField::Time:
+                    if (fields.includeTime) {
+                        field(LogField::Time, op);
+                    }
+                    break;
+                case PatternField::AppName:
+                    if (fields.includeAppName) {
+                        constant(context.appName, op);
+                    }
+                    break;
+                case PatternField::ModuleName:
+                    if (fields.includeModuleName) {
+                        constant(context.moduleName, op);
+                    }
+                    break;
+                case PatternField::ProcessId:
+                    if (fields.includeProcessId) {
+                        constant(std::to_string(processId), op);
+                    }
+                    break;
+                case PatternField::ThreadId:
+                    if (fields.includeThreadId) {
+                        field(LogField::ThreadId, op);
+                    }
+                    break;
+                case PatternField::Sequence:
+                    if (fields.includeSequence) {
+                        field(LogField::Sequence, op);
+                    }
+                    break;
+                case PatternField::Level:
+                    if (fields.includeLogLevel) {
+                        field(LogField::Level, op);
+                    }
+                    break;
+                case PatternField::File:
+                    if (fields.includeFile) {
+                        field(LogField::File, op);
+                    }
+                    break;
+                case PatternField::Message:
+                    if (fields.includeMessage) {
+                        field(LogField::Message, op);
+                    }
+                    break;
+            }
+        }
+        plan.AppendField(LogField::Fields);
+
+        if (plan.colored) {
+            plan.AppendLiteral(AnsiColor::Reset);
+        }
+
+        return plan;
+    }
+
+    /// [Logging Implementation]
+
+    /// @brief Formats and dispatches a log message at the given level
     template <typename... Args>
-    void Warning(FormatString format, Args &&... args)
+    void log(LogLevel level, FormatString format, Args &&... args)
     {
-        this->log(LogLevel::Warning, format, std::forward<Args>(args)...);
+        // Lazy arguments are evaluated while formatting, so only for records that pass
+        if (!this->IsEnabled(level)) {
+            return;
+        }
+
+        // The payload owns a lease on the snapshot, the record sink releases it
+        auto lease = this->snapshots->Acquire();
+        const auto & snapshot = *lease;
+
+        auto header = RecordHeader{ .snapshot = &snapshot,
+                                    .reference = lease.GetReference(),
+                                    .level = level,
+                                    .threadId = Logger::getThreadId(),
+                                    .location = format.location };
+        if (snapshot.config.fields.includeSequence) {
+            header.sequence = this->sequence->fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+        Logger::captureTimestamp(snapshot.config.clock, header);
+
+        // The payload is the header followed by the message, formatted in place
+        auto payload = fmt::memory_buffer();
+        payload.append(reinterpret_cast<const char *>(&header),
+                       reinterpret_cast<const char *>(&header) + sizeof(RecordHeader));
+        // Structured fields follow the format arguments and are not part of the message
+        constexpr auto fieldCount =
+            (std::size_t(FieldValue::IsKeyValue<std::remove_cvref_t<Args>>) + ... + 0);
+        static_assert(Logger::fieldsFollowArguments<Args...>(),
+                      "kvalog: kv() fields must come after the format arguments");
+        const auto maxMessage = snapshot.config.messageLimits.maxMessageBytes;
+        if constexpr (sizeof...(Args) > fieldCount) {
+            Logger::formatMessage(payload, format.value, maxMessage,
+                                  std::forward_as_tuple(std::forward<Args>(args)...),
+                                  std::make_index_sequence<sizeof...(Args) - fieldCount>());
+        } else {
+            const auto text = std::string_view(format.value);
+            if (maxMessage == 0 || text.size() <= maxMessage) {
+                Logger::appendText(payload, text);
+            } else {
+                Logger::appendText(payload, text.substr(0, maxMessage));
+                Logger::markTruncated(payload, sizeof(RecordHeader), text.size());
+            }
+        }
+
+        // Fields follow the message, the header written first learns their size afterwards
+        if constexpr (fieldCount > 0) {
+            const auto fieldsStart = payload.size();
+            MessagePack::WriteMapHeader(payload, fieldCount);
+            (Logger::encodeField(payload, args), ...);
+            header.fieldBytes = static_cast<std::uint32_t>(payload.size() - fieldsStart);
+            std::memcpy(payload.data(), &header, sizeof(RecordHeader));
+        }
+
+        lease.Detach();
+        this->logger->log(spdlog::log_clock::time_point(), spdlog::source_loc(),
+                          Logger::toSpdlogLevel(level),
+                          spdlog::string_view_t(payload.data(), payload.size()));
     }
 
-    /// @brief Logs a message at Error level with optional format arguments
+    /// @brief Returns whether no format argument follows a structured field
     template <typename... Args>
-    void Error(FormatString format, Args &&... args)
+    static constexpr bool fieldsFollowArguments()
     {
-        this->log(LogLevel::Error, format, std::forward<Args>(args)...);
+        if constexpr (sizeof...(Args) == 0) {
+            return true;
+        } else {
+            auto field = false;
+            auto ordered = true;
+            ((ordered = ordered && (field <= FieldValue::IsKeyValue<std::remove_cvref_t<Args>>),
+              field = FieldValue::IsKeyValue<std::remove_cvref_t<Args>>),
+             ...);
+            return ordered;
+        }
+    }
+
+    /// @brief Formats the message from the leading format arguments, keeping at most maxMessage
+    /// bytes of it when set
+    template <typename Arguments, std::size_t... Index>
+    static void formatMessage(fmt::memory_buffer & payload, std::string_view format,
+                              std::size_t maxMessage, Arguments && arguments,
+                              std::index_sequence<Index...>)
+    {
+        if (maxMessage == 0) {
+            fmt::format_to(std::back_inserter(payload), fmt::runtime(format),
+                           Logger::messageArgument(std::get<Index>(std::move(arguments)))...);
+            return;
+        }
+
+        // Output past the limit is counted, never stored
+        const auto result = fmt::format_to_n(
+            std::back_inserter(payload), maxMessage, fmt::runtime(format),
+            Logger::messageArgument(std::get<Index>(std::move(arguments)))...);
+        if (result.size > maxMessage) {
+            Logger::markTruncated(payload, sizeof(RecordHeader), result.size);
+        }
+    }
+
+    /// @brief Passes a format argument through, lazy arguments as the result of their callable
+    template <typename Arg>
+    static decltype(auto) messageArgument(Arg && argument)
+    {
+        if constexpr (FieldValue::IsLazy<std::remove_cvref_t<Arg>>) {
+            return argument.callable();
+        } else {
+            return std::forward<Arg>(argument);
+        }
     }
 
-    /// @brief Logs a message at Critical level with optional format arguments
-    template <typename... Args>
-    void Critical(FormatString format, Args &&... args)
+    /// @brief Appends the key and the value of a structured field, other arguments are skipped
+    template <typename Arg>
+    static void encodeField(fmt::memory_buffer & payload, const Arg & argument)
     {
-        this->log(LogLevel::Critical, format, std::forward<Args>(args)...);
+        if constexpr (FieldValue::IsKeyValue<Arg>) {
+            MessagePack::WriteString(payload, argument.key);
+            FieldValue::Encode(payload, argument.value);
+        }
     }
 
-    /// [Level Management]
-
-    /// @brief Sets minimum log level
-    void SetLevel(LogLevel level)
+    /// @brief Releases the snapshot lease of a record payload dropped before formatting
+    static void discardRecord(std::string_view payload)
     {
-        if (this->logger) {
-            this->level = level;
-            this->logger->set_level(Logger::toSpdlogLevel(level));
-        }
+        auto header = RecordHeader();
+        std::memcpy(&header, payload.data(), sizeof(RecordHeader));
+        SnapshotStore<Snapshot>::Release(header.reference);
     }
 
-    /// @brief Flushes all pending log messages
-    void Flush()
+    /// @brief Reads the configured clock into the record header
+    static void captureTimestamp(ClockSource clock, RecordHeader & header)
     {
-        if (this->logger) {
-            this->logger->flush();
+        if (clock == ClockSource::Tsc) {
+            if (TscClock::IsInvariant()) {
+                header.timestamp = TscClock::ReadTicks();
+                header.timestampKind = TimestampKind::TscTicks;
+            } else {
+                header.timestamp = static_cast<std::uint64_t>(TscClock::ReadCoarseNanoseconds());
+            }
+            return;
         }
+
+        header.timestamp = static_cast<std::uint64_t>(TscClock::ReadRealtimeNanoseconds());
     }
 
-    /// [Construction & Destruction]
+    /// [Formatting]
 
-#pragma region Logger::Construct
+    /// @brief Writes the message of a binary record body: the label, the sizes and the kept
+    /// bytes as a hex dump on the lines below in the terminal format, else in the configured
+    /// encoding on the same line
+    static void encodeBinary(const Config & config, std::string_view body,
+                             fmt::memory_buffer & output)
+    {
+        auto prefix = BinaryPrefix();
+        std::memcpy(&prefix, body.data(), sizeof(BinaryPrefix));
+        const auto label = body.substr(sizeof(BinaryPrefix), prefix.labelBytes);
+        const auto bytes = body.substr(sizeof(BinaryPrefix) + prefix.labelBytes);
 
-    /// @brief Copy constructor is deleted
-    Logger(const Logger &) = delete;
-    /// @brief Copy operator is deleted
-    Logger & operator=(const Logger &) = delete;
+        Logger::appendText(output, label);
+        if (bytes.size() < prefix.totalBytes) {
+            fmt::format_to(std::back_inserter(output), " [{} bytes, first {}]",
+                           prefix.totalBytes, bytes.size());
+        } else {
+            fmt::format_to(std::back_inserter(output), " [{} bytes]", prefix.totalBytes);
+        }
+        if (bytes.empty()) {
+            return;
+        }
 
-    /// @brief Move constructor
-    Logger(Logger &&) = default;
-    /// @brief Move assignment operator
-    Logger & operator=(Logger &&) = default;
+        if (config.format == OutputFormat::Terminal) {
+            output.push_back('\n');
+            BinaryText::AppendHexDump(output, bytes);
+        } else if (config.binaryEncoding == BinaryEncoding::Base64) {
+            output.push_back(' ');
+            BinaryText::AppendBase64(output, bytes);
+        } else {
+            output.push_back(' ');
+            BinaryText::AppendHex(output, bytes);
+        }
+    }
 
-    /// @brief Constructor with configuration
-    /// @warning Avoid using this constructor since class has static fabric methods
-    explicit Logger(const Config & initialConfig)
-        : config(initialConfig), processId(Logger::getProcessId())
+    /// @brief Writes a record into the output buffer by walking the format plan
+    static void formatRecord(const FormatPlan & plan, const LogRecord & record,
+                             fmt::memory_buffer & output)
     {
-        this->initializeLogger();
+        Logger::formatRecord(plan, record, output, &Logger::appendMessage);
     }
 
-    /// @brief Constructor with configuration and context
-    /// @warning Avoid using this constructor since class has static fabric methods
-    explicit Logger(const Config & initialConfig, const Context & initialContext)
-        : config(initialConfig), context(initialContext), processId(Logger::getProcessId())
+    /// @brief Writes a record into the output buffer, the message through the given writer
+    /// @param writeMessage Called with the buffer, the message and its escaping
+    template <typename MessageWriter>
+    static void formatRecord(const FormatPlan & plan, const LogRecord & record,
+                             fmt::memory_buffer & output, MessageWriter && writeMessage)
     {
-        this->initializeLogger();
-    }
+        // Formats without a place for fields carry them at the end of the message
+        auto message = record.message;
+        auto withFields = fmt::memory_buffer();
+        if (plan.fieldsInMessage && !record.fields.empty()) {
+            Logger::appendText(withFields, record.message);
+            Logger::appendFields(withFields, record.fields, ValueEscaping::None, true);
+            message = std::string_view(withFields.data(), withFields.size());
+        }
 
-    /// @brief Destructor
-    ~Logger() = default;
+        for (const auto & step : plan.steps) {
+            if (plan.escaping == ValueEscaping::MessagePack) {
+                if (&step == plan.steps.data() && !record.fields.empty()) {
+                    Logger::appendMessagePackHead(output, step.literal, record.fields);
+                } else {
+                    Logger::appendText(output, step.literal);
+                }
+                if (step.field == LogField::Message) {
+                    writeMessage(output, message, ValueEscaping::MessagePack);
+                    continue;
+                }
+                Logger::appendMessagePackField(output, plan, step.field, record);
+                continue;
+            }
+            Logger::appendText(output, step.literal);
+            const auto start = output.size();
 
-#pragma endregion
+            switch (step.field) {
+                case LogField::Time:
+                    Logger::appendTimestamp(output, record.timestamp, plan.timestampStyle);
+                    break;
+                case LogField::ThreadId:
+                    fmt::format_to(std::back_inserter(output), "{}", record.threadId);
+                    break;
+                case LogField::Sequence:
+                    fmt::format_to(std::back_inserter(output), "{}", record.sequence);
+                    break;
+                case LogField::Level:
+                    if (plan.numericLevel) {
+                        fmt::format_to(std::back_inserter(output), "{}",
+                                       static_cast<int>(record.level));
+                        break;
+                    }
+                    Logger::appendLevel(output, record.level, plan.colored, step);
+                    continue;
+                case LogField::File:
+                    Logger::appendFileLine(output, record.location, plan.escaping);
+                    break;
+                case LogField::Message:
+                    // Structured data escaping is for parameters, the syslog message is free-form
+                    writeMessage(output, message,
+                                 plan.escaping == ValueEscaping::StructuredData
+                                     ? ValueEscaping::None
+                                     : plan.escaping);
+                    // A streamed message has left the buffer already, there is nothing to pad
+                    if (output.size() < start) {
+                        continue;
+                    }
+                    break;
+                case LogField::SourcePath:
+                    Logger::appendValue(output, record.location.file_name(), plan.escaping);
+                    break;
+                case LogField::SourceLine:
+                    fmt::format_to(std::back_inserter(output), "{}", record.location.line());
+                    break;
+                case LogField::SeverityNumber:
+                    fmt::format_to(std::back_inserter(output), "{}",
+                                   Logger::levelToSeverityNumber(record.level));
+                    break;
+                case LogField::SeverityText:
+                    Logger::appendText(output, Logger::levelToSeverityText(record.level));
+                    break;
+                case LogField::SyslogPriority:
+                    fmt::format_to(std::back_inserter(output), "{}",
+                                   static_cast<int>(plan.facility) * 8 +
+                                       Logger::levelToSyslogSeverity(record.level));
+                    break;
+                case LogField::SyslogSeverity:
+                    fmt::format_to(std::back_inserter(output), "{}",
+                                   Logger::levelToSyslogSeverity(record.level));
+                    break;
+                case LogField::UnixSeconds:
+                    Logger::appendUnixSeconds(output, record.timestamp);
+                    break;
+                case LogField::Fields:
+                    // Only an object without other members has no comma in front of them
+                    Logger::appendFields(output, record.fields, plan.escaping,
+                                         !step.literal.ends_with('{'));
+                    continue;
+            }
 
-private:
-#pragma region Logger::PrivateMethods
+            Logger::applyPadding(output, start, step.width, step.fill, step.align);
+        }
 
-    /// [Initialization]
+        Logger::appendText(output, plan.suffix);
+    }
 
-    /// @brief Initializes the spdlog logger with configured sinks
-    void initializeLogger()
+    /// @brief Writes a record that fits maxRecordBytes: the message is cut to the room the rest
+    /// of the record leaves, and fields that alone exceed the limit are dropped
+    /// @return False, with nothing written, when the record does not fit even without them
+    static bool formatLimitedRecord(const FormatPlan & plan, const LogRecord & record,
+                                    const MessageLimits & limits, fmt::memory_buffer & output)
     {
-        auto sinks = std::vector<spdlog::sink_ptr>();
+        const auto start = output.size();
+        const auto limit = limits.maxRecordBytes;
+        if (limit == 0) {
+            Logger::formatRecord(plan, record, output);
+            return true;
+        }
 
-        if (this->config.logToConsole) {
-            auto consoleSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-            consoleSink->set_pattern("%v");
-            sinks.push_back(consoleSink);
+        // Escaping never shrinks text, so a message longer than the limit is not written at all;
+        // either way the pass yields the size of the record without its message
+        auto messageBytes = std::size_t(0);
+        auto overflow = false;
+        const auto measure = [limit, &messageBytes, &overflow](fmt::memory_buffer & buffer,
+                                                               std::string_view message,
+                                                               ValueEscaping escaping) {
+            if (message.size() > limit) {
+                overflow = true;
+                return;
+            }
+            const auto begin = buffer.size();
+            Logger::appendMessage(buffer, message, escaping);
+            messageBytes = buffer.size() - begin;
+        };
+        Logger::formatRecord(plan, record, output, measure);
+        if (!overflow && output.size() - start <= limit) {
+            return true;
         }
 
-        if (this->config.logFilePath) {
-            auto fileSink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(
-                *this->config.logFilePath, true);
-            fileSink->set_pattern("%v");
-            sinks.push_back(fileSink);
+        auto cut = record;
+        auto fixed = output.size() - start - messageBytes;
+        output.resize(start);
+        if (fixed > limit && !cut.fields.empty()) {
+            cut.fields = {};
+            Logger::formatRecord(plan, cut, output, measure);
+            fixed = output.size() - start - messageBytes;
+            output.resize(start);
+        }
+        // Cutting the record itself would break its format, it is dropped instead
+        if (fixed > limit) {
+            return false;
         }
 
-        if (this->config.networkAdapter) {
-            auto networkSink = std::make_shared<NetworkSink>(this->config.networkAdapter);
-            networkSink->set_pattern("%v");
-            sinks.push_back(networkSink);
+        const auto room = limit - fixed;
+        Logger::formatRecord(plan, cut, output,
+                             [room](fmt::memory_buffer & buffer, std::string_view message,
+                                    ValueEscaping escaping) {
+                                 Logger::appendLimitedMessage(buffer, message, escaping, room);
+                             });
+        // An empty message may still need a byte or two of framing the room lacks
+        if (output.size() - start > limit) {
+            output.resize(start);
+            return false;
         }
+        return true;
+    }
 
-        if (this->config.asyncMode == Mode::Async) {
-            spdlog::init_thread_pool(this->config.asyncQueueSize, this->config.asyncThreadCount);
-            this->logger = std::make_shared<spdlog::async_logger>(
-                "async_logger", sinks.begin(), sinks.end(), spdlog::thread_pool(),
-                spdlog::async_overflow_policy::block);
-        } else {
-            this->logger =
-                std::make_shared<spdlog::logger>("sync_logger", sinks.begin(), sinks.end());
+    /// @brief Appends a message with the escaping of its format in at most room bytes, cut
+    /// with the truncation marker when it does not fit
+    /// @note Only about room bytes of the message are escaped, however long it is
+    static void appendLimitedMessage(fmt::memory_buffer & output, std::string_view message,
+                                     ValueEscaping escaping, std::size_t room)
+    {
+        const auto begin = output.size();
+        if (message.size() <= room) {
+            Logger::appendMessage(output, message, escaping);
+            if (output.size() - begin <= room) {
+                return;
+            }
         }
 
-        this->level = LogLevel::Trace;
-        this->logger->set_level(spdlog::level::trace);
+        // The escaped size shrinks about in proportion to the kept bytes; one byte less at least
+        auto text = fmt::memory_buffer();
+        auto kept = std::min(message.size(), room);
+        while (true) {
+            text.clear();
+            Logger::appendText(text, message.substr(0, kept));
+            Logger::markTruncated(text, 0, message.size());
+            output.resize(begin);
+            Logger::appendMessage(output, std::string_view(text.data(), text.size()), escaping);
+            const auto written = output.size() - begin;
+            if (written <= room) {
+                return;
+            }
+            // Not even the marker fits, an empty message keeps the record well formed
+            if (kept == 0) {
+                output.resize(begin);
+                Logger::appendMessage(output, std::string_view(), escaping);
+                return;
+            }
+            kept = std::min(kept - 1, kept * room / written);
+        }
     }
 
-    /// [Logging Implementation]
+    /// @brief Writes a record in pieces of about chunkBytes, escaping its message slice by
+    /// slice so that neither the record nor its escaped message is ever held whole
+    /// @param emit Called with every piece in order
+    template <typename Emit>
+    static void streamRecord(const FormatPlan & plan, const LogRecord & record,
+                             std::size_t chunkBytes, Emit && emit)
+    {
+        auto output = fmt::memory_buffer();
+        const auto writeMessage = [chunkBytes, &emit](fmt::memory_buffer & buffer,
+                                                      std::string_view message,
+                                                      ValueEscaping escaping) {
+            const auto quoted =
+                escaping == ValueEscaping::Logfmt && Logger::logfmtNeedsQuotes(message);
+            if (escaping == ValueEscaping::MessagePack) {
+                MessagePack::WriteStringHeader(buffer, message.size());
+            } else if (quoted) {
+                buffer.push_back('"');
+            }
 
-    /// @brief Formats and dispatches a log message at the given level
-    template <typename... Args>
-    void log(LogLevel level, FormatString format, Args &&... args)
+            for (auto offset = std::size_t(0); offset < message.size(); offset += chunkBytes) {
+                const auto slice = message.substr(offset, chunkBytes);
+                if (quoted) {
+                    Logger::appendLogfmtEscaped(buffer, slice);
+                } else if (escaping == ValueEscaping::Json ||
+                           escaping == ValueEscaping::StructuredData) {
+                    Logger::appendValue(buffer, slice, escaping);
+                } else {
+                    Logger::appendText(buffer, slice);
+                }
+                if (buffer.size() >= chunkBytes) {
+                    emit(std::string_view(buffer.data(), buffer.size()));
+                    buffer.clear();
+                }
+            }
+
+            if (quoted) {
+                buffer.push_back('"');
+            }
+        };
+
+        Logger::formatRecord(plan, record, output, writeMessage);
+        emit(std::string_view(output.data(), output.size()));
+    }
+
+    /// @brief Appends a message with the escaping of its format
+    static void appendMessage(fmt::memory_buffer & output, std::string_view message,
+                              ValueEscaping escaping)
     {
-        if (static_cast<int>(this->level) > static_cast<int>(level)) {
+        if (escaping == ValueEscaping::MessagePack) {
+            MessagePack::WriteString(output, message);
             return;
         }
+        Logger::appendValue(output, message, escaping);
+    }
 
-        if (!this->logger) {
-            return;
-        }
+    /// @brief Drops a UTF-8 sequence cut off at the end of a message and appends the
+    /// truncation marker
+    /// @param fullSize Size of the whole message, of which the buffer holds the start
+    static void markTruncated(fmt::memory_buffer & buffer, std::size_t messageStart,
+                              std::size_t fullSize)
+    {
+        constexpr auto continuationMask = 0xC0U;
+        constexpr auto continuationBits = 0x80U;
+        constexpr auto maxContinuations = std::size_t(3);
 
-        auto message = std::string();
-        if constexpr (sizeof...(Args) > 0) {
-            message = fmt::format(fmt::runtime(format.value), std::forward<Args>(args)...);
-        } else {
-            message = std::string(format.value);
+        auto end = buffer.size();
+        auto lead = end;
+        while (lead > messageStart && end - lead < maxContinuations &&
+               (static_cast<unsigned char>(buffer[lead - 1]) & continuationMask) ==
+                   continuationBits) {
+            lead -= 1;
+        }
+        if (lead > messageStart) {
+            const auto byte = static_cast<unsigned char>(buffer[lead - 1]);
+            const auto length = byte >= 0xF0 ? 4U : byte >= 0xE0 ? 3U : byte >= 0xC0 ? 2U : 1U;
+            if (lead - 1 + length > end) {
+                end = lead - 1;
+            }
         }
 
-        auto formattedOutput = std::string();
+        buffer.resize(end);
+        fmt::format_to(std::back_inserter(buffer), fmt::runtime(TruncationMarker),
+                       fullSize - (end - messageStart));
+    }
 
-        if (this->config.format == OutputFormat::Json) {
-            formattedOutput = this->formatJson(level, message, format.location);
-        } else {
-            formattedOutput = this->formatTerminal(level, message, format.location);
+    /// @brief Appends a per-record field as a MessagePack value
+    /// @note Strings carry a length prefix, so text fields are rendered to scratch space first
+    static void appendMessagePackField(fmt::memory_buffer & output, const FormatPlan & plan,
+                                       LogField field, const LogRecord & record)
+    {
+        auto scratch = fmt::memory_buffer();
+        switch (field) {
+            case LogField::Time:
+                if (IsNumericTimestamp(plan.timestampStyle)) {
+                    MessagePack::WriteInteger(
+                        output, Logger::epochTimestamp(record.timestamp, plan.timestampStyle));
+                    return;
+                }
+                Logger::appendCalendarTime(scratch, record.timestamp, plan.timestampStyle);
+                break;
+            case LogField::ThreadId:
+                if (plan.numericIds) {
+                    MessagePack::WriteInteger(output, record.threadId);
+                    return;
+                }
+                fmt::format_to(std::back_inserter(scratch), "{}", record.threadId);
+                break;
+            case LogField::Sequence:
+                MessagePack::WriteInteger(output, static_cast<std::int64_t>(record.sequence));
+                return;
+            case LogField::Level:
+                if (plan.numericLevel) {
+                    MessagePack::WriteInteger(output, static_cast<int>(record.level));
+                    return;
+                }
+                MessagePack::WriteString(output, Logger::levelToString(record.level));
+                return;
+            case LogField::File:
+                Logger::appendFileLine(scratch, record.location, ValueEscaping::None);
+                break;
+            case LogField::Message:
+                MessagePack::WriteString(output, record.message);
+                return;
+            case LogField::SourcePath:
+                MessagePack::WriteString(output, record.location.file_name());
+                return;
+            case LogField::SourceLine:
+                MessagePack::WriteInteger(output, record.location.line());
+                return;
+            case LogField::SeverityNumber:
+                MessagePack::WriteInteger(output, Logger::levelToSeverityNumber(record.level));
+                return;
+            case LogField::SeverityText:
+                MessagePack::WriteString(output, Logger::levelToSeverityText(record.level));
+                return;
+            case LogField::SyslogPriority:
+                MessagePack::WriteInteger(output, static_cast<int>(plan.facility) * 8 +
+                                                      Logger::levelToSyslogSeverity(record.level));
+                return;
+            case LogField::SyslogSeverity:
+                MessagePack::WriteInteger(output, Logger::levelToSyslogSeverity(record.level));
+                return;
+            case LogField::UnixSeconds:
+                Logger::appendUnixSeconds(scratch, record.timestamp);
+                break;
+            case LogField::Fields:
+                // The pairs are copied behind the enlarged record map header as they are
+                if (!record.fields.empty()) {
+                    auto pairs = record.fields;
+                    MessagePack::ReadValue(pairs);
+                    Logger::appendText(output, pairs);
+                }
+                return;
         }
 
-        this->logger->log(Logger::toSpdlogLevel(level), formattedOutput);
+        MessagePack::WriteString(output, std::string_view(scratch.data(), scratch.size()));
     }
 
-    /// [Formatting]
-
-    /// @brief Formats a log entry as a JSON string
-    std::string formatJson(LogLevel level, const std::string & message,
-                           const std::source_location & location)
+    /// @brief Appends the first literal of a MessagePack plan, its record map header counting
+    /// the structured fields too
+    static void appendMessagePackHead(fmt::memory_buffer & output, std::string_view literal,
+                                      std::string_view fields)
     {
-        auto logEntry = nlohmann::json();
+        const auto added = MessagePack::ReadValue(fields).count;
+        const auto planned = MessagePack::ReadValue(literal).count;
+        MessagePack::WriteMapHeader(output, planned + added);
+        Logger::appendText(output, literal);
+    }
 
-        if (this->config.fields.includeTime) {
-            logEntry["time"] = Logger::getCurrentTimeString();
+    /// @brief Appends structured fields after the other fields of a text record: JSON members,
+    /// or key=value pairs with JSON values in logfmt and terminal records
+    /// @param separated Whether the first JSON member needs a comma in front of it
+    static void appendFields(fmt::memory_buffer & output, std::string_view fields,
+                             ValueEscaping escaping, bool separated)
+    {
+        if (fields.empty()) {
+            return;
         }
-        if (this->config.fields.includeAppName) {
-            if (!this->context.appName.empty()) {
-                logEntry["app"] = this->context.appName;
+
+        const auto count = MessagePack::ReadValue(fields).count;
+        auto value = fmt::memory_buffer();
+        for (auto index = std::size_t(0); index < count; ++index) {
+            const auto key = MessagePack::ReadValue(fields).text;
+            if (escaping == ValueEscaping::Json) {
+                if (index > 0 || separated) {
+                    output.push_back(',');
+                }
+                output.push_back('"');
+                Logger::appendJsonEscaped(output, key);
+                Logger::appendText(output, std::string_view("\":"));
+                Logger::appendJsonValue(output, fields);
+                continue;
+            }
+
+            output.push_back(' ');
+            Logger::appendText(output, key);
+            output.push_back('=');
+            auto next = fields;
+            const auto head = MessagePack::ReadValue(next);
+            if (escaping == ValueEscaping::Logfmt && head.type == MessagePack::ValueType::String) {
+                // Strings are logfmt values themselves, only containers go through JSON
+                Logger::appendLogfmtValue(output, head.text);
+                fields = next;
+            } else if (escaping == ValueEscaping::Logfmt) {
+                value.clear();
+                Logger::appendJsonValue(value, fields);
+                Logger::appendLogfmtValue(output, std::string_view(value.data(), value.size()));
+            } else {
+                Logger::appendJsonValue(output, fields);
             }
         }
-        if (this->config.fields.includeProcessId) {
-            logEntry["process_id"] = std::to_string(this->processId);
+    }
+
+    /// @brief Transcodes the MessagePack value at the front of input to JSON and consumes it
+    static void appendJsonValue(fmt::memory_buffer & output, std::string_view & input)
+    {
+        const auto value = MessagePack::ReadValue(input);
+        switch (value.type) {
+            case MessagePack::ValueType::Nil:
+                Logger::appendText(output, std::string_view("null"));
+                break;
+            case MessagePack::ValueType::Boolean:
+                Logger::appendText(output, std::string_view(value.boolean ? "true" : "false"));
+                break;
+            case MessagePack::ValueType::Integer:
+                fmt::format_to(std::back_inserter(output), "{}", value.integer);
+                break;
+            case MessagePack::ValueType::Unsigned:
+                fmt::format_to(std::back_inserter(output), "{}", value.unsignedInteger);
+                break;
+            case MessagePack::ValueType::Float:
+                // JSON has no infinities and NaNs
+                if (std::isfinite(value.number)) {
+                    fmt::format_to(std::back_inserter(output), "{}", value.number);
+                } else {
+                    Logger::appendText(output, std::string_view("null"));
+                }
+                break;
+            case MessagePack::ValueType::String:
+                output.push_back('"');
+                Logger::appendJsonEscaped(output, value.text);
+                output.push_back('"');
+                break;
+            case MessagePack::ValueType::Array:
+                output.push_back('[');
+                for (auto index = std::size_t(0); index < value.count; ++index) {
+                    if (index > 0) {
+                        output.push_back(',');
+                    }
+                    Logger::appendJsonValue(output, input);
+                }
+                output.push_back(']');
+                break;
+            case MessagePack::ValueType::Map:
+                output.push_back('{');
+                for (auto index = std::size_t(0); index < value.count; ++index) {
+                    if (index > 0) {
+                        output.push_back(',');
+                    }
+                    Logger::appendJsonValue(output, input);
+                    output.push_back(':');
+                    Logger::appendJsonValue(output, input);
+                }
+                output.push_back('}');
+                break;
         }
-        if (this->config.fields.includeThreadId) {
-            logEntry["thread_id"] = Logger::getThreadId();
+    }
+
+    /// @brief Appends the level tag, wrapped in ANSI colors when requested
+    /// @note Padding applies to the visible tag only, never to the color codes around it
+    static void appendLevel(fmt::memory_buffer & output, LogLevel level, bool colored,
+                            const FormatStep & step)
+    {
+        if (colored) {
+            Logger::appendText(output, Logger::levelToColor(level));
         }
-        if (this->config.fields.includeModuleName) {
-            if (!this->context.moduleName.empty()) {
-                logEntry["module"] = this->context.moduleName;
-            }
+
+        const auto start = output.size();
+        Logger::appendText(output, Logger::levelToString(level));
+        Logger::applyPadding(output, start, step.width, step.fill, step.align);
+
+        if (colored) {
+            Logger::appendText(output, AnsiColor::Reset);
+            Logger::appendText(output, AnsiColor::WarmTint);
         }
-        if (this->config.fields.includeLogLevel) {
-            logEntry["level"] = Logger::levelToString(level);
+    }
+
+    /// @brief Pads the text written since start up to the given width
+    template <typename Buffer>
+    static void applyPadding(Buffer & output, std::size_t start, std::size_t width, char fill,
+                             PatternAlign align)
+    {
+        const auto length = output.size() - start;
+        if (length >= width) {
+            return;
         }
-        if (this->config.fields.includeFile) {
-            logEntry["file"] = Logger::formatFileLine(location);
+
+        const auto padding = width - length;
+        const auto before = align == PatternAlign::Right
+                                ? padding
+                                : (align == PatternAlign::Center ? padding / 2 : 0);
+
+        output.resize(output.size() + padding);
+        auto * const data = output.data();
+        std::copy_backward(data + start, data + start + length, data + start + before + length);
+        std::fill_n(data + start, before, fill);
+        std::fill_n(data + start + before + length, padding - before, fill);
+    }
+
+    /// @brief Appends filename and line number of a source location
+    static void appendFileLine(fmt::memory_buffer & output, const std::source_location & location,
+                               ValueEscaping escaping)
+    {
+        auto file = std::string_view(location.file_name());
+        const auto position = file.find_last_of("/\\");
+        if (position != std::string_view::npos) {
+            file.remove_prefix(position + 1);
         }
-        if (this->config.fields.includeMessage) {
-            logEntry["message"] = message;
+
+        if (escaping == ValueEscaping::Logfmt) {
+            auto fileLine = fmt::memory_buffer();
+            Logger::appendText(fileLine, file);
+            fmt::format_to(std::back_inserter(fileLine), ":{}", location.line());
+            Logger::appendLogfmtValue(output, std::string_view(fileLine.data(), fileLine.size()));
+            return;
         }
 
-        return logEntry.dump();
+        Logger::appendValue(output, file, escaping);
+        fmt::format_to(std::back_inserter(output), ":{}", location.line());
     }
 
-    /// @brief Formats a log entry as a human-readable terminal string
-    std::string formatTerminal(LogLevel level, const std::string & message,
-                               const std::source_location & location)
+    /// @brief Appends a per-record string value with the given escaping
+    static void appendValue(fmt::memory_buffer & output, std::string_view text,
+                            ValueEscaping escaping)
     {
-        auto output = std::ostringstream();
-        const auto colored = this->useColors();
+        switch (escaping) {
+            case ValueEscaping::Json:
+                Logger::appendJsonEscaped(output, text);
+                break;
+            case ValueEscaping::Logfmt:
+                Logger::appendLogfmtValue(output, text);
+                break;
+            case ValueEscaping::StructuredData:
+                Logger::appendStructuredDataEscaped(output, text);
+                break;
+            default:
+                Logger::appendText(output, text);
+                break;
+        }
+    }
 
-        const auto section = [](const std::string & content) { return "[" + content + "]"; };
+    /// @brief Appends raw text to a buffer
+    template <typename Buffer>
+    static void appendText(Buffer & output, std::string_view text)
+    {
+        output.append(text.data(), text.data() + text.size());
+    }
 
-        if (colored) {
-            output << AnsiColor::WarmTint;
-        }
+    /// @brief Appends text as JSON string contents, escaping quotes, backslashes and controls
+    template <typename Buffer>
+    static void appendJsonEscaped(Buffer & output, std::string_view text)
+    {
+        constexpr auto hexDigits = std::string_view("0123456789abcdef");
+        constexpr auto firstPrintable = 0x20;
 
-        if (this->config.fields.includeTime) {
-            output << section(Logger::getCurrentTimeString());
-        }
-        if (this->config.fields.includeAppName) {
-            if (!this->context.appName.empty()) {
-                output << section(this->context.appName);
+        auto runStart = std::size_t(0);
+        for (auto index = std::size_t(0); index < text.size(); ++index) {
+            const auto character = static_cast<unsigned char>(text[index]);
+            if (character >= firstPrintable && character != '"' && character != '\\') {
+                continue;
             }
-        }
-        if (this->config.fields.includeModuleName) {
-            if (!this->context.moduleName.empty()) {
-                output << section(this->context.moduleName);
+
+            Logger::appendText(output, text.substr(runStart, index - runStart));
+            runStart = index + 1;
+
+            switch (character) {
+                case '"':
+                    Logger::appendText(output, "\\\"");
+                    break;
+                case '\\':
+                    Logger::appendText(output, "\\\\");
+                    break;
+                case '\b':
+                    Logger::appendText(output, "\\b");
+                    break;
+                case '\f':
+                    Logger::appendText(output, "\\f");
+                    break;
+                case '\n':
+                    Logger::appendText(output, "\\n");
+                    break;
+                case '\r':
+                    Logger::appendText(output, "\\r");
+                    break;
+                case '\t':
+                    Logger::appendText(output, "\\t");
+                    break;
+                default: {
+                    const char escaped[] = { '\\', 'u', '0', '0', hexDigits[character >> 4],
+                                             hexDigits[character & 0x0F] };
+                    Logger::appendText(output, std::string_view(escaped, sizeof(escaped)));
+                    break;
+                }
             }
         }
-        if (this->config.fields.includeProcessId) {
-            output << section("PID:" + std::to_string(this->processId));
-        }
-        if (this->config.fields.includeThreadId) {
-            output << section("TID:" + Logger::getThreadId());
-        }
-        if (this->config.fields.includeLogLevel) {
-            const auto levelText = Logger::levelToString(level);
-            if (colored) {
-                output << "[" << Logger::levelToColor(level) << levelText << AnsiColor::Reset
-                       << AnsiColor::WarmTint << "]";
-            } else {
-                output << section(levelText);
+        Logger::appendText(output, text.substr(runStart));
+    }
+
+    /// @brief Appends an RFC 5424 structured data parameter value, escaping '"', '\\' and ']'
+    template <typename Buffer>
+    static void appendStructuredDataEscaped(Buffer & output, std::string_view text)
+    {
+        auto runStart = std::size_t(0);
+        for (auto index = std::size_t(0); index < text.size(); ++index) {
+            const auto character = text[index];
+            if (character != '"' && character != '\\' && character != ']') {
+                continue;
             }
+            Logger::appendText(output, text.substr(runStart, index - runStart));
+            output.push_back('\\');
+            runStart = index;
         }
-        if (this->config.fields.includeFile) {
-            output << section(Logger::formatFileLine(location));
-        }
-        if (this->config.fields.includeMessage) {
-            output << " " << message;
-        }
+        Logger::appendText(output, text.substr(runStart));
+    }
 
-        if (colored) {
-            output << AnsiColor::Reset;
+    /// @brief Appends a logfmt value, quoting it when empty or when it contains spaces,
+    /// '=', quotes or control characters
+    template <typename Buffer>
+    static void appendLogfmtValue(Buffer & output, std::string_view text)
+    {
+        if (!Logger::logfmtNeedsQuotes(text)) {
+            Logger::appendText(output, text);
+            return;
         }
 
-        return output.str();
+        output.push_back('"');
+        Logger::appendLogfmtEscaped(output, text);
+        output.push_back('"');
     }
 
-    /// [Utility]
+    /// @brief Returns whether a logfmt value must be quoted
+    static bool logfmtNeedsQuotes(std::string_view text)
+    {
+        constexpr auto deleteCharacter = 0x7F;
+        return text.empty() || std::any_of(text.begin(), text.end(), [](char value) {
+                   const auto character = static_cast<unsigned char>(value);
+                   return character <= ' ' || character == '=' || character == '"' ||
+                          character == deleteCharacter;
+               });
+    }
 
-    /// @brief Returns whether coloring should be applied to terminal output
-    bool useColors() const
+    /// @brief Appends the escaped contents of a quoted logfmt value
+    template <typename Buffer>
+    static void appendLogfmtEscaped(Buffer & output, std::string_view text)
     {
-        return this->config.enableColors && this->config.format == OutputFormat::Terminal &&
-               this->config.logToConsole;
+        constexpr auto firstPrintable = 0x20;
+        constexpr auto deleteCharacter = 0x7F;
+
+        auto runStart = std::size_t(0);
+        for (auto index = std::size_t(0); index < text.size(); ++index) {
+            const auto character = static_cast<unsigned char>(text[index]);
+            if (character >= firstPrintable && character != '"' && character != '\\' &&
+                character != deleteCharacter) {
+                continue;
+            }
+
+            Logger::appendText(output, text.substr(runStart, index - runStart));
+            runStart = index + 1;
+
+            switch (character) {
+                case '"':
+                    Logger::appendText(output, "\\\"");
+                    break;
+                case '\\':
+                    Logger::appendText(output, "\\\\");
+                    break;
+                case '\n':
+                    Logger::appendText(output, "\\n");
+                    break;
+                case '\r':
+                    Logger::appendText(output, "\\r");
+                    break;
+                case '\t':
+                    Logger::appendText(output, "\\t");
+                    break;
+                default:
+                    fmt::format_to(std::back_inserter(output), "\\u{:04x}",
+                                   static_cast<unsigned>(character));
+                    break;
+            }
+        }
+        Logger::appendText(output, text.substr(runStart));
     }
 
+    /// [Utility]
+
     /// @brief Returns the ANSI color escape code for a given log level
     static const char * levelToColor(LogLevel level)
     {
@@ -551,22 +5687,8 @@ private:
         }
     }
 
-    /// @brief Extracts filename and line number from a source location
-    static std::string formatFileLine(const std::source_location & location)
-    {
-        auto file = std::string(location.file_name());
-        const auto position = file.find_last_of("/\\");
-        if (position != std::string::npos) {
-            file = file.substr(position + 1);
-        }
-
-        auto fileLine = std::ostringstream();
-        fileLine << file << ":" << location.line();
-        return fileLine.str();
-    }
-
     /// @brief Converts a LogLevel to its short string representation
-    static std::string levelToString(LogLevel level)
+    static std::string_view levelToString(LogLevel level)
     {
         switch (level) {
             case LogLevel::Trace:
@@ -586,6 +5708,68 @@ private:
         }
     }
 
+    /// @brief Converts a LogLevel to its OpenTelemetry severity number
+    static int levelToSeverityNumber(LogLevel level)
+    {
+        switch (level) {
+            case LogLevel::Trace:
+                return 1;
+            case LogLevel::Debug:
+                return 5;
+            case LogLevel::Warning:
+                return 13;
+            case LogLevel::Error:
+                return 17;
+            case LogLevel::Critical:
+                return 21;
+            default:
+                return 9;
+        }
+    }
+
+    /// @brief Converts a LogLevel to its OpenTelemetry severity text
+    static std::string_view levelToSeverityText(LogLevel level)
+    {
+        switch (level) {
+            case LogLevel::Trace:
+                return "TRACE";
+            case LogLevel::Debug:
+                return "DEBUG";
+            case LogLevel::Warning:
+                return "WARN";
+            case LogLevel::Error:
+                return "ERROR";
+            case LogLevel::Critical:
+                return "FATAL";
+            default:
+                return "INFO";
+        }
+    }
+
+    /// @brief Converts a LogLevel to its syslog severity
+    static int levelToSyslogSeverity(LogLevel level)
+    {
+        constexpr auto critical = 2;
+        constexpr auto error = 3;
+        constexpr auto warning = 4;
+        constexpr auto informational = 6;
+        constexpr auto debug = 7;
+
+        switch (level) {
+            case LogLevel::Trace:
+            case LogLevel::Debug:
+                return debug;
+            case LogLevel::Warning:
+                return warning;
+            case LogLevel::Error:
+                return error;
+            case LogLevel::Critical:
+                return critical;
+            default:
+                return informational;
+        }
+    }
+
     /// @brief Converts a LogLevel to the corresponding spdlog level
     static spdlog::level::level_enum toSpdlogLevel(LogLevel level)
     {
@@ -619,46 +5803,173 @@ private:
 #endif
     }
 
-    /// @brief Returns the current kernel thread ID as a string
-    static std::string getThreadId()
+    /// @brief Returns the host name of the machine, "-" when it cannot be determined
+    static std::string getHostName()
+    {
+        constexpr auto hostNameCapacity = std::size_t(256);
+        char hostName[hostNameCapacity] = {};
+#ifdef _WIN32
+        auto length = static_cast<DWORD>(hostNameCapacity);
+        if (!GetComputerNameA(hostName, &length)) {
+            return "-";
+        }
+#else
+        if (gethostname(hostName, hostNameCapacity - 1) != 0) {
+            return "-";
+        }
+#endif
+        return hostName[0] == '\0' ? std::string("-") : std::string(hostName);
+    }
+
+    /// @brief Returns the current kernel thread ID, cached per thread
+    static int getThreadId()
     {
 #ifdef _WIN32
-        return std::to_string(static_cast<int>(GetCurrentThreadId()));
+        thread_local const auto threadId = static_cast<int>(GetCurrentThreadId());
 #else
-        return std::to_string(static_cast<int>(syscall(SYS_gettid)));
+        thread_local const auto threadId = static_cast<int>(syscall(SYS_gettid));
 #endif
+        return threadId;
+    }
+
+    /// @brief Appends a timestamp in the given style
+    /// @note Numeric styles skip calendar conversion entirely
+    static void appendTimestamp(fmt::memory_buffer & output, std::int64_t nanoseconds,
+                                TimestampStyle style)
+    {
+        if (IsNumericTimestamp(style)) {
+            fmt::format_to(std::back_inserter(output), "{}",
+                           Logger::epochTimestamp(nanoseconds, style));
+            return;
+        }
+
+        Logger::appendCalendarTime(output, nanoseconds, style);
+    }
+
+    /// @brief Appends seconds since the epoch with a millisecond fraction, "1759776726.529"
+    template <typename Buffer>
+    static void appendUnixSeconds(Buffer & output, std::int64_t nanoseconds)
+    {
+        constexpr auto nanosecondsPerMillisecond = 1'000'000;
+        const auto milliseconds = nanoseconds / nanosecondsPerMillisecond;
+        fmt::format_to(std::back_inserter(output), "{}.{:03}", milliseconds / MillisecondsDivisor,
+                       milliseconds % MillisecondsDivisor);
+    }
+
+    /// @brief Converts nanoseconds since the epoch to the unit of a numeric timestamp style
+    static std::int64_t epochTimestamp(std::int64_t nanoseconds, TimestampStyle style)
+    {
+        constexpr auto nanosecondsPerMicrosecond = 1'000;
+        constexpr auto nanosecondsPerMillisecond = 1'000'000;
+        constexpr auto nanosecondsPerSecond = 1'000'000'000;
+
+        switch (style) {
+            case TimestampStyle::EpochSeconds:
+                return nanoseconds / nanosecondsPerSecond;
+            case TimestampStyle::EpochMilliseconds:
+                return nanoseconds / nanosecondsPerMillisecond;
+            case TimestampStyle::EpochMicroseconds:
+                return nanoseconds / nanosecondsPerMicrosecond;
+            default:
+                return nanoseconds;
+        }
     }
 
-    /// @brief Returns the current timestamp as a formatted string
-    static std::string getCurrentTimeString()
+    /// @brief Appends a timestamp as calendar time with millisecond precision
+    /// @note The calendar part is cached per thread and style and only recomputed when the
+    /// second changes
+    static void appendCalendarTime(fmt::memory_buffer & output, std::int64_t nanoseconds,
+                                   TimestampStyle style)
     {
-        const auto now = std::chrono::system_clock::now();
+        constexpr auto calendarCapacity = std::size_t(32);
+        constexpr auto calendarStyles = std::size_t(3);
+        constexpr auto secondsPerMinute = 60;
+        constexpr auto minutesPerHour = 60;
+
+        struct CalendarCache {
+            std::chrono::seconds second = std::chrono::seconds::min();
+            char calendar[calendarCapacity] = {};
+            std::size_t calendarLength = 0;
+            char zone[calendarCapacity] = {};
+            std::size_t zoneLength = 0;
+        };
+        thread_local CalendarCache caches[calendarStyles];
+
+        const auto sinceEpoch = std::chrono::nanoseconds(nanoseconds);
+        const auto seconds = std::chrono::floor<std::chrono::seconds>(sinceEpoch);
         const auto milliseconds =
-            std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) %
-            MillisecondsDivisor;
-        const auto timeValue = std::chrono::system_clock::to_time_t(now);
+            std::chrono::floor<std::chrono::milliseconds>(sinceEpoch).count() % MillisecondsDivisor;
+
+        auto & cache = caches[static_cast<std::size_t>(style)];
+        if (seconds != cache.second) {
+            const auto timeValue = static_cast<std::time_t>(seconds.count());
+            auto calendar = std::tm();
+
+            if (style == TimestampStyle::UtcIso8601) {
+#ifdef _WIN32
+                gmtime_s(&calendar, &timeValue);
+#else
+                gmtime_r(&timeValue, &calendar);
+#endif
+                cache.calendarLength = std::strftime(cache.calendar, calendarCapacity,
+                                                     "%Y-%m-%dT%H:%M:%S", &calendar);
+                cache.zoneLength = fmt::format_to_n(cache.zone, calendarCapacity, "Z").size;
+            } else {
+#ifdef _WIN32
+                localtime_s(&calendar, &timeValue);
+#else
+                localtime_r(&timeValue, &calendar);
+#endif
+                const auto * const layout =
+                    style == TimestampStyle::Rfc3339 ? "%Y-%m-%dT%H:%M:%S" : "%Y-%m-%d %H:%M:%S";
+                cache.calendarLength =
+                    std::strftime(cache.calendar, calendarCapacity, layout, &calendar);
+                cache.zoneLength = 0;
+
+                if (style == TimestampStyle::Rfc3339) {
+#ifdef _WIN32
+                    const auto offsetSeconds = static_cast<long>(_mkgmtime(&calendar) - timeValue);
+#else
+                    const auto offsetSeconds = static_cast<long>(calendar.tm_gmtoff);
+#endif
+                    const auto offsetMinutes = std::abs(offsetSeconds) / secondsPerMinute;
+                    cache.zoneLength =
+                        fmt::format_to_n(cache.zone, calendarCapacity, "{}{:02}:{:02}",
+                                         offsetSeconds < 0 ? '-' : '+',
+                                         offsetMinutes / minutesPerHour,
+                                         offsetMinutes % minutesPerHour)
+                            .size;
+                }
+            }
+            cache.second = seconds;
+        }
 
-        auto output = std::ostringstream();
-        output << std::put_time(std::localtime(&timeValue), "%Y-%m-%d %H:%M:%S");
-        output << '.' << std::setfill('0') << std::setw(MillisecondsFieldWidth)
-               << milliseconds.count();
-        return output.str();
+        Logger::appendText(output, std::string_view(cache.calendar, cache.calendarLength));
+        fmt::format_to(std::back_inserter(output), ".{:0{}}", milliseconds,
+                       MillisecondsFieldWidth);
+        Logger::appendText(output, std::string_view(cache.zone, cache.zoneLength));
     }
 
 #pragma endregion
 
     /// [Properties]
 
-    /// @brief Current minimum log level
-    LogLevel level = LogLevel::Trace;
+    /// @brief Current minimum log level, changed by SetLevel while other threads log
+    std::unique_ptr<std::atomic<LogLevel>> level =
+        std::make_unique<std::atomic<LogLevel>>(LogLevel::Trace);
+    /// @brief Last sequence number handed out
+    std::unique_ptr<std::atomic<std::uint64_t>> sequence =
+        std::make_unique<std::atomic<std::uint64_t>>(0);
+    /// @brief Async workers, outliving the logger whose queued records they write
+    std::shared_ptr<AsyncBackend> backend = nullptr;
     /// @brief Underlying spdlog logger instance
     std::shared_ptr<spdlog::logger> logger = nullptr;
-    /// @brief Logger configuration
-    Config config;
-    /// @brief Logger context with app and module names
-    Context context;
+    /// @brief Sink receiving every record, kept for its queue metrics
+    std::shared_ptr<RecordSink> recordSink = nullptr;
     /// @brief Cached process ID
     int processId = 0;
+    /// @brief Published configuration snapshots, read lock-free on every record
+    std::shared_ptr<SnapshotStore<Snapshot>> snapshots = nullptr;
 };
 
 /// @brief Predefined logging profiles for common use cases
@@ -670,7 +5981,8 @@ enum class LogProfile {
     ColoredDefault,
     ColoredDetailed,
     ColoredVerbose,
-    Json
+    Json,
+    CompactJson
 };
 
 /// @brief Creates a logger configuration for the given profile
@@ -777,6 +6089,21 @@ inline Logger::Config MakeProfileConfig(LogProfile profile)
                                             .includeMessage = true,
                                             .includeTime = true };
             break;
+
+        case LogProfile::CompactJson:
+            config.format = OutputFormat::Json;
+            config.keys = FieldKeys::Compact();
+            config.json = JsonSchema::Compact();
+            config.fields = LogFieldConfig{ .includeAppName = true,
+                                            .includeProcessId = true,
+                                            .includeThreadId = true,
+                                            .includeModuleName = true,
+                                            .includeLogLevel = true,
+                                            .includeFile = true,
+                                            .includeMessage = true,
+                                            .includeTime = true,
+                                            .timestampStyle = TimestampStyle::EpochMilliseconds };
+            break;
     }
 
     return config;
@@ -0,0 +1,771 @@
+#pragma once
+
+#include "kvalog.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <source_location>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace kvalog
+{
+
+/// @brief Default number of records per columnar segment
+inline constexpr std::size_t DefaultSegmentRecords = 65536;
+/// @brief File extension of columnar segments
+inline constexpr auto SegmentExtension = ".kvc";
+
+/// @brief Columns of a columnar segment, in file order
+enum class SegmentColumn : std::uint32_t {
+    /// @brief Nanoseconds since the Unix epoch, zigzag varint deltas
+    Time,
+    /// @brief One byte per record
+    Level,
+    /// @brief Varint thread ids
+    Thread,
+    /// @brief Dictionary of application names, then varint ids
+    App,
+    /// @brief Dictionary of module names, then varint ids
+    Module,
+    /// @brief Dictionary of files, dictionary of (file, line) call sites, then varint ids
+    CallSite,
+    /// @brief Varint message lengths, then the message bytes
+    Message,
+    Count
+};
+
+/// @brief Location of a column in a segment file
+struct SegmentExtent {
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+};
+
+///
+/// @brief
+/// SegmentHeader starts every columnar segment file. It carries enough statistics to skip a
+/// whole segment without reading a column, followed by the extent of every column.
+/// Integers are stored in host byte order, the magic tells a foreign byte order apart.
+///
+struct SegmentHeader {
+    /// @brief Identifies a segment file
+    static constexpr std::uint32_t Magic = 0x7363'766B;  // "kvcs"
+    /// @brief Layout version
+    static constexpr std::uint32_t Version = 1;
+
+    std::uint32_t magic = Magic;
+    std::uint32_t version = Version;
+    std::uint32_t recordCount = 0;
+    /// @brief Bit per LogLevel present in the segment
+    std::uint32_t levelMask = 0;
+    /// @brief Earliest record time in nanoseconds since the Unix epoch
+    std::int64_t minTime = 0;
+    /// @brief Latest record time in nanoseconds since the Unix epoch
+    std::int64_t maxTime = 0;
+    std::array<SegmentExtent, static_cast<std::size_t>(SegmentColumn::Count)> columns = {};
+};
+
+static_assert(std::is_trivially_copyable_v<SegmentHeader>,
+              "SegmentHeader is written to segment files bytewise");
+
+/// @brief Variable-length integer encoding of segment columns
+namespace SegmentEncoding
+{
+
+/// @brief Appends an unsigned LEB128 varint
+inline void WriteVarint(std::string & output, std::uint64_t value)
+{
+    while (value >= 0x80) {
+        output.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    output.push_back(static_cast<char>(value));
+}
+
+/// @brief Reads an unsigned LEB128 varint and advances the cursor
+/// @throws std::runtime_error when the column ends inside the varint
+inline std::uint64_t ReadVarint(const char *& cursor, const char * end)
+{
+    auto value = std::uint64_t(0);
+    for (auto shift = 0; cursor < end && shift < 64; shift += 7) {
+        const auto byte = static_cast<std::uint8_t>(*cursor++);
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("kvalog: truncated segment column");
+}
+
+/// @brief Maps signed deltas to unsigned values, small magnitudes to small values
+constexpr std::uint64_t ZigZag(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+/// @brief Reverses ZigZag
+constexpr std::int64_t UnZigZag(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+/// @brief Appends a dictionary: count, then each value with its length
+inline void WriteDictionary(std::string & output, const std::vector<std::string> & values)
+{
+    SegmentEncoding::WriteVarint(output, values.size());
+    for (const auto & value : values) {
+        SegmentEncoding::WriteVarint(output, value.size());
+        output.append(value);
+    }
+}
+
+/// @brief Reads a dictionary written by WriteDictionary
+inline std::vector<std::string> ReadDictionary(const char *& cursor, const char * end)
+{
+    auto values = std::vector<std::string>(SegmentEncoding::ReadVarint(cursor, end));
+    for (auto & value : values) {
+        const auto length = SegmentEncoding::ReadVarint(cursor, end);
+        if (length > static_cast<std::uint64_t>(end - cursor)) {
+            throw std::runtime_error("kvalog: truncated segment dictionary");
+        }
+        value.assign(cursor, length);
+        cursor += length;
+    }
+    return values;
+}
+
+/// @brief Reads the given number of varint ids
+inline std::vector<std::uint32_t> ReadIds(const char *& cursor, const char * end,
+                                          std::size_t count)
+{
+    auto ids = std::vector<std::uint32_t>(count);
+    for (auto & id : ids) {
+        id = static_cast<std::uint32_t>(SegmentEncoding::ReadVarint(cursor, end));
+    }
+    return ids;
+}
+
+}  // namespace SegmentEncoding
+
+/// @brief Columnar sink configuration
+struct ColumnarOptions {
+    /// @brief Directory receiving the segment files, created when missing
+    std::filesystem::path directory;
+    /// @brief File name prefix of the segments
+    std::string prefix = "kvalog";
+    /// @brief Records per segment; a flush also ends the current segment
+    std::size_t recordsPerSegment = DefaultSegmentRecords;
+};
+
+///
+/// @brief
+/// ColumnarSegmentSink stores records as columnar segment files instead of text. Records are
+/// collected column by column: times as deltas, levels as bytes, application, module and call
+/// site as ids into per-segment dictionaries, and messages as lengths plus bytes. A segment is
+/// written under a temporary name and renamed when complete, so readers never see partial
+/// segments. Segment names start with the zero-padded time of their first record and sort in
+/// time order.
+///
+class ColumnarSegmentSink : public IStructuredSink
+{
+public:
+    /// [Fabric Methods]
+
+    /// @brief Creates a columnar sink with the given options
+    static std::shared_ptr<ColumnarSegmentSink> Create(const ColumnarOptions & options)
+    {
+        return std::make_shared<ColumnarSegmentSink>(options);
+    }
+
+    /// [Construction & Destruction]
+
+#pragma region ColumnarSegmentSink::Construct
+
+    /// @brief Copy constructor is deleted
+    ColumnarSegmentSink(const ColumnarSegmentSink &) = delete;
+    /// @brief Copy operator is deleted
+    ColumnarSegmentSink & operator=(const ColumnarSegmentSink &) = delete;
+
+    /// @brief Constructor with options
+    /// @throws std::filesystem::filesystem_error when the directory cannot be created
+    /// @warning Avoid using this constructor since class has static fabric methods
+    explicit ColumnarSegmentSink(const ColumnarOptions & initialOptions)
+        : options(initialOptions)
+    {
+        this->options.recordsPerSegment = std::max<std::size_t>(this->options.recordsPerSegment, 1);
+        std::filesystem::create_directories(this->options.directory);
+    }
+
+    /// @brief Destructor, writes the records of the last segment
+    ~ColumnarSegmentSink() override
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->writeSegment();
+    }
+
+#pragma endregion
+
+    /// [IStructuredSink]
+
+    /// @brief Appends a record to the current segment, writing it once full
+    void WriteRecord(const LogRecord & record, std::string_view appName,
+                     std::string_view moduleName) override
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->recordCount == 0) {
+            this->firstTime = record.timestamp;
+            this->previousTime = 0;
+            this->minTime = record.timestamp;
+            this->maxTime = record.timestamp;
+        }
+
+        const auto delta = record.timestamp - this->previousTime;
+        SegmentEncoding::WriteVarint(this->times, SegmentEncoding::ZigZag(delta));
+        this->previousTime = record.timestamp;
+        this->minTime = std::min(this->minTime, record.timestamp);
+        this->maxTime = std::max(this->maxTime, record.timestamp);
+
+        this->levels.push_back(static_cast<char>(record.level));
+        this->levelMask |= 1U << static_cast<unsigned>(record.level);
+        SegmentEncoding::WriteVarint(this->threads, static_cast<std::uint32_t>(record.threadId));
+        SegmentEncoding::WriteVarint(this->appIds, this->apps.Intern(appName));
+        SegmentEncoding::WriteVarint(this->moduleIds, this->modules.Intern(moduleName));
+        SegmentEncoding::WriteVarint(this->callSiteIds, this->internCallSite(record.location));
+        SegmentEncoding::WriteVarint(this->messageLengths, record.message.size());
+        this->messages.append(record.message);
+
+        if (++this->recordCount >= this->options.recordsPerSegment) {
+            this->writeSegment();
+        }
+    }
+
+    /// @brief Writes the records collected so far as a segment
+    void Flush() override
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->writeSegment();
+    }
+
+    /// [Segments]
+
+    /// @brief Returns the paths of the segments written so far
+    std::vector<std::filesystem::path> Segments() const
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->written;
+    }
+
+private:
+    /// [Dictionaries]
+
+    ///
+    /// @brief
+    /// Dictionary maps the values of a column to dense ids, reset with every segment
+    ///
+    struct Dictionary {
+        std::vector<std::string> values;
+        std::unordered_map<std::string, std::uint32_t> ids;
+        /// @brief Id returned last
+        std::size_t last = 0;
+
+        /// @brief Returns the id of a value, adding it when new
+        std::uint32_t Intern(std::string_view value)
+        {
+            // Consecutive records almost always share the value of their predecessor
+            if (this->last < this->values.size() && this->values[this->last] == value) {
+                return static_cast<std::uint32_t>(this->last);
+            }
+            const auto [position, added] = this->ids.try_emplace(
+                std::string(value), static_cast<std::uint32_t>(this->values.size()));
+            if (added) {
+                this->values.emplace_back(value);
+            }
+            this->last = position->second;
+            return position->second;
+        }
+
+        /// @brief Forgets every value
+        void Clear()
+        {
+            this->values.clear();
+            this->ids.clear();
+            this->last = 0;
+        }
+    };
+
+    /// @brief Call site key: file name pointers of source locations are stable per file
+    struct CallSiteKey {
+        const char * file = nullptr;
+        std::uint32_t line = 0;
+
+        bool operator==(const CallSiteKey &) const = default;
+    };
+
+    /// @brief Hash of a call site key
+    struct CallSiteKeyHash {
+        std::size_t operator()(const CallSiteKey & key) const
+        {
+            return std::hash<const char *>()(key.file) ^ (std::size_t(key.line) * 0x9e37'79b9);
+        }
+    };
+
+    /// @brief Returns the id of a call site, adding it and its file when new
+    std::uint32_t internCallSite(const std::source_location & location)
+    {
+        const auto key = CallSiteKey{ .file = location.file_name(), .line = location.line() };
+        const auto [position, added] = this->callSiteIdsByKey.try_emplace(
+            key, static_cast<std::uint32_t>(this->callSiteFiles.size()));
+        if (added) {
+            this->callSiteFiles.push_back(this->files.Intern(location.file_name()));
+            this->callSiteLines.push_back(location.line());
+        }
+        return position->second;
+    }
+
+    /// [Segment Files]
+
+    /// @brief Encodes the collected columns into a segment file and starts a new segment
+    void writeSegment()
+    {
+        if (this->recordCount == 0) {
+            return;
+        }
+
+        auto dictionaries = std::array<std::string, 3>();
+        SegmentEncoding::WriteDictionary(dictionaries[0], this->apps.values);
+        SegmentEncoding::WriteDictionary(dictionaries[1], this->modules.values);
+        SegmentEncoding::WriteDictionary(dictionaries[2], this->files.values);
+        SegmentEncoding::WriteVarint(dictionaries[2], this->callSiteFiles.size());
+        for (auto site = std::size_t(0); site < this->callSiteFiles.size(); ++site) {
+            SegmentEncoding::WriteVarint(dictionaries[2], this->callSiteFiles[site]);
+            SegmentEncoding::WriteVarint(dictionaries[2], this->callSiteLines[site]);
+        }
+
+        // Each column is one or two consecutive parts
+        const auto parts = std::array<std::pair<const std::string *, const std::string *>, 7>{ {
+            { &this->times, nullptr },
+            { &this->levels, nullptr },
+            { &this->threads, nullptr },
+            { &dictionaries[0], &this->appIds },
+            { &dictionaries[1], &this->moduleIds },
+            { &dictionaries[2], &this->callSiteIds },
+            { &this->messageLengths, &this->messages },
+        } };
+
+        auto header = SegmentHeader();
+        header.recordCount = static_cast<std::uint32_t>(this->recordCount);
+        header.levelMask = this->levelMask;
+        header.minTime = this->minTime;
+        header.maxTime = this->maxTime;
+        auto offset = std::uint64_t(sizeof(SegmentHeader));
+        for (auto column = std::size_t(0); column < parts.size(); ++column) {
+            const auto & [first, second] = parts[column];
+            const auto size = first->size() + (second != nullptr ? second->size() : 0);
+            header.columns[column] = SegmentExtent{ .offset = offset, .size = size };
+            offset += size;
+        }
+
+        const auto name = fmt::format("{}-{:020}-{:04}{}", this->options.prefix, this->firstTime,
+                                      this->segmentNumber++, SegmentExtension);
+        const auto path = this->options.directory / name;
+        auto temporary = path;
+        temporary += ".tmp";
+        {
+            auto output = std::ofstream(temporary, std::ios::binary | std::ios::trunc);
+            output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            for (const auto & [first, second] : parts) {
+                output.write(first->data(), static_cast<std::streamsize>(first->size()));
+                if (second != nullptr) {
+                    output.write(second->data(), static_cast<std::streamsize>(second->size()));
+                }
+            }
+        }
+        auto error = std::error_code();
+        std::filesystem::rename(temporary, path, error);
+        if (!error) {
+            this->written.push_back(path);
+        }
+
+        this->reset();
+    }
+
+    /// @brief Clears the collected columns, keeping their capacity
+    void reset()
+    {
+        this->recordCount = 0;
+        this->levelMask = 0;
+        this->times.clear();
+        this->levels.clear();
+        this->threads.clear();
+        this->appIds.clear();
+        this->moduleIds.clear();
+        this->callSiteIds.clear();
+        this->messageLengths.clear();
+        this->messages.clear();
+        this->apps.Clear();
+        this->modules.Clear();
+        this->files.Clear();
+        this->callSiteIdsByKey.clear();
+        this->callSiteFiles.clear();
+        this->callSiteLines.clear();
+    }
+
+    /// [Properties]
+
+    /// @brief Sink options
+    ColumnarOptions options;
+    /// @brief Guards the collected columns
+    mutable std::mutex mutex;
+    /// @brief Paths of the segments written so far
+    std::vector<std::filesystem::path> written;
+    /// @brief Number of the next segment written by this sink
+    std::size_t segmentNumber = 0;
+
+    /// @brief Records in the current segment
+    std::size_t recordCount = 0;
+    /// @brief Time of the first record of the current segment
+    std::int64_t firstTime = 0;
+    /// @brief Time of the previous record, the base of the next delta
+    std::int64_t previousTime = 0;
+    /// @brief Earliest time in the current segment
+    std::int64_t minTime = 0;
+    /// @brief Latest time in the current segment
+    std::int64_t maxTime = 0;
+    /// @brief Levels present in the current segment
+    std::uint32_t levelMask = 0;
+
+    /// @brief Encoded columns of the current segment
+    std::string times;
+    std::string levels;
+    std::string threads;
+    std::string appIds;
+    std::string moduleIds;
+    std::string callSiteIds;
+    std::string messageLengths;
+    std::string messages;
+
+    /// @brief Dictionaries of the current segment
+    Dictionary apps;
+    Dictionary modules;
+    Dictionary files;
+    std::unordered_map<CallSiteKey, std::uint32_t, CallSiteKeyHash> callSiteIdsByKey;
+    std::vector<std::uint32_t> callSiteFiles;
+    std::vector<std::uint32_t> callSiteLines;
+};
+
+/// @brief Dictionary-encoded column decoded from a segment
+struct SegmentDictionary {
+    std::vector<std::string> values;
+    /// @brief Index into values for every record
+    std::vector<std::uint32_t> ids;
+};
+
+/// @brief Call site of a record
+struct SegmentCallSite {
+    /// @brief Index into SegmentCallSites::files
+    std::uint32_t file = 0;
+    std::uint32_t line = 0;
+};
+
+/// @brief Call site column decoded from a segment
+struct SegmentCallSites {
+    std::vector<std::string> files;
+    std::vector<SegmentCallSite> sites;
+    /// @brief Index into sites for every record
+    std::vector<std::uint32_t> ids;
+};
+
+/// @brief Message column decoded from a segment
+struct SegmentMessages {
+    std::string bytes;
+    /// @brief Start of every message in bytes, followed by the end of the last one
+    std::vector<std::size_t> offsets;
+
+    /// @brief Returns the message of a record
+    std::string_view At(std::size_t row) const
+    {
+        return std::string_view(this->bytes).substr(this->offsets[row],
+                                                    this->offsets[row + 1] - this->offsets[row]);
+    }
+};
+
+/// @brief Record filter evaluated against segment columns; unset members match everything
+struct SegmentQuery {
+    std::optional<LogLevel> minLevel = std::nullopt;
+    std::optional<std::string> app = std::nullopt;
+    std::optional<std::string> module = std::nullopt;
+    /// @brief Inclusive lower time bound in nanoseconds since the Unix epoch
+    std::optional<std::int64_t> since = std::nullopt;
+    /// @brief Exclusive upper time bound in nanoseconds since the Unix epoch
+    std::optional<std::int64_t> until = std::nullopt;
+    /// @brief Substring the message must contain
+    std::optional<std::string> contains = std::nullopt;
+};
+
+///
+/// @brief
+/// ColumnarSegmentReader reads a segment file column by column, so a query only reads the
+/// columns it filters on and the columns of its output.
+///
+class ColumnarSegmentReader
+{
+public:
+    /// [Construction & Destruction]
+
+#pragma region ColumnarSegmentReader::Construct
+
+    /// @brief Copy constructor is deleted
+    ColumnarSegmentReader(const ColumnarSegmentReader &) = delete;
+    /// @brief Copy operator is deleted
+    ColumnarSegmentReader & operator=(const ColumnarSegmentReader &) = delete;
+
+    /// @brief Opens a segment file and reads its header
+    /// @throws std::runtime_error when the file is not a readable segment
+    static std::unique_ptr<ColumnarSegmentReader> Open(const std::filesystem::path & path)
+    {
+        auto reader = std::unique_ptr<ColumnarSegmentReader>(new ColumnarSegmentReader());
+        reader->file.open(path, std::ios::binary);
+        reader->file.read(reinterpret_cast<char *>(&reader->header), sizeof(SegmentHeader));
+        if (!reader->file || reader->header.magic != SegmentHeader::Magic ||
+            reader->header.version != SegmentHeader::Version) {
+            throw std::runtime_error("kvalog: not a columnar segment: " + path.string());
+        }
+        return reader;
+    }
+
+#pragma endregion
+
+    /// [Header]
+
+    /// @brief Returns the segment header
+    const SegmentHeader & Header() const
+    {
+        return this->header;
+    }
+
+    /// @brief Returns whether the header statistics rule out every record of the segment
+    bool CanSkip(const SegmentQuery & query) const
+    {
+        if (query.since && this->header.maxTime < *query.since) {
+            return true;
+        }
+        if (query.until && this->header.minTime >= *query.until) {
+            return true;
+        }
+        if (query.minLevel) {
+            const auto wanted = ~((1U << static_cast<unsigned>(*query.minLevel)) - 1);
+            return (this->header.levelMask & wanted) == 0;
+        }
+        return false;
+    }
+
+    /// [Columns]
+
+    /// @brief Decodes the time column
+    std::vector<std::int64_t> Times() const
+    {
+        const auto column = this->readColumn(SegmentColumn::Time);
+        const auto * cursor = column.data();
+        auto times = std::vector<std::int64_t>(this->header.recordCount);
+        auto previous = std::int64_t(0);
+        for (auto & time : times) {
+            previous += SegmentEncoding::UnZigZag(
+                SegmentEncoding::ReadVarint(cursor, column.data() + column.size()));
+            time = previous;
+        }
+        return times;
+    }
+
+    /// @brief Decodes the level column
+    std::vector<LogLevel> Levels() const
+    {
+        const auto column = this->readColumn(SegmentColumn::Level);
+        if (column.size() < this->header.recordCount) {
+            throw std::runtime_error("kvalog: truncated segment column");
+        }
+        auto levels = std::vector<LogLevel>(this->header.recordCount);
+        for (auto row = std::size_t(0); row < levels.size(); ++row) {
+            levels[row] = static_cast<LogLevel>(column[row]);
+        }
+        return levels;
+    }
+
+    /// @brief Decodes the thread column
+    std::vector<std::uint32_t> Threads() const
+    {
+        const auto column = this->readColumn(SegmentColumn::Thread);
+        const auto * cursor = column.data();
+        return SegmentEncoding::ReadIds(cursor, column.data() + column.size(),
+                                        this->header.recordCount);
+    }
+
+    /// @brief Decodes the application column
+    SegmentDictionary Apps() const
+    {
+        return this->readDictionaryColumn(SegmentColumn::App);
+    }
+
+    /// @brief Decodes the module column
+    SegmentDictionary Modules() const
+    {
+        return this->readDictionaryColumn(SegmentColumn::Module);
+    }
+
+    /// @brief Decodes the call site column
+    SegmentCallSites CallSites() const
+    {
+        const auto column = this->readColumn(SegmentColumn::CallSite);
+        const auto * cursor = column.data();
+        const auto * end = column.data() + column.size();
+
+        auto callSites = SegmentCallSites();
+        callSites.files = SegmentEncoding::ReadDictionary(cursor, end);
+        callSites.sites.resize(SegmentEncoding::ReadVarint(cursor, end));
+        for (auto & site : callSites.sites) {
+            site.file = static_cast<std::uint32_t>(SegmentEncoding::ReadVarint(cursor, end));
+            site.line = static_cast<std::uint32_t>(SegmentEncoding::ReadVarint(cursor, end));
+        }
+        callSites.ids = SegmentEncoding::ReadIds(cursor, end, this->header.recordCount);
+        return callSites;
+    }
+
+    /// @brief Decodes the message column
+    SegmentMessages Messages() const
+    {
+        auto column = this->readColumn(SegmentColumn::Message);
+        const auto * cursor = column.data();
+        const auto * end = column.data() + column.size();
+
+        auto messages = SegmentMessages();
+        messages.offsets.resize(this->header.recordCount + 1);
+        for (auto row = std::size_t(0); row < this->header.recordCount; ++row) {
+            messages.offsets[row + 1] =
+                messages.offsets[row] + SegmentEncoding::ReadVarint(cursor, end);
+        }
+        const auto lengthsSize = static_cast<std::size_t>(cursor - column.data());
+        if (column.size() - lengthsSize < messages.offsets.back()) {
+            throw std::runtime_error("kvalog: truncated segment column");
+        }
+        column.erase(0, lengthsSize);
+        messages.bytes = std::move(column);
+        return messages;
+    }
+
+    /// [Queries]
+
+    /// @brief Returns the rows matching the query in time order, reading only the columns the
+    /// query filters on
+    std::vector<std::uint32_t> Select(const SegmentQuery & query) const
+    {
+        if (this->CanSkip(query)) {
+            return {};
+        }
+
+        auto selected = std::vector<bool>(this->header.recordCount, true);
+        if (query.minLevel) {
+            const auto levels = this->Levels();
+            for (auto row = std::size_t(0); row < levels.size(); ++row) {
+                selected[row] = selected[row] && levels[row] >= *query.minLevel;
+            }
+        }
+        if (query.since || query.until) {
+            const auto times = this->Times();
+            for (auto row = std::size_t(0); row < times.size(); ++row) {
+                selected[row] = selected[row] && (!query.since || times[row] >= *query.since) &&
+                                (!query.until || times[row] < *query.until);
+            }
+        }
+        if (query.app && !this->matchDictionary(SegmentColumn::App, *query.app, selected)) {
+            return {};
+        }
+        if (query.module &&
+            !this->matchDictionary(SegmentColumn::Module, *query.module, selected)) {
+            return {};
+        }
+        if (query.contains) {
+            const auto messages = this->Messages();
+            for (auto row = std::size_t(0); row < selected.size(); ++row) {
+                selected[row] = selected[row] &&
+                                messages.At(row).find(*query.contains) != std::string_view::npos;
+            }
+        }
+
+        auto rows = std::vector<std::uint32_t>();
+        for (auto row = std::size_t(0); row < selected.size(); ++row) {
+            if (selected[row]) {
+                rows.push_back(static_cast<std::uint32_t>(row));
+            }
+        }
+        return rows;
+    }
+
+private:
+    /// @brief Default constructor, readers are opened with Open
+    ColumnarSegmentReader() = default;
+
+    /// @brief Reads the bytes of one column
+    std::string readColumn(SegmentColumn column) const
+    {
+        const auto & extent = this->header.columns[static_cast<std::size_t>(column)];
+        auto bytes = std::string(extent.size, '\0');
+        this->file.clear();
+        this->file.seekg(static_cast<std::streamoff>(extent.offset));
+        this->file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!this->file) {
+            throw std::runtime_error("kvalog: truncated segment file");
+        }
+        return bytes;
+    }
+
+    /// @brief Decodes a dictionary column
+    SegmentDictionary readDictionaryColumn(SegmentColumn column) const
+    {
+        const auto bytes = this->readColumn(column);
+        const auto * cursor = bytes.data();
+        const auto * end = bytes.data() + bytes.size();
+
+        auto dictionary = SegmentDictionary();
+        dictionary.values = SegmentEncoding::ReadDictionary(cursor, end);
+        dictionary.ids = SegmentEncoding::ReadIds(cursor, end, this->header.recordCount);
+        return dictionary;
+    }
+
+    /// @brief Deselects rows whose dictionary value differs, returns false when no record of
+    /// the segment can match
+    bool matchDictionary(SegmentColumn column, std::string_view value,
+                         std::vector<bool> & selected) const
+    {
+        const auto dictionary = this->readDictionaryColumn(column);
+        const auto position = std::find(dictionary.values.begin(), dictionary.values.end(), value);
+        if (position == dictionary.values.end()) {
+            return false;
+        }
+
+        const auto id = static_cast<std::uint32_t>(position - dictionary.values.begin());
+        for (auto row = std::size_t(0); row < selected.size(); ++row) {
+            selected[row] = selected[row] && dictionary.ids[row] == id;
+        }
+        return true;
+    }
+
+    /// [Properties]
+
+    /// @brief Segment file, read column by column
+    mutable std::ifstream file;
+    /// @brief Segment header
+    SegmentHeader header = SegmentHeader();
+};
+
+}  // namespace kvalog
@@ -0,0 +1,887 @@
+#pragma once
+
+#include "kvalog.hpp"
+
+#if defined(__linux__)
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace kvalog
+{
+
+/// @brief Socket type used by a socket adapter
+enum class SocketTransport {
+    Udp,
+    Tcp,
+    UnixStream,
+    UnixDatagram
+};
+
+/// @brief Framing of records on stream transports; datagrams always carry one record each
+enum class SocketFraming {
+    /// @brief Records are written as they are, text records already end with a line terminator
+    None,
+    /// @brief Each record is preceded by its length as a 4-byte big-endian integer
+    LengthPrefix,
+    /// @brief Each record is preceded by its length in decimal and a space (RFC 6587 syslog)
+    OctetCounting,
+    /// @brief Each record is followed by a NUL byte (GELF over TCP)
+    NullTerminated
+};
+
+/// @brief Default limit of bytes queued for sending
+inline constexpr std::size_t DefaultSocketQueueBytes = std::size_t(4) * 1024 * 1024;
+/// @brief Largest UDP payload over IPv4
+inline constexpr std::size_t MaxUdpPayload = 65507;
+/// @brief GELF chunk size recommended for UDP
+inline constexpr std::size_t DefaultGelfChunkSize = 8192;
+
+/// @brief Socket adapter configuration
+struct SocketOptions {
+    /// @brief Socket type
+    SocketTransport transport = SocketTransport::Tcp;
+    /// @brief Host name or address for UDP and TCP
+    std::string host = "127.0.0.1";
+    /// @brief Port for UDP and TCP
+    std::uint16_t port = 0;
+    /// @brief Socket path for Unix domain sockets
+    std::string path;
+    /// @brief Record framing on stream transports
+    SocketFraming framing = SocketFraming::None;
+    /// @brief Datagram size above which records are split into GELF chunks, zero to drop them
+    std::size_t gelfChunkSize = 0;
+    /// @brief Bytes queued for sending after which new records are dropped
+    std::size_t maxQueuedBytes = DefaultSocketQueueBytes;
+    /// @brief Time a connection attempt may take
+    std::chrono::milliseconds connectTimeout = std::chrono::milliseconds(1000);
+    /// @brief Delay before the first reconnect attempt, doubled after every failed attempt
+    std::chrono::milliseconds reconnectDelay = std::chrono::milliseconds(100);
+    /// @brief Upper bound of the reconnect delay
+    std::chrono::milliseconds maxReconnectDelay = std::chrono::milliseconds(10000);
+    /// @brief Time the adapter keeps sending queued records when it is destroyed
+    std::chrono::milliseconds closeTimeout = std::chrono::milliseconds(1000);
+    /// @brief Budget queued bytes are charged to; new records are dropped while it is exceeded
+    std::shared_ptr<MemoryBudget> memoryBudget = nullptr;
+
+    /// @brief Returns options for a UDP socket
+    static SocketOptions Udp(std::string host, std::uint16_t port)
+    {
+        return SocketOptions{ .transport = SocketTransport::Udp,
+                              .host = std::move(host),
+                              .port = port,
+                              .path = std::string() };
+    }
+
+    /// @brief Returns options for a TCP connection
+    static SocketOptions Tcp(std::string host, std::uint16_t port)
+    {
+        return SocketOptions{ .transport = SocketTransport::Tcp,
+                              .host = std::move(host),
+                              .port = port,
+                              .path = std::string() };
+    }
+
+    /// @brief Returns options for a Unix domain socket
+    static SocketOptions Unix(std::string path, bool datagram = false)
+    {
+        return SocketOptions{ .transport = datagram ? SocketTransport::UnixDatagram
+                                                    : SocketTransport::UnixStream,
+                              .path = std::move(path) };
+    }
+};
+
+/// @brief Counters of a socket adapter
+struct SocketStatistics {
+    /// @brief Records fully written to the socket, every GELF chunk counts as one
+    std::uint64_t sentRecords = 0;
+    /// @brief Bytes written to the socket, framing included
+    std::uint64_t sentBytes = 0;
+    /// @brief Records dropped: queue full, oversized datagram or lost with a connection
+    std::uint64_t droppedRecords = 0;
+    /// @brief Connections established
+    std::uint64_t connects = 0;
+};
+
+///
+/// @brief
+/// SocketNetworkAdapter sends records over UDP, TCP or Unix domain sockets.
+/// Logging threads only append to a queue; a sender thread waits on epoll, writes whatever has
+/// accumulated with one non-blocking send per wakeup, and reconnects with exponential backoff
+/// when the connection is lost.
+///
+class SocketNetworkAdapter : public INetworkSink
+{
+public:
+    /// [Fabric Methods]
+
+    /// @brief Creates a socket adapter with the given options
+    static std::shared_ptr<SocketNetworkAdapter> Create(const SocketOptions & options)
+    {
+        return std::make_shared<SocketNetworkAdapter>(options);
+    }
+
+    /// [Construction & Destruction]
+
+#pragma region SocketNetworkAdapter::Construct
+
+    /// @brief Copy constructor is deleted
+    SocketNetworkAdapter(const SocketNetworkAdapter &) = delete;
+    /// @brief Copy operator is deleted
+    SocketNetworkAdapter & operator=(const SocketNetworkAdapter &) = delete;
+
+    /// @brief Constructor with options, connects before returning and starts the sender thread
+    /// @warning Avoid using this constructor since class has static fabric methods
+    explicit SocketNetworkAdapter(const SocketOptions & initialOptions)
+        : options(initialOptions), reconnectDelay(initialOptions.reconnectDelay)
+    {
+        this->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (this->epollFd < 0) {
+            throw std::system_error(errno, std::generic_category(), "kvalog: epoll_create1");
+        }
+
+        this->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (this->wakeFd < 0) {
+            const auto error = errno;
+            close(this->epollFd);
+            throw std::system_error(error, std::generic_category(), "kvalog: eventfd");
+        }
+
+        auto event = epoll_event();
+        event.events = EPOLLIN;
+        event.data.fd = this->wakeFd;
+        epoll_ctl(this->epollFd, EPOLL_CTL_ADD, this->wakeFd, &event);
+
+        this->connectNow();
+        if (this->state == State::Connecting) {
+            auto pending = pollfd{ .fd = this->socketFd, .events = POLLOUT, .revents = 0 };
+            if (poll(&pending, 1, static_cast<int>(this->options.connectTimeout.count())) > 0) {
+                this->finishConnect();
+            }
+        }
+
+        this->sender = std::jthread([this](std::stop_token stopToken) { this->run(stopToken); });
+    }
+
+    /// @brief Destructor, sends what is queued within the close timeout and closes the socket
+    ~SocketNetworkAdapter() override
+    {
+        this->sender.request_stop();
+        this->wake();
+        this->sender.join();
+
+        this->closeSocket();
+        close(this->wakeFd);
+        close(this->epollFd);
+        if (this->options.memoryBudget) {
+            this->options.memoryBudget->ReleaseHeld(this->queued.size() + this->sending.size());
+        }
+    }
+
+#pragma endregion
+
+    /// [INetworkSink]
+
+    /// @brief Queues a record for sending
+    /// @note Records that do not fit in the queue, in a datagram or in the memory budget are
+    /// dropped and counted
+    void SendLog(const std::string & jsonLog) override
+    {
+        const auto & budget = this->options.memoryBudget;
+        if (budget && budget->Exceeded()) {
+            budget->CountDropped();
+            this->droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            const auto queuedBytes = this->queued.size();
+            if (!this->enqueue(jsonLog)) {
+                this->droppedRecords.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (budget) {
+                budget->Hold(this->queued.size() - queuedBytes);
+            }
+        }
+
+        if (!this->wakePending.exchange(true, std::memory_order_acq_rel)) {
+            this->wake();
+        }
+    }
+
+    /// @brief Returns whether the socket is connected
+    bool IsConnected() const override
+    {
+        return this->connected.load(std::memory_order_acquire);
+    }
+
+    /// @brief Returns the bytes queued for the sender thread, compared against maxQueuedBytes
+    std::size_t QueuedBytes() const
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        return this->queued.size();
+    }
+
+    /// [Statistics]
+
+    /// @brief Returns the adapter counters
+    SocketStatistics GetStatistics() const
+    {
+        return SocketStatistics{
+            .sentRecords = this->sentRecords.load(std::memory_order_relaxed),
+            .sentBytes = this->sentBytes.load(std::memory_order_relaxed),
+            .droppedRecords = this->droppedRecords.load(std::memory_order_relaxed),
+            .connects = this->connects.load(std::memory_order_relaxed),
+        };
+    }
+
+private:
+    /// @brief Connection state, owned by the sender thread
+    enum class State {
+        Disconnected,
+        Connecting,
+        Connected
+    };
+
+    /// @brief Largest number of datagrams handed to one sendmmsg call
+    static constexpr std::size_t MaxDatagramsPerSend = 64;
+    /// @brief Events collected per epoll_wait call
+    static constexpr int MaxEvents = 4;
+    /// @brief Size of the GELF chunk header
+    static constexpr std::size_t GelfChunkHeaderSize = 12;
+
+    /// [Framing]
+
+    /// @brief Appends a framed record, or its GELF chunks, to the queue
+    /// @return False when the record does not fit in the queue or in a datagram
+    /// @note Expects the queue mutex to be held
+    bool enqueue(std::string_view record)
+    {
+        if (this->isDatagram()) {
+            const auto limit =
+                this->options.gelfChunkSize > 0 ? this->options.gelfChunkSize : MaxUdpPayload;
+            if (record.size() > limit) {
+                return this->options.gelfChunkSize > GelfChunkHeaderSize &&
+                       this->enqueueChunks(record);
+            }
+            if (this->queued.size() + record.size() > this->options.maxQueuedBytes) {
+                return false;
+            }
+            this->queued.append(record);
+            this->queuedLengths.push_back(static_cast<std::uint32_t>(record.size()));
+            return true;
+        }
+
+        constexpr auto bitsPerByte = 8;
+        auto prefix = std::array<char, 24>();
+        auto prefixLength = std::size_t(0);
+        switch (this->options.framing) {
+            case SocketFraming::LengthPrefix:
+                for (auto index = std::size_t(0); index < sizeof(std::uint32_t); ++index) {
+                    const auto shift = (sizeof(std::uint32_t) - 1 - index) * bitsPerByte;
+                    prefix[index] = static_cast<char>((record.size() >> shift) & 0xff);
+                }
+                prefixLength = sizeof(std::uint32_t);
+                break;
+            case SocketFraming::OctetCounting: {
+                const auto end = fmt::format_to(prefix.data(), "{} ", record.size());
+                prefixLength = static_cast<std::size_t>(end - prefix.data());
+                break;
+            }
+            default:
+                break;
+        }
+        const auto suffixLength = this->options.framing == SocketFraming::NullTerminated ? 1 : 0;
+
+        const auto framed = prefixLength + record.size() + suffixLength;
+        if (this->queued.size() + framed > this->options.maxQueuedBytes) {
+            return false;
+        }
+        this->queued.append(prefix.data(), prefixLength);
+        this->queued.append(record);
+        if (suffixLength > 0) {
+            this->queued.push_back('\0');
+        }
+        this->queuedLengths.push_back(static_cast<std::uint32_t>(framed));
+        return true;
+    }
+
+    /// @brief Splits a record into GELF chunks: magic, 8-byte message id, sequence, count
+    bool enqueueChunks(std::string_view record)
+    {
+        constexpr auto maxChunks = std::size_t(128);
+        constexpr auto bitsPerByte = 8;
+
+        const auto payload = this->options.gelfChunkSize - GelfChunkHeaderSize;
+        const auto count = (record.size() + payload - 1) / payload;
+        const auto chunked = record.size() + count * GelfChunkHeaderSize;
+        if (count > maxChunks || this->queued.size() + chunked > this->options.maxQueuedBytes) {
+            return false;
+        }
+
+        const auto messageId = this->nextMessageId++;
+        for (auto sequence = std::size_t(0); sequence < count; ++sequence) {
+            const auto chunk = record.substr(sequence * payload, payload);
+            this->queued.push_back(static_cast<char>(0x1e));
+            this->queued.push_back(static_cast<char>(0x0f));
+            for (auto index = std::size_t(0); index < sizeof(messageId); ++index) {
+                const auto shift = (sizeof(messageId) - 1 - index) * bitsPerByte;
+                this->queued.push_back(static_cast<char>((messageId >> shift) & 0xff));
+            }
+            this->queued.push_back(static_cast<char>(sequence));
+            this->queued.push_back(static_cast<char>(count));
+            this->queued.append(chunk);
+            this->queuedLengths.push_back(
+                static_cast<std::uint32_t>(GelfChunkHeaderSize + chunk.size()));
+        }
+        return true;
+    }
+
+    /// [Sender Thread]
+
+    /// @brief Sender loop: connects, waits for queued records or socket readiness, and writes
+    void run(std::stop_token stopToken)
+    {
+        auto events = std::array<epoll_event, MaxEvents>();
+
+        while (!stopToken.stop_requested()) {
+            if (this->state == State::Disconnected &&
+                std::chrono::steady_clock::now() >= this->nextAttempt) {
+                this->connectNow();
+            }
+
+            const auto count = epoll_wait(this->epollFd, events.data(), MaxEvents,
+                                          this->waitTimeout());
+            for (auto index = 0; index < count; ++index) {
+                this->handleEvent(events[index]);
+            }
+
+            if (this->state == State::Connecting &&
+                std::chrono::steady_clock::now() >= this->connectDeadline) {
+                this->failAttempt();
+            }
+
+            if (this->state == State::Connected) {
+                this->wakePending.store(false, std::memory_order_release);
+                this->transmit();
+            }
+        }
+
+        this->drain();
+    }
+
+    /// @brief Keeps sending queued records until the queue is empty or the close timeout passes
+    void drain()
+    {
+        const auto deadline = std::chrono::steady_clock::now() + this->options.closeTimeout;
+        auto events = std::array<epoll_event, MaxEvents>();
+
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (this->state == State::Connected) {
+                this->transmit();
+            }
+            if (this->state != State::Connecting && (this->state != State::Connected ||
+                                                     !this->hasPendingOutput())) {
+                return;
+            }
+
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            const auto count = epoll_wait(this->epollFd, events.data(), MaxEvents,
+                                          static_cast<int>(std::max<std::int64_t>(
+                                              remaining.count(), 0)));
+            for (auto index = 0; index < count; ++index) {
+                this->handleEvent(events[index]);
+            }
+        }
+    }
+
+    /// @brief Returns the epoll timeout for the current state in milliseconds
+    int waitTimeout() const
+    {
+        const auto untilDeadline = [](std::chrono::steady_clock::time_point deadline) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            return static_cast<int>(std::max<std::int64_t>(remaining.count(), 0));
+        };
+
+        switch (this->state) {
+            case State::Disconnected:
+                return untilDeadline(this->nextAttempt);
+            case State::Connecting:
+                return untilDeadline(this->connectDeadline);
+            default:
+                return -1;
+        }
+    }
+
+    /// @brief Handles readiness of the wakeup eventfd or the socket
+    void handleEvent(const epoll_event & event)
+    {
+        if (event.data.fd == this->wakeFd) {
+            auto value = std::uint64_t(0);
+            [[maybe_unused]] const auto result = read(this->wakeFd, &value, sizeof(value));
+            return;
+        }
+
+        if (event.data.fd != this->socketFd) {
+            return;
+        }
+
+        if (this->state == State::Connecting) {
+            this->finishConnect();
+            return;
+        }
+
+        if ((event.events & EPOLLERR) != 0) {
+            // Datagram errors (an ICMP port unreachable) concern one datagram, not the socket
+            if (this->isDatagram()) {
+                this->takeSocketError();
+            } else {
+                this->disconnect();
+                return;
+            }
+        }
+
+        if ((event.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) != 0) {
+            this->drainInput();
+        }
+    }
+
+    /// @brief Reads and discards anything the peer sends, detecting a closed stream
+    void drainInput()
+    {
+        auto scratch = std::array<char, 512>();
+        while (this->socketFd >= 0) {
+            const auto received = recv(this->socketFd, scratch.data(), scratch.size(), 0);
+            if (received > 0) {
+                continue;
+            }
+            if (received == 0 && !this->isDatagram()) {
+                this->disconnect();
+                return;
+            }
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && !this->isDatagram()) {
+                this->disconnect();
+            }
+            return;
+        }
+    }
+
+    /// [Sending]
+
+    /// @brief Returns whether records are queued or partially sent
+    bool hasPendingOutput()
+    {
+        if (this->sendingIndex < this->sendingLengths.size()) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        return !this->queuedLengths.empty();
+    }
+
+    /// @brief Writes queued records until the queue is empty or the socket would block
+    void transmit()
+    {
+        while (this->state == State::Connected) {
+            if (this->sendingIndex == this->sendingLengths.size()) {
+                if (this->options.memoryBudget) {
+                    this->options.memoryBudget->ReleaseHeld(this->sending.size());
+                }
+                this->sending.clear();
+                this->sendingLengths.clear();
+                this->sendingOffset = 0;
+                this->sendingIndex = 0;
+                this->sendingRecordStart = 0;
+
+                std::lock_guard<std::mutex> lock(this->queueMutex);
+                this->sending.swap(this->queued);
+                this->sendingLengths.swap(this->queuedLengths);
+            }
+
+            if (this->sendingLengths.empty()) {
+                this->watchWritable(false);
+                return;
+            }
+
+            const auto blocked =
+                this->isDatagram() ? !this->sendDatagrams() : !this->sendStream();
+            if (blocked) {
+                if (this->state == State::Connected) {
+                    this->watchWritable(true);
+                }
+                return;
+            }
+        }
+    }
+
+    /// @brief Writes the pending bytes of a stream, returns false when the socket would block
+    bool sendStream()
+    {
+        while (this->sendingOffset < this->sending.size()) {
+            const auto written =
+                send(this->socketFd, this->sending.data() + this->sendingOffset,
+                     this->sending.size() - this->sendingOffset, MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    this->disconnect();
+                }
+                return false;
+            }
+
+            this->sendingOffset += static_cast<std::size_t>(written);
+            this->sentBytes.fetch_add(static_cast<std::uint64_t>(written),
+                                      std::memory_order_relaxed);
+            this->advanceSentRecords();
+        }
+        return true;
+    }
+
+    /// @brief Marks records whose bytes are all written as sent
+    void advanceSentRecords()
+    {
+        auto sent = std::uint64_t(0);
+        while (this->sendingIndex < this->sendingLengths.size() &&
+               this->sendingRecordStart + this->sendingLengths[this->sendingIndex] <=
+                   this->sendingOffset) {
+            this->sendingRecordStart += this->sendingLengths[this->sendingIndex];
+            this->sendingIndex += 1;
+            sent += 1;
+        }
+        if (this->sendingIndex == this->sendingLengths.size()) {
+            this->sendingRecordStart = 0;
+        }
+        this->sentRecords.fetch_add(sent, std::memory_order_relaxed);
+    }
+
+    /// @brief Sends pending datagrams in batches, returns false when the socket would block
+    bool sendDatagrams()
+    {
+        auto vectors = std::array<iovec, MaxDatagramsPerSend>();
+        auto messages = std::array<mmsghdr, MaxDatagramsPerSend>();
+
+        while (this->sendingIndex < this->sendingLengths.size()) {
+            auto batch = std::size_t(0);
+            auto offset = this->sendingOffset;
+            for (auto index = this->sendingIndex;
+                 index < this->sendingLengths.size() && batch < MaxDatagramsPerSend; ++index) {
+                vectors[batch] = iovec{ .iov_base = this->sending.data() + offset,
+                                        .iov_len = this->sendingLengths[index] };
+                messages[batch] = mmsghdr();
+                messages[batch].msg_hdr.msg_iov = &vectors[batch];
+                messages[batch].msg_hdr.msg_iovlen = 1;
+                offset += this->sendingLengths[index];
+                batch += 1;
+            }
+
+            const auto sent = sendmmsg(this->socketFd, messages.data(),
+                                       static_cast<unsigned int>(batch), 0);
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return false;
+                }
+                // Nobody is listening or the datagram was refused: drop it and carry on
+                this->droppedRecords.fetch_add(1, std::memory_order_relaxed);
+                this->sendingOffset += this->sendingLengths[this->sendingIndex];
+                this->sendingIndex += 1;
+                continue;
+            }
+
+            for (auto index = 0; index < sent; ++index) {
+                this->sendingOffset += this->sendingLengths[this->sendingIndex];
+                this->sentBytes.fetch_add(this->sendingLengths[this->sendingIndex],
+                                          std::memory_order_relaxed);
+                this->sendingIndex += 1;
+            }
+            this->sentRecords.fetch_add(static_cast<std::uint64_t>(sent),
+                                        std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /// [Connection]
+
+    /// @brief Opens a non-blocking socket and starts connecting it
+    void connectNow()
+    {
+        this->closeSocket();
+
+        auto address = sockaddr_storage();
+        auto addressLength = socklen_t(0);
+        if (!this->resolve(address, addressLength)) {
+            this->failAttempt();
+            return;
+        }
+
+        this->socketFd =
+            socket(address.ss_family, this->socketType() | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (this->socketFd < 0) {
+            this->failAttempt();
+            return;
+        }
+
+        if (this->options.transport == SocketTransport::Tcp) {
+            // Records are already coalesced per send, Nagle would only add latency
+            const auto enabled = 1;
+            setsockopt(this->socketFd, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+        }
+
+        auto event = epoll_event();
+        event.events = EPOLLOUT | EPOLLIN | EPOLLRDHUP;
+        event.data.fd = this->socketFd;
+        epoll_ctl(this->epollFd, EPOLL_CTL_ADD, this->socketFd, &event);
+        this->watchedEvents = event.events;
+
+        if (connect(this->socketFd, reinterpret_cast<const sockaddr *>(&address), addressLength) ==
+            0) {
+            this->onConnected();
+            return;
+        }
+
+        if (errno == EINPROGRESS) {
+            this->state = State::Connecting;
+            this->connectDeadline = std::chrono::steady_clock::now() + this->options.connectTimeout;
+            return;
+        }
+
+        this->failAttempt();
+    }
+
+    /// @brief Completes a pending connection attempt
+    void finishConnect()
+    {
+        if (this->takeSocketError() == 0) {
+            this->onConnected();
+        } else {
+            this->failAttempt();
+        }
+    }
+
+    /// @brief Marks the socket connected and resets the reconnect delay
+    void onConnected()
+    {
+        this->state = State::Connected;
+        this->reconnectDelay = this->options.reconnectDelay;
+        this->connects.fetch_add(1, std::memory_order_relaxed);
+        this->connected.store(true, std::memory_order_release);
+        this->watchWritable(false);
+    }
+
+    /// @brief Closes the socket after a failed attempt and schedules the next one
+    void failAttempt()
+    {
+        this->closeSocket();
+        this->nextAttempt = std::chrono::steady_clock::now() + this->reconnectDelay;
+        this->reconnectDelay = std::min(this->reconnectDelay * 2, this->options.maxReconnectDelay);
+    }
+
+    /// @brief Closes a broken connection and schedules an immediate reconnect
+    /// @note A record cut off mid-write is dropped, records not yet started are kept
+    void disconnect()
+    {
+        if (this->sendingIndex < this->sendingLengths.size() &&
+            this->sendingOffset > this->sendingRecordStart) {
+            this->sendingOffset =
+                this->sendingRecordStart + this->sendingLengths[this->sendingIndex];
+            this->sendingRecordStart = this->sendingOffset;
+            this->sendingIndex += 1;
+            this->droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        this->closeSocket();
+        this->nextAttempt = std::chrono::steady_clock::now();
+    }
+
+    /// @brief Closes the socket and marks the adapter disconnected
+    void closeSocket()
+    {
+        if (this->socketFd >= 0) {
+            epoll_ctl(this->epollFd, EPOLL_CTL_DEL, this->socketFd, nullptr);
+            close(this->socketFd);
+            this->socketFd = -1;
+        }
+        this->state = State::Disconnected;
+        this->connected.store(false, std::memory_order_release);
+    }
+
+    /// @brief Enables or disables writability notifications for the socket
+    void watchWritable(bool enabled)
+    {
+        const auto events = static_cast<std::uint32_t>(EPOLLIN | EPOLLRDHUP) |
+                            (enabled ? static_cast<std::uint32_t>(EPOLLOUT) : 0U);
+        if (this->socketFd < 0 || events == this->watchedEvents) {
+            return;
+        }
+
+        auto event = epoll_event();
+        event.events = events;
+        event.data.fd = this->socketFd;
+        epoll_ctl(this->epollFd, EPOLL_CTL_MOD, this->socketFd, &event);
+        this->watchedEvents = events;
+    }
+
+    /// @brief Reads and clears the pending socket error
+    int takeSocketError()
+    {
+        auto error = 0;
+        auto length = socklen_t(sizeof(error));
+        if (getsockopt(this->socketFd, SOL_SOCKET, SO_ERROR, &error, &length) != 0) {
+            return errno;
+        }
+        return error;
+    }
+
+    /// @brief Resolves the configured destination
+    bool resolve(sockaddr_storage & address, socklen_t & addressLength) const
+    {
+        if (this->isUnix()) {
+            auto unixAddress = sockaddr_un();
+            if (this->options.path.size() >= sizeof(unixAddress.sun_path)) {
+                return false;
+            }
+            unixAddress.sun_family = AF_UNIX;
+            std::memcpy(unixAddress.sun_path, this->options.path.c_str(),
+                        this->options.path.size() + 1);
+            std::memcpy(&address, &unixAddress, sizeof(unixAddress));
+            addressLength = sizeof(unixAddress);
+            return true;
+        }
+
+        auto hints = addrinfo();
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = this->socketType();
+        auto * results = static_cast<addrinfo *>(nullptr);
+        const auto port = std::to_string(this->options.port);
+        if (getaddrinfo(this->options.host.c_str(), port.c_str(), &hints, &results) != 0 ||
+            results == nullptr) {
+            return false;
+        }
+
+        std::memcpy(&address, results->ai_addr, results->ai_addrlen);
+        addressLength = results->ai_addrlen;
+        freeaddrinfo(results);
+        return true;
+    }
+
+    /// @brief Returns the socket type of the configured transport
+    int socketType() const
+    {
+        return this->isDatagram() ? SOCK_DGRAM : SOCK_STREAM;
+    }
+
+    /// @brief Returns whether the transport sends datagrams
+    bool isDatagram() const
+    {
+        return this->options.transport == SocketTransport::Udp ||
+               this->options.transport == SocketTransport::UnixDatagram;
+    }
+
+    /// @brief Returns whether the transport is a Unix domain socket
+    bool isUnix() const
+    {
+        return this->options.transport == SocketTransport::UnixStream ||
+               this->options.transport == SocketTransport::UnixDatagram;
+    }
+
+    /// @brief Wakes the sender thread
+    void wake()
+    {
+        const auto value = std::uint64_t(1);
+        [[maybe_unused]] const auto result = write(this->wakeFd, &value, sizeof(value));
+    }
+
+    /// [Properties]
+
+    /// @brief Adapter options
+    SocketOptions options;
+
+    /// @brief Guards the queue shared by logging threads and the sender thread
+    mutable std::mutex queueMutex;
+    /// @brief Framed records waiting for the sender thread
+    std::string queued;
+    /// @brief Framed length of every queued record
+    std::vector<std::uint32_t> queuedLengths;
+    /// @brief Identifier of the next chunked GELF message
+    std::uint64_t nextMessageId = std::random_device()() |
+                                  (static_cast<std::uint64_t>(std::random_device()()) << 32);
+    /// @brief Whether a wakeup is already signalled and not yet consumed
+    std::atomic<bool> wakePending = false;
+
+    /// @brief Records being sent, owned by the sender thread
+    std::string sending;
+    /// @brief Framed length of every record being sent
+    std::vector<std::uint32_t> sendingLengths;
+    /// @brief Bytes of the records being sent that are written
+    std::size_t sendingOffset = 0;
+    /// @brief Index of the first record not fully written
+    std::size_t sendingIndex = 0;
+    /// @brief Offset at which the first record not fully written starts
+    std::size_t sendingRecordStart = 0;
+
+    /// @brief Socket, -1 while disconnected
+    int socketFd = -1;
+    /// @brief epoll instance of the sender thread
+    int epollFd = -1;
+    /// @brief eventfd waking the sender thread
+    int wakeFd = -1;
+    /// @brief Events currently watched on the socket
+    std::uint32_t watchedEvents = 0;
+    /// @brief Connection state
+    State state = State::Disconnected;
+    /// @brief Connection state as seen by logging threads
+    std::atomic<bool> connected = false;
+    /// @brief Delay before the next reconnect attempt
+    std::chrono::milliseconds reconnectDelay;
+    /// @brief Time of the next connection attempt
+    std::chrono::steady_clock::time_point nextAttempt = std::chrono::steady_clock::time_point();
+    /// @brief Time a pending connection attempt fails
+    std::chrono::steady_clock::time_point connectDeadline =
+        std::chrono::steady_clock::time_point();
+
+    /// @brief Counters
+    std::atomic<std::uint64_t> sentRecords = 0;
+    std::atomic<std::uint64_t> sentBytes = 0;
+    std::atomic<std::uint64_t> droppedRecords = 0;
+    std::atomic<std::uint64_t> connects = 0;
+
+    /// @brief Sender thread, started last and stopped first
+    std::jthread sender;
+};
+
+}  // namespace kvalog
+
+#endif
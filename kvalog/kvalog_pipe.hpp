@@ -0,0 +1,369 @@
+#pragma once
+
+#include "kvalog.hpp"
+
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace kvalog
+{
+
+/// @brief Default size of one staging buffer
+inline constexpr std::size_t DefaultPipeBufferSize = std::size_t(64) * 1024;
+
+/// @brief Pipe adapter configuration
+struct PipeOptions {
+    /// @brief FIFO to open for writing; ignored when fd is set
+    std::string path = std::string();
+    /// @brief Already open pipe write end, not closed by the adapter; -1 to open path
+    int fd = -1;
+    /// @brief Size of one staging buffer, rounded up to whole pages
+    std::size_t bufferSize = DefaultPipeBufferSize;
+    /// @brief Pipe capacity to request with F_SETPIPE_SZ, zero to keep the current one
+    std::size_t pipeSize = 0;
+    /// @brief Delay between attempts to reopen a FIFO whose reader went away
+    std::chrono::milliseconds reopenDelay = std::chrono::milliseconds(100);
+    /// @brief Back the staging area with huge pages, falling back to base pages
+    bool hugePages = false;
+};
+
+///
+/// @brief
+/// PipeAdapter writes records into a pipe or FIFO with vmsplice, so the kernel references the
+/// staged pages instead of copying them into the pipe.
+/// Records are copied once into page-aligned staging buffers used round-robin, and a buffer is
+/// spliced whole once the next record does not fit in it, or on flush. The pipe keeps
+/// referencing a buffer after vmsplice returns, so a buffer is only reused once the reader has
+/// consumed everything spliced from it, as told by FIONREAD. The staging area holds the pipe
+/// capacity plus one buffer, so waiting is rare. Records larger than a buffer fall back to write.
+/// @note Threads sending to the pipe keep SIGPIPE blocked from their first record on, so a
+/// vanished reader shows up as EPIPE only
+/// @warning A reader that splices onward to a socket or tees the pipe may keep referencing pages
+/// after consuming them, such readers must copy
+///
+class PipeAdapter : public INetworkSink
+{
+public:
+    /// [Fabric Methods]
+
+    /// @brief Creates a pipe adapter with the given options
+    static std::shared_ptr<PipeAdapter> Create(const PipeOptions & options)
+    {
+        return std::make_shared<PipeAdapter>(options);
+    }
+
+    /// [Construction & Destruction]
+
+#pragma region PipeAdapter::Construct
+
+    /// @brief Copy constructor is deleted
+    PipeAdapter(const PipeAdapter &) = delete;
+    /// @brief Copy operator is deleted
+    PipeAdapter & operator=(const PipeAdapter &) = delete;
+
+    /// @brief Constructor with options
+    /// @throws std::invalid_argument when the descriptor is not a pipe
+    /// @throws std::bad_alloc when the staging area cannot be mapped
+    /// @warning Avoid using this constructor since class has static fabric methods
+    explicit PipeAdapter(const PipeOptions & initialOptions) : options(initialOptions)
+    {
+        const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        this->bufferSize = (this->options.bufferSize + pageSize - 1) / pageSize * pageSize;
+
+        if (this->options.fd >= 0) {
+            struct stat status = {};
+            if (fstat(this->options.fd, &status) != 0 || !S_ISFIFO(status.st_mode)) {
+                throw std::invalid_argument("kvalog: pipe adapter needs a pipe or FIFO");
+            }
+            this->pipeFd = this->options.fd;
+            this->connected.store(true, std::memory_order_release);
+        } else {
+            this->reopen();
+        }
+        // Without a FIFO reader the capacity is unknown yet, size for the largest pipe
+        const auto capacity =
+            this->pipeFd >= 0 ? this->resizePipe() : PipeAdapter::maxPipeSize();
+
+        // Staging covers a full pipe plus the buffer being filled, so reuse rarely waits
+        this->bufferCount = (capacity + this->bufferSize - 1) / this->bufferSize + 1;
+        this->stagingSize = this->bufferCount * this->bufferSize;
+        this->bufferEnds.assign(this->bufferCount, 0);
+        this->stagingMemory = PageMemory(this->stagingSize, this->options.hugePages, -1);
+        this->staging = static_cast<char *>(this->stagingMemory.Data());
+    }
+
+    /// @brief Destructor, splices the staged records, closes an opened FIFO and unmaps the
+    /// staging buffers
+    ~PipeAdapter() override
+    {
+        this->Flush();
+        if (this->pipeFd >= 0 && this->options.fd < 0) {
+            close(this->pipeFd);
+        }
+    }
+
+#pragma endregion
+
+    /// [INetworkSink]
+
+    /// @brief Stages a record, splicing the buffer being filled into the pipe once the record
+    /// does not fit in it
+    /// @note A FIFO whose reader went away is reopened here after the reopen delay; records
+    /// sent while it has no reader are dropped
+    void SendLog(const std::string & jsonLog) override
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->connected.load(std::memory_order_acquire)) {
+            if (!this->reopenDue()) {
+                return;
+            }
+            this->reopen();
+            if (!this->connected.load(std::memory_order_acquire)) {
+                return;
+            }
+        }
+
+        if (jsonLog.size() > this->bufferSize) {
+            this->spliceStaged();
+            this->writeAll(jsonLog);
+            return;
+        }
+
+        if (this->bufferOffset + jsonLog.size() > this->bufferSize) {
+            this->spliceStaged();
+            this->bufferIndex = (this->bufferIndex + 1) % this->bufferCount;
+            this->bufferOffset = 0;
+            this->splicedOffset = 0;
+            this->waitConsumed(this->bufferEnds[this->bufferIndex]);
+        }
+
+        auto * staged = this->staging + this->bufferIndex * this->bufferSize + this->bufferOffset;
+        std::memcpy(staged, jsonLog.data(), jsonLog.size());
+        this->bufferOffset += jsonLog.size();
+    }
+
+    /// @brief Returns whether the pipe has a reader, or a FIFO reopen attempt is due
+    bool IsConnected() const override
+    {
+        return this->connected.load(std::memory_order_acquire) || this->reopenDue();
+    }
+
+    /// @brief Splices the records staged so far into the pipe
+    void Flush() override
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->connected.load(std::memory_order_acquire)) {
+            this->spliceStaged();
+        }
+    }
+
+private:
+    /// [Pipe]
+
+    /// @brief Returns whether a FIFO without a reader may be reopened
+    bool reopenDue() const
+    {
+        return this->options.fd < 0 && !this->options.path.empty() &&
+               std::chrono::steady_clock::now() >=
+                   this->nextReopen.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Opens the FIFO without waiting for a reader
+    /// @note Records staged but not yet spliced go to the new reader
+    void reopen()
+    {
+        if (this->pipeFd >= 0) {
+            close(this->pipeFd);
+            this->pipeFd = -1;
+        }
+
+        // A non-blocking open fails with ENXIO instead of waiting when no reader is present
+        this->pipeFd = open(this->options.path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if (this->pipeFd < 0) {
+            this->disconnect();
+            return;
+        }
+        fcntl(this->pipeFd, F_SETFL, fcntl(this->pipeFd, F_GETFL) & ~O_NONBLOCK);
+        this->resizePipe();
+
+        // The previous pipe went away with its reader, nothing references the staging anymore
+        this->streamBytes = 0;
+        this->bufferEnds.assign(this->bufferCount, 0);
+        this->connected.store(true, std::memory_order_release);
+    }
+
+    /// @brief Applies the requested pipe size and returns the pipe capacity
+    std::size_t resizePipe()
+    {
+        if (this->options.pipeSize > 0) {
+            fcntl(this->pipeFd, F_SETPIPE_SZ, static_cast<int>(this->options.pipeSize));
+        }
+        const auto capacity = fcntl(this->pipeFd, F_GETPIPE_SZ);
+        return capacity > 0 ? static_cast<std::size_t>(capacity) : PipeAdapter::maxPipeSize();
+    }
+
+    /// @brief Waits until the reader consumed the stream up to the given offset
+    void waitConsumed(std::uint64_t offset)
+    {
+        auto unread = 0;
+        while (this->connected.load(std::memory_order_acquire) &&
+               ioctl(this->pipeFd, FIONREAD, &unread) == 0 &&
+               this->streamBytes - static_cast<std::uint64_t>(unread) < offset) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    /// @brief Returns the largest pipe size an unprivileged process can set
+    static std::size_t maxPipeSize()
+    {
+        constexpr auto fallback = std::size_t(1024) * 1024;
+        auto * file = std::fopen("/proc/sys/fs/pipe-max-size", "r");
+        auto size = 0UL;
+        if (file != nullptr) {
+            if (std::fscanf(file, "%lu", &size) != 1) {
+                size = 0;
+            }
+            std::fclose(file);
+        }
+        return size > 0 ? static_cast<std::size_t>(size) : fallback;
+    }
+
+    /// @brief Hands the staged bytes not spliced yet to the pipe in one vmsplice, continuing
+    /// after partial splices
+    void spliceStaged()
+    {
+        auto * data = this->staging + this->bufferIndex * this->bufferSize + this->splicedOffset;
+        auto length = this->bufferOffset - this->splicedOffset;
+        if (length == 0) {
+            return;
+        }
+        // Bytes left when the reader goes away are dropped rather than sent half to the next one
+        this->splicedOffset = this->bufferOffset;
+
+        PipeAdapter::blockSigpipe();
+        while (length > 0) {
+            auto vector = iovec{ .iov_base = data, .iov_len = length };
+            const auto spliced = vmsplice(this->pipeFd, &vector, 1, 0);
+            if (spliced < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                PipeAdapter::discardSigpipe();
+                this->disconnect();
+                return;
+            }
+            data += spliced;
+            length -= static_cast<std::size_t>(spliced);
+            this->streamBytes += static_cast<std::uint64_t>(spliced);
+        }
+        this->bufferEnds[this->bufferIndex] = this->streamBytes;
+    }
+
+    /// @brief Copies bytes into the pipe, used for records larger than a staging buffer
+    void writeAll(std::string_view data)
+    {
+        PipeAdapter::blockSigpipe();
+        while (!data.empty()) {
+            const auto written = write(this->pipeFd, data.data(), data.size());
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                PipeAdapter::discardSigpipe();
+                this->disconnect();
+                return;
+            }
+            data.remove_prefix(static_cast<std::size_t>(written));
+            this->streamBytes += static_cast<std::uint64_t>(written);
+        }
+    }
+
+    /// @brief Marks the pipe disconnected after its reader went away
+    void disconnect()
+    {
+        this->connected.store(false, std::memory_order_release);
+        this->nextReopen.store(std::chrono::steady_clock::now() + this->options.reopenDelay,
+                               std::memory_order_relaxed);
+    }
+
+    /// @brief Blocks SIGPIPE on the calling thread, once per thread
+    static void blockSigpipe()
+    {
+        thread_local const auto blocked = [] {
+            auto pipeSignal = sigset_t();
+            sigemptyset(&pipeSignal);
+            sigaddset(&pipeSignal, SIGPIPE);
+            return pthread_sigmask(SIG_BLOCK, &pipeSignal, nullptr) == 0;
+        }();
+        static_cast<void>(blocked);
+    }
+
+    /// @brief Discards the SIGPIPE a failed write left pending on the calling thread
+    static void discardSigpipe()
+    {
+        auto pipeSignal = sigset_t();
+        sigemptyset(&pipeSignal);
+        sigaddset(&pipeSignal, SIGPIPE);
+        const auto immediately = timespec{ .tv_sec = 0, .tv_nsec = 0 };
+        sigtimedwait(&pipeSignal, nullptr, &immediately);
+    }
+
+    /// [Properties]
+
+    /// @brief Adapter options
+    PipeOptions options;
+    /// @brief Guards the staging buffers and the descriptor
+    std::mutex mutex;
+    /// @brief Pipe write end, -1 while a FIFO has no reader
+    int pipeFd = -1;
+    /// @brief Whether the pipe has a reader
+    std::atomic<bool> connected = false;
+    /// @brief Time of the next FIFO reopen attempt
+    std::atomic<std::chrono::steady_clock::time_point> nextReopen =
+        std::chrono::steady_clock::time_point();
+
+    /// @brief Page-aligned staging area
+    PageMemory stagingMemory;
+    char * staging = nullptr;
+    /// @brief Size of the staging area
+    std::size_t stagingSize = 0;
+    /// @brief Size of one staging buffer
+    std::size_t bufferSize = 0;
+    /// @brief Number of staging buffers
+    std::size_t bufferCount = 0;
+    /// @brief Buffer being filled
+    std::size_t bufferIndex = 0;
+    /// @brief Bytes staged in the buffer being filled
+    std::size_t bufferOffset = 0;
+    /// @brief Bytes of the buffer being filled already handed to the pipe
+    std::size_t splicedOffset = 0;
+    /// @brief Stream offset just past the last byte spliced from each buffer
+    std::vector<std::uint64_t> bufferEnds;
+    /// @brief Bytes handed to the current pipe so far
+    std::uint64_t streamBytes = 0;
+};
+
+}  // namespace kvalog
+
+#endif
@@ -0,0 +1,790 @@
+#pragma once
+
+#include "kvalog.hpp"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace kvalog
+{
+
+/// @brief Byte range of a log file
+struct FileRange {
+    std::uint64_t offset = 0;
+    std::uint64_t length = 0;
+};
+
+/// @brief Block filter evaluated against a log file index; unset members match everything
+struct FileIndexQuery {
+    std::optional<LogLevel> minLevel = std::nullopt;
+    std::optional<std::string> module = std::nullopt;
+    /// @brief Inclusive lower time bound in nanoseconds since the Unix epoch
+    std::optional<std::int64_t> since = std::nullopt;
+    /// @brief Exclusive upper time bound in nanoseconds since the Unix epoch
+    std::optional<std::int64_t> until = std::nullopt;
+};
+
+///
+/// @brief
+/// LogFileIndex reads the sparse index written next to a log file by IndexedFileSink and tells
+/// which byte ranges of the log file can hold records matching a query. Blocks are found by
+/// binary search on their times; the records behind the last indexed block, not yet covered
+/// by the index, are always part of the result.
+///
+class LogFileIndex
+{
+public:
+    /// [Construction & Destruction]
+
+#pragma region LogFileIndex::Construct
+
+    /// @brief Copy constructor is deleted
+    LogFileIndex(const LogFileIndex &) = delete;
+    /// @brief Copy operator is deleted
+    LogFileIndex & operator=(const LogFileIndex &) = delete;
+
+    /// @brief Reads the index of a log file
+    /// @note An entry cut short by a crash ends the index, its records count as unindexed
+    /// @throws std::runtime_error when the index is missing or is not a log file index
+    static std::unique_ptr<LogFileIndex> Open(const std::filesystem::path & logPath)
+    {
+        auto indexPath = logPath;
+        indexPath += FileIndexExtension;
+        auto input = std::ifstream(indexPath, std::ios::binary);
+        auto header = FileIndexHeader();
+        input.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!input || header.magic != FileIndexHeader::Magic ||
+            header.version != FileIndexHeader::Version) {
+            throw std::runtime_error("kvalog: not a log file index: " + indexPath.string());
+        }
+
+        auto index = std::unique_ptr<LogFileIndex>(new LogFileIndex());
+        index->logPath = logPath;
+        index->blockSize = header.blockSize;
+
+        // A torn entry may claim any size, so no payload may reach past the end of the index
+        const auto entriesStart = input.tellg();
+        input.seekg(0, std::ios::end);
+        const auto indexEnd = input.tellg();
+        input.seekg(entriesStart);
+
+        auto entry = FileIndexEntry();
+        auto payload = std::string();
+        while (input.read(reinterpret_cast<char *>(&entry), sizeof(entry))) {
+            if (entry.size > static_cast<std::uint64_t>(indexEnd - input.tellg())) {
+                break;
+            }
+            payload.resize(entry.size);
+            if (!input.read(payload.data(), static_cast<std::streamsize>(payload.size()))) {
+                break;
+            }
+            index->addEntry(entry.kind, payload);
+        }
+        index->buildSearchBounds();
+        return index;
+    }
+
+#pragma endregion
+
+    /// [Index]
+
+    /// @brief Returns the indexed blocks in file order
+    const std::vector<FileIndexBlock> & Blocks() const
+    {
+        return this->blocks;
+    }
+
+    /// @brief Returns the module names by module id
+    const std::vector<std::string> & Modules() const
+    {
+        return this->modules;
+    }
+
+    /// @brief Returns the configured bytes of log per block
+    std::uint32_t BlockSize() const
+    {
+        return this->blockSize;
+    }
+
+    /// [Queries]
+
+    /// @brief Returns the byte ranges that can hold matching records, adjacent ranges merged
+    std::vector<FileRange> Ranges(const FileIndexQuery & query) const
+    {
+        // Running maxima of maxTime only grow, suffix minima of minTime too
+        auto first = std::size_t(0);
+        if (query.since) {
+            first = static_cast<std::size_t>(
+                std::lower_bound(this->maxTimeBefore.begin(), this->maxTimeBefore.end(),
+                                 *query.since) -
+                this->maxTimeBefore.begin());
+        }
+        auto last = this->blocks.size();
+        if (query.until) {
+            last = static_cast<std::size_t>(
+                std::lower_bound(this->minTimeAfter.begin(), this->minTimeAfter.end(),
+                                 *query.until) -
+                this->minTimeAfter.begin());
+        }
+
+        const auto levelMask = query.minLevel
+                                   ? ~((1U << static_cast<unsigned>(*query.minLevel)) - 1)
+                                   : ~0U;
+        const auto moduleMask = query.module ? this->moduleMask(*query.module) : ~0ULL;
+
+        auto ranges = std::vector<FileRange>();
+        const auto add = [&ranges](std::uint64_t offset, std::uint64_t length) {
+            if (!ranges.empty() && ranges.back().offset + ranges.back().length == offset) {
+                ranges.back().length += length;
+            } else {
+                ranges.push_back(FileRange{ .offset = offset, .length = length });
+            }
+        };
+
+        for (auto position = first; position < last; ++position) {
+            const auto & block = this->blocks[position];
+            const auto overlaps = (!query.since || block.maxTime >= *query.since) &&
+                                  (!query.until || block.minTime < *query.until);
+            if (overlaps && (block.levelMask & levelMask) != 0 &&
+                (block.moduleMask & moduleMask) != 0) {
+                add(block.offset, block.length);
+            }
+        }
+
+        const auto indexed =
+            this->blocks.empty() ? 0 : this->blocks.back().offset + this->blocks.back().length;
+        auto error = std::error_code();
+        const auto fileSize = std::filesystem::file_size(this->logPath, error);
+        if (!error && fileSize > indexed) {
+            add(indexed, fileSize - indexed);
+        }
+        return ranges;
+    }
+
+    /// @brief Calls the handler with every line of the log file within the ranges
+    template <typename Handler>
+    void ForEachLine(const std::vector<FileRange> & ranges, Handler && handler) const
+    {
+        auto input = std::ifstream(this->logPath, std::ios::binary);
+        auto buffer = std::string();
+        for (const auto & range : ranges) {
+            buffer.resize(range.length);
+            input.clear();
+            input.seekg(static_cast<std::streamoff>(range.offset));
+            input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.resize(static_cast<std::size_t>(input.gcount()));
+
+            auto text = std::string_view(buffer);
+            while (!text.empty()) {
+                const auto end = text.find('\n');
+                handler(text.substr(0, end));
+                text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+            }
+        }
+    }
+
+private:
+    /// @brief Default constructor, indexes are read with Open
+    LogFileIndex() = default;
+
+    /// @brief Adds a decoded index entry
+    void addEntry(FileIndexEntryKind kind, const std::string & payload)
+    {
+        if (kind == FileIndexEntryKind::Block && payload.size() >= sizeof(FileIndexBlock)) {
+            auto block = FileIndexBlock();
+            std::memcpy(&block, payload.data(), sizeof(block));
+            this->blocks.push_back(block);
+        } else if (kind == FileIndexEntryKind::Module && payload.size() >= sizeof(std::uint32_t)) {
+            auto id = std::uint32_t(0);
+            std::memcpy(&id, payload.data(), sizeof(id));
+            this->modules.resize(std::max<std::size_t>(this->modules.size(), id + 1));
+            this->modules[id] = payload.substr(sizeof(id));
+        }
+    }
+
+    /// @brief Builds the monotonic time bounds searched by Ranges
+    void buildSearchBounds()
+    {
+        this->maxTimeBefore.resize(this->blocks.size());
+        this->minTimeAfter.resize(this->blocks.size());
+        auto maximum = std::numeric_limits<std::int64_t>::min();
+        for (auto position = std::size_t(0); position < this->blocks.size(); ++position) {
+            maximum = std::max(maximum, this->blocks[position].maxTime);
+            this->maxTimeBefore[position] = maximum;
+        }
+        auto minimum = std::numeric_limits<std::int64_t>::max();
+        for (auto position = this->blocks.size(); position-- > 0;) {
+            minimum = std::min(minimum, this->blocks[position].minTime);
+            this->minTimeAfter[position] = minimum;
+        }
+    }
+
+    /// @brief Returns the module bits that can stand for the module
+    std::uint64_t moduleMask(std::string_view module) const
+    {
+        constexpr auto lastBit = std::size_t(63);
+        const auto position = std::find(this->modules.begin(), this->modules.end(), module);
+        if (position == this->modules.end()) {
+            return 0;
+        }
+        const auto id = static_cast<std::size_t>(position - this->modules.begin());
+        return std::uint64_t(1) << std::min(id, lastBit);
+    }
+
+    /// [Properties]
+
+    /// @brief Path of the indexed log file
+    std::filesystem::path logPath;
+    /// @brief Configured bytes of log per block
+    std::uint32_t blockSize = 0;
+    /// @brief Indexed blocks in file order
+    std::vector<FileIndexBlock> blocks;
+    /// @brief Module names by module id
+    std::vector<std::string> modules;
+    /// @brief Largest maxTime of the blocks up to each position
+    std::vector<std::int64_t> maxTimeBefore;
+    /// @brief Smallest minTime of the blocks from each position on
+    std::vector<std::int64_t> minTimeAfter;
+};
+
+#if defined(__linux__)
+
+///
+/// @brief
+/// MappedFile maps a whole file read-only for sequential scanning
+///
+class MappedFile
+{
+public:
+    /// [Construction & Destruction]
+
+#pragma region MappedFile::Construct
+
+    /// @brief Copy constructor is deleted
+    MappedFile(const MappedFile &) = delete;
+    /// @brief Copy operator is deleted
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    /// @brief Maps a file
+    /// @throws std::system_error when the file cannot be opened or mapped
+    static std::unique_ptr<MappedFile> Open(const std::filesystem::path & path)
+    {
+        auto mapped = std::unique_ptr<MappedFile>(new MappedFile());
+        const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), path.string());
+        }
+
+        struct stat status = {};
+        fstat(fd, &status);
+        mapped->size = static_cast<std::size_t>(status.st_size);
+        if (mapped->size > 0) {
+            auto * mapping = mmap(nullptr, mapped->size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                const auto error = errno;
+                close(fd);
+                throw std::system_error(error, std::generic_category(), path.string());
+            }
+            mapped->data = static_cast<const char *>(mapping);
+            madvise(mapping, mapped->size, MADV_SEQUENTIAL | MADV_WILLNEED);
+        }
+        close(fd);
+        return mapped;
+    }
+
+    /// @brief Destructor, unmaps the file
+    ~MappedFile()
+    {
+        if (this->data != nullptr) {
+            munmap(const_cast<char *>(this->data), this->size);
+        }
+    }
+
+#pragma endregion
+
+    /// @brief Returns the mapped bytes within a range, clamped to the file
+    std::string_view View(std::uint64_t offset = 0,
+                          std::uint64_t length = std::numeric_limits<std::uint64_t>::max()) const
+    {
+        if (offset >= this->size) {
+            return {};
+        }
+        return std::string_view(this->data + offset,
+                                static_cast<std::size_t>(std::min(length, this->size - offset)));
+    }
+
+private:
+    /// @brief Default constructor, files are mapped with Open
+    MappedFile() = default;
+
+    /// @brief Mapped bytes
+    const char * data = nullptr;
+    /// @brief File size
+    std::size_t size = 0;
+};
+
+#endif
+
+/// @brief Line splitting and field lookup on kvalog text records
+namespace TextScan
+{
+
+/// @brief Returns the first newline in [begin, end), or end
+inline const char * FindNewline(const char * begin, const char * end)
+{
+#if defined(__AVX2__)
+    const auto newline = _mm256_set1_epi8('\n');
+    for (; end - begin >= 32; begin += 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        const auto mask =
+            static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline)));
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+#elif defined(__SSE2__)
+    const auto newline = _mm_set1_epi8('\n');
+    for (; end - begin >= 16; begin += 16) {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        const auto mask =
+            static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+#endif
+    const auto * found =
+        static_cast<const char *>(std::memchr(begin, '\n', static_cast<std::size_t>(end - begin)));
+    return found != nullptr ? found : end;
+}
+
+/// @brief Calls the handler with every line of the text, without line terminators
+template <typename Handler>
+void ForEachLine(std::string_view text, Handler && handler)
+{
+    const auto * cursor = text.data();
+    const auto * end = text.data() + text.size();
+    while (cursor < end) {
+        const auto * newline = TextScan::FindNewline(cursor, end);
+        auto line = std::string_view(cursor, static_cast<std::size_t>(newline - cursor));
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        handler(line);
+        cursor = newline + 1;
+    }
+}
+
+/// @brief Splits the text at line boundaries into up to the given number of parts and scans
+/// them in parallel; the handler gets the part number and a line
+template <typename Handler>
+void ForEachLineParallel(std::string_view text, std::size_t parts, Handler && handler)
+{
+    // Parts smaller than this cost more to start than they save
+    constexpr auto minimumPart = std::size_t(1) << 20;
+    parts = std::clamp<std::size_t>(text.size() / minimumPart, 1, std::max<std::size_t>(parts, 1));
+
+    auto bounds = std::vector<std::size_t>{ 0 };
+    for (auto part = std::size_t(1); part < parts; ++part) {
+        const auto target = std::max(bounds.back(), text.size() * part / parts);
+        const auto * newline =
+            TextScan::FindNewline(text.data() + target, text.data() + text.size());
+        const auto next = static_cast<std::size_t>(newline - text.data()) + 1;
+        bounds.push_back(std::min(text.size(), next));
+    }
+    bounds.push_back(text.size());
+
+    auto workers = std::vector<std::jthread>();
+    for (auto part = std::size_t(1); part < parts; ++part) {
+        workers.emplace_back([&text, &bounds, &handler, part] {
+            TextScan::ForEachLine(text.substr(bounds[part], bounds[part + 1] - bounds[part]),
+                                  [&handler, part](std::string_view line) { handler(part, line); });
+        });
+    }
+    TextScan::ForEachLine(text.substr(0, bounds[1]),
+                          [&handler](std::string_view line) { handler(std::size_t(0), line); });
+}
+
+/// @brief Returns the raw value of a top-level key of a kvalog JSON record: the characters
+/// between the quotes of a string, or the token of a number
+/// @note Quotes inside JSON strings are escaped, so a quote preceded by '{' or ',' always
+/// starts a key and no parsing is needed to find one
+inline std::optional<std::string_view> JsonValue(std::string_view line, std::string_view key)
+{
+    for (auto position = line.find(key); position != std::string_view::npos;
+         position = line.find(key, position + 1)) {
+        if (position < 2 || line[position - 1] != '"' ||
+            (line[position - 2] != '{' && line[position - 2] != ',') ||
+            line.size() < position + key.size() + 2 || line[position + key.size()] != '"' ||
+            line[position + key.size() + 1] != ':') {
+            continue;
+        }
+
+        auto value = line.substr(position + key.size() + 2);
+        if (value.empty() || value.front() != '"') {
+            return value.substr(0, value.find_first_of(",}"));
+        }
+        for (auto end = std::size_t(1); end < value.size(); ++end) {
+            if (value[end] == '\\') {
+                ++end;
+            } else if (value[end] == '"') {
+                return value.substr(1, end - 1);
+            }
+        }
+        return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+/// @brief Returns the level of a short level tag or a numeric level
+inline std::optional<LogLevel> ParseLevel(std::string_view text)
+{
+    constexpr auto tags = std::array<std::string_view, 6>{ "TRC", "DBG", "INF",
+                                                           "WRN", "ERR", "CRT" };
+    for (auto tag = std::size_t(0); tag < tags.size(); ++tag) {
+        if (text == tags[tag]) {
+            return static_cast<LogLevel>(static_cast<int>(LogLevel::Trace) + tag);
+        }
+    }
+    if (text.size() == 1 && text[0] >= '0' && text[0] <= '6') {
+        return static_cast<LogLevel>(text[0] - '0');
+    }
+    return std::nullopt;
+}
+
+/// @brief Days since the Unix epoch of a proleptic Gregorian date
+constexpr std::int64_t DaysFromCivil(std::int64_t year, unsigned month, unsigned day)
+{
+    year -= month <= 2 ? 1 : 0;
+    const auto era = (year >= 0 ? year : year - 399) / 400;
+    const auto yearOfEra = static_cast<unsigned>(year - era * 400);
+    const auto dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const auto dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+}
+
+/// @brief Parses a timestamp in any TimestampStyle into nanoseconds since the Unix epoch
+/// @note Local times without an offset are read in the time zone of this process; numbers
+/// are told apart by magnitude. Fractions of any length and offsets written as "+HH:MM" or
+/// "+HHMM" are accepted
+inline std::optional<std::int64_t> ParseTime(std::string_view text)
+{
+    const auto digits = [&text](std::size_t position, std::size_t count) -> std::int64_t {
+        auto value = std::int64_t(0);
+        for (auto index = position; index < position + count; ++index) {
+            if (index >= text.size() || text[index] < '0' || text[index] > '9') {
+                return -1;
+            }
+            value = value * 10 + (text[index] - '0');
+        }
+        return value;
+    };
+    // Scales the digits of a fraction to nanoseconds, digits past nanoseconds are ignored
+    const auto fraction = [&text](std::size_t & position) {
+        auto nanoseconds = std::int64_t(0);
+        auto scale = std::int64_t(100'000'000);
+        while (position < text.size() && text[position] >= '0' && text[position] <= '9') {
+            nanoseconds += (text[position] - '0') * scale;
+            scale /= 10;
+            position += 1;
+        }
+        return nanoseconds;
+    };
+
+    if (text.size() < 19 || text[4] != '-') {
+        if (text.empty() || text.find_first_not_of("0123456789.") != std::string_view::npos) {
+            return std::nullopt;
+        }
+        const auto point = text.find('.');
+        const auto whole = digits(0, point == std::string_view::npos ? text.size() : point);
+        if (point != std::string_view::npos) {
+            auto end = point + 1;
+            const auto nanoseconds = fraction(end);
+            if (end != text.size()) {
+                return std::nullopt;
+            }
+            return whole * 1'000'000'000 + nanoseconds;
+        }
+        if (whole < 100'000'000'000LL) {
+            return whole * 1'000'000'000;
+        }
+        if (whole < 100'000'000'000'000LL) {
+            return whole * 1'000'000;
+        }
+        if (whole < 100'000'000'000'000'000LL) {
+            return whole * 1'000;
+        }
+        return whole;
+    }
+
+    const auto year = digits(0, 4);
+    const auto month = digits(5, 2);
+    const auto day = digits(8, 2);
+    const auto hour = digits(11, 2);
+    const auto minute = digits(14, 2);
+    const auto second = digits(17, 2);
+    if (std::min({ year, month, day, hour, minute, second }) < 0) {
+        return std::nullopt;
+    }
+    auto suffix = std::size_t(19);
+    auto nanoseconds = std::int64_t(0);
+    if (suffix < text.size() && text[suffix] == '.') {
+        suffix += 1;
+        nanoseconds = fraction(suffix);
+    }
+
+    auto seconds = std::int64_t(0);
+    if (suffix < text.size() && (text[suffix] == 'Z' || text[suffix] == '+' ||
+                                 text[suffix] == '-')) {
+        seconds = TextScan::DaysFromCivil(year, static_cast<unsigned>(month),
+                                          static_cast<unsigned>(day)) *
+                      86400 +
+                  hour * 3600 + minute * 60 + second;
+        if (text[suffix] != 'Z') {
+            const auto separated = suffix + 3 < text.size() && text[suffix + 3] == ':';
+            const auto offsetHours = digits(suffix + 1, 2);
+            const auto offsetMinutes = digits(suffix + (separated ? 4 : 3), 2);
+            if (offsetHours < 0 || offsetMinutes < 0) {
+                return std::nullopt;
+            }
+            const auto offset = offsetHours * 3600 + offsetMinutes * 60;
+            seconds -= text[suffix] == '+' ? offset : -offset;
+        }
+    } else {
+        // The calendar is converted once per hour, records of the same hour only add minutes
+        thread_local auto cachedHour = std::string();
+        thread_local auto cachedHourStart = std::int64_t(0);
+        if (cachedHour != text.substr(0, 13)) {
+            auto parts = std::tm();
+            parts.tm_year = static_cast<int>(year) - 1900;
+            parts.tm_mon = static_cast<int>(month) - 1;
+            parts.tm_mday = static_cast<int>(day);
+            parts.tm_hour = static_cast<int>(hour);
+            parts.tm_isdst = -1;
+            cachedHour = text.substr(0, 13);
+            cachedHourStart = static_cast<std::int64_t>(std::mktime(&parts));
+        }
+        seconds = cachedHourStart + minute * 60 + second;
+    }
+    return seconds * 1'000'000'000 + nanoseconds;
+}
+
+/// @brief Returns the time of a JSON or terminal record
+inline std::optional<std::int64_t> RecordTime(std::string_view line)
+{
+    if (!line.empty() && line.front() == '{') {
+        auto time = TextScan::JsonValue(line, FieldKeys().time);
+        if (!time) {
+            time = TextScan::JsonValue(line, FieldKeys::Compact().time);
+        }
+        return time ? TextScan::ParseTime(*time) : std::nullopt;
+    }
+
+    // The default terminal layout starts with the bracketed time when it has one
+    if (line.size() > 20 && line.front() == '[' && line[5] == '-') {
+        return TextScan::ParseTime(line.substr(1, line.find(']') - 1));
+    }
+    return std::nullopt;
+}
+
+/// @brief Returns the sequence number of a JSON or terminal record written with the sequence
+/// field
+inline std::optional<std::uint64_t> RecordSequence(std::string_view line)
+{
+    auto digits = std::optional<std::string_view>();
+    if (!line.empty() && line.front() == '{') {
+        digits = TextScan::JsonValue(line, FieldKeys().sequence);
+    } else {
+        // Only the leading bracketed groups, the message may contain anything
+        while (!digits && line.starts_with("[")) {
+            const auto close = line.find(']');
+            if (close == std::string_view::npos) {
+                break;
+            }
+            if (line.starts_with("[SEQ:")) {
+                digits = line.substr(5, close - 5);
+            }
+            line.remove_prefix(close + 1);
+        }
+    }
+    if (!digits || digits->empty()) {
+        return std::nullopt;
+    }
+
+    auto sequence = std::uint64_t(0);
+    const auto [end, error] =
+        std::from_chars(digits->data(), digits->data() + digits->size(), sequence);
+    if (error != std::errc() || end != digits->data() + digits->size()) {
+        return std::nullopt;
+    }
+    return sequence;
+}
+
+}  // namespace TextScan
+
+/// @brief Record filter for kvalog text logs; unset members match everything
+struct TextLogQuery {
+    std::optional<LogLevel> minLevel = std::nullopt;
+    std::optional<std::string> app = std::nullopt;
+    std::optional<std::string> module = std::nullopt;
+    /// @brief Inclusive lower time bound in nanoseconds since the Unix epoch
+    std::optional<std::int64_t> since = std::nullopt;
+    /// @brief Exclusive upper time bound in nanoseconds since the Unix epoch
+    std::optional<std::int64_t> until = std::nullopt;
+    /// @brief Substring the record must contain anywhere in its line
+    std::optional<std::string> contains = std::nullopt;
+};
+
+///
+/// @brief
+/// TextRecordFilter matches lines written by the JSON and terminal formats without parsing
+/// them. JSON records are recognized by their leading brace and their fields are located by
+/// key, with either the default or the compact key names. Terminal records are read from the
+/// leading bracketed groups of the default layout: the level is the group holding a level tag,
+/// the time the group holding a timestamp, and app and module match any other group.
+/// The substring test runs last, it is the only one touching the whole line.
+///
+class TextRecordFilter
+{
+public:
+    /// @brief Constructor with the query
+    explicit TextRecordFilter(TextLogQuery initialQuery) : query(std::move(initialQuery)) {}
+
+    /// @brief Returns whether the line holds a matching record
+    bool Matches(std::string_view line) const
+    {
+        if (line.empty()) {
+            return false;
+        }
+        const auto structured = line.front() == '{' ? this->matchesJson(line)
+                                                    : this->matchesTerminal(line);
+        return structured && (!this->query.contains ||
+                              line.find(*this->query.contains) != std::string_view::npos);
+    }
+
+private:
+    /// @brief Matches the fields of a JSON record
+    bool matchesJson(std::string_view line) const
+    {
+        const auto value = [&line](std::string_view key, std::string_view compactKey) {
+            auto found = TextScan::JsonValue(line, key);
+            return found ? found : TextScan::JsonValue(line, compactKey);
+        };
+
+        if (this->query.minLevel) {
+            const auto level = value(this->keys.level, this->compactKeys.level);
+            const auto parsed = level ? TextScan::ParseLevel(*level) : std::nullopt;
+            if (!parsed || *parsed < *this->query.minLevel) {
+                return false;
+            }
+        }
+        if (this->query.module &&
+            value(this->keys.moduleName, this->compactKeys.moduleName) != *this->query.module) {
+            return false;
+        }
+        if (this->query.app &&
+            value(this->keys.appName, this->compactKeys.appName) != *this->query.app) {
+            return false;
+        }
+        if (this->query.since || this->query.until) {
+            const auto time = value(this->keys.time, this->compactKeys.time);
+            return this->matchesTime(time ? TextScan::ParseTime(*time) : std::nullopt);
+        }
+        return true;
+    }
+
+    /// @brief Matches the leading bracketed groups of a terminal record
+    bool matchesTerminal(std::string_view line) const
+    {
+        auto level = std::optional<LogLevel>();
+        auto time = std::optional<std::int64_t>();
+        auto appFound = !this->query.app;
+        auto moduleFound = !this->query.module;
+        const auto needTime = this->query.since || this->query.until;
+
+        auto stripped = std::string();
+        while (!line.empty() && line.front() == '[') {
+            const auto close = line.find(']');
+            if (close == std::string_view::npos) {
+                break;
+            }
+            auto group = line.substr(1, close - 1);
+            line.remove_prefix(close + 1);
+            if (group.find('\033') != std::string_view::npos) {
+                stripped = TextRecordFilter::stripColors(group);
+                group = stripped;
+            }
+
+            if (!level && (level = TextScan::ParseLevel(group))) {
+                continue;
+            }
+            if (needTime && !time && group.size() >= 19 && group[4] == '-') {
+                time = TextScan::ParseTime(group);
+                continue;
+            }
+            appFound = appFound || group == *this->query.app;
+            moduleFound = moduleFound || group == *this->query.module;
+        }
+
+        if (this->query.minLevel && (!level || *level < *this->query.minLevel)) {
+            return false;
+        }
+        return appFound && moduleFound && (!needTime || this->matchesTime(time));
+    }
+
+    /// @brief Matches a record time against the time bounds
+    bool matchesTime(std::optional<std::int64_t> time) const
+    {
+        return time && (!this->query.since || *time >= *this->query.since) &&
+               (!this->query.until || *time < *this->query.until);
+    }
+
+    /// @brief Removes ANSI color sequences
+    static std::string stripColors(std::string_view text)
+    {
+        auto plain = std::string();
+        for (auto position = std::size_t(0); position < text.size(); ++position) {
+            if (text[position] == '\033') {
+                position = std::min(text.find('m', position), text.size());
+                continue;
+            }
+            plain.push_back(text[position]);
+        }
+        return plain;
+    }
+
+    /// @brief Query to match
+    TextLogQuery query;
+    /// @brief Default key names
+    FieldKeys keys = FieldKeys();
+    /// @brief Compact key names
+    FieldKeys compactKeys = FieldKeys::Compact();
+};
+
+}  // namespace kvalog
@@ -0,0 +1,395 @@
+#pragma once
+
+#include "kvalog.hpp"
+
+#if defined(__linux__)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace kvalog
+{
+
+/// @brief Default location of the shared ring
+inline constexpr auto DefaultSharedRingPath = "/dev/shm/kvalog.ring";
+/// @brief Default capacity of the shared ring in bytes
+inline constexpr std::size_t DefaultSharedRingCapacity = std::size_t(16) * 1024 * 1024;
+
+///
+/// @brief
+/// SharedRingHeader is the control block at the start of a shared ring file.
+/// The producer reserves space by advancing writeCursor and the consumer frees it by advancing
+/// readCursor; both are byte positions that only grow, the offset in the ring is their low bits.
+///
+struct SharedRingHeader {
+    /// @brief Identifies an initialized ring
+    static constexpr std::uint64_t Magic = 0x6B76'616C'6F67'7231;  // "kvalogr1"
+    /// @brief Layout version
+    static constexpr std::uint32_t Version = 1;
+    /// @brief Size of the control block; the ring data starts after it
+    static constexpr std::size_t Size = 4096;
+
+    /// @brief Magic, written last when the ring is initialized
+    std::atomic<std::uint64_t> magic;
+    /// @brief Layout version
+    std::uint32_t version;
+    /// @brief Unused
+    std::uint32_t reserved;
+    /// @brief Ring data size in bytes, a power of two
+    std::uint64_t capacity;
+    /// @brief Incremented every time a producer initializes the ring
+    std::atomic<std::uint64_t> generation;
+
+    /// @brief End of the reserved space, advanced by producers
+    alignas(64) std::atomic<std::uint64_t> writeCursor;
+    /// @brief Start of the unread space, advanced by the consumer
+    alignas(64) std::atomic<std::uint64_t> readCursor;
+    /// @brief Records dropped because the ring was full
+    alignas(64) std::atomic<std::uint64_t> droppedRecords;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "kvalog: the shared ring needs lock-free 64-bit atomics");
+static_assert(sizeof(SharedRingHeader) <= SharedRingHeader::Size);
+
+///
+/// @brief
+/// SharedRing maps a ring file shared between one logging process and one shipper process.
+/// Every slot starts with an 8-byte word holding its kind and length. The word is zero until the
+/// slot is published, the producer publishes it with a release store after copying the record,
+/// and the consumer zeroes consumed space before handing it back, so a zero word always means
+/// "not yet written".
+///
+class SharedRing
+{
+public:
+    /// [Construction & Destruction]
+
+#pragma region SharedRing::Construct
+
+    /// @brief Copy constructor is deleted
+    SharedRing(const SharedRing &) = delete;
+    /// @brief Copy operator is deleted
+    SharedRing & operator=(const SharedRing &) = delete;
+
+    /// @brief Creates or resets the ring file as its producer
+    /// @note Records left unread by a previous producer are discarded, so a producer that died
+    /// mid-write cannot stall the consumer
+    static std::unique_ptr<SharedRing> Create(const std::string & path,
+                                              std::size_t capacity = DefaultSharedRingCapacity)
+    {
+        auto ring = std::unique_ptr<SharedRing>(new SharedRing());
+        ring->capacity = std::bit_ceil(std::max<std::size_t>(capacity, SharedRingHeader::Size));
+        ring->map(path, O_RDWR | O_CREAT, SharedRingHeader::Size + ring->capacity);
+
+        auto & header = ring->Header();
+        const auto initialized =
+            header.magic.load(std::memory_order_acquire) == SharedRingHeader::Magic;
+        const auto previous = initialized ? header.generation.load(std::memory_order_relaxed) : 0;
+
+        header.magic.store(0, std::memory_order_release);
+        std::memset(ring->data, 0, ring->capacity);
+        header.version = SharedRingHeader::Version;
+        header.capacity = ring->capacity;
+        header.writeCursor.store(0, std::memory_order_relaxed);
+        header.readCursor.store(0, std::memory_order_relaxed);
+        header.droppedRecords.store(0, std::memory_order_relaxed);
+        header.generation.store(previous + 1, std::memory_order_relaxed);
+        header.magic.store(SharedRingHeader::Magic, std::memory_order_release);
+        return ring;
+    }
+
+    /// @brief Attaches to an existing ring file as its consumer
+    /// @throws std::system_error when the file cannot be mapped
+    /// @throws std::runtime_error when the file is not an initialized ring
+    static std::unique_ptr<SharedRing> Attach(const std::string & path)
+    {
+        auto ring = std::unique_ptr<SharedRing>(new SharedRing());
+        ring->map(path, O_RDWR, 0);
+
+        const auto & header = ring->Header();
+        if (header.magic.load(std::memory_order_acquire) != SharedRingHeader::Magic ||
+            header.version != SharedRingHeader::Version ||
+            !std::has_single_bit(header.capacity) ||
+            SharedRingHeader::Size + header.capacity > ring->mappedSize) {
+            throw std::runtime_error("kvalog: not an initialized shared ring: " + path);
+        }
+        ring->capacity = header.capacity;
+        return ring;
+    }
+
+    /// @brief Destructor, unmaps the ring; the file stays for the other side
+    ~SharedRing()
+    {
+        if (this->mapping != nullptr) {
+            munmap(this->mapping, this->mappedSize);
+        }
+    }
+
+#pragma endregion
+
+    /// [Producer]
+
+    /// @brief Copies a record into the ring and publishes it, never waiting for the consumer
+    /// @return False when the ring is full or the record is larger than half the ring
+    /// @note Safe to call from any number of threads of the producing process
+    bool TryWrite(std::string_view record)
+    {
+        auto & header = this->Header();
+        const auto needed = SlotHeaderSize + SharedRing::alignUp(record.size());
+        if (needed > this->capacity / 2) {
+            header.droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Reserve the slot, plus padding up to the end of the ring when it would wrap
+        auto position = header.writeCursor.load(std::memory_order_relaxed);
+        auto padding = std::uint64_t(0);
+        while (true) {
+            const auto offset = position & (this->capacity - 1);
+            padding = offset + needed > this->capacity ? this->capacity - offset : 0;
+            const auto end = position + padding + needed;
+            if (end - header.readCursor.load(std::memory_order_acquire) > this->capacity) {
+                header.droppedRecords.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (header.writeCursor.compare_exchange_weak(
+                    position, end, std::memory_order_relaxed, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        if (padding > 0) {
+            this->publish(position, SlotKind::Padding, padding);
+            position += padding;
+        }
+
+        auto * slot = this->data + (position & (this->capacity - 1));
+        std::memcpy(slot + SlotHeaderSize, record.data(), record.size());
+        this->publish(position, SlotKind::Record, record.size());
+        return true;
+    }
+
+    /// [Consumer]
+
+    /// @brief Hands up to maxRecords published records to the handler, oldest first
+    /// @return Number of records handled
+    /// @note Only one consumer may poll a ring; the record view is valid during the call only
+    template <typename Handler>
+    std::size_t Poll(Handler && handler, std::size_t maxRecords)
+    {
+        auto & header = this->Header();
+        if (header.magic.load(std::memory_order_acquire) != SharedRingHeader::Magic) {
+            return 0;
+        }
+
+        auto position = header.readCursor.load(std::memory_order_relaxed);
+        auto handled = std::size_t(0);
+        while (handled < maxRecords &&
+               position != header.writeCursor.load(std::memory_order_acquire)) {
+            auto * slot = this->data + (position & (this->capacity - 1));
+            const auto word =
+                std::atomic_ref<std::uint64_t>(*reinterpret_cast<std::uint64_t *>(slot))
+                    .load(std::memory_order_acquire);
+            if (word == 0) {
+                break;
+            }
+
+            const auto kind = static_cast<SlotKind>(word >> SlotKindShift);
+            const auto length = static_cast<std::size_t>(word & SlotLengthMask);
+            const auto span =
+                kind == SlotKind::Padding ? length : SlotHeaderSize + SharedRing::alignUp(length);
+
+            if (kind == SlotKind::Record) {
+                handler(std::string_view(reinterpret_cast<const char *>(slot) + SlotHeaderSize,
+                                         length));
+                handled += 1;
+            }
+
+            std::memset(slot, 0, span);
+            position += span;
+            header.readCursor.store(position, std::memory_order_release);
+        }
+        return handled;
+    }
+
+    /// [Information]
+
+    /// @brief Returns the ring control block
+    SharedRingHeader & Header() const
+    {
+        return *reinterpret_cast<SharedRingHeader *>(this->mapping);
+    }
+
+    /// @brief Returns the ring data size in bytes
+    std::size_t Capacity() const
+    {
+        return this->capacity;
+    }
+
+    /// @brief Returns the number of bytes written but not yet consumed
+    std::uint64_t Backlog() const
+    {
+        const auto & header = this->Header();
+        return header.writeCursor.load(std::memory_order_acquire) -
+               header.readCursor.load(std::memory_order_acquire);
+    }
+
+private:
+    /// @brief Kind of a ring slot
+    enum class SlotKind : std::uint32_t {
+        Record = 1,
+        Padding = 2
+    };
+
+    /// @brief Size of the word in front of every slot
+    static constexpr std::size_t SlotHeaderSize = sizeof(std::uint64_t);
+    /// @brief Position of the kind in the slot word
+    static constexpr int SlotKindShift = 32;
+    /// @brief Mask of the length in the slot word
+    static constexpr std::uint64_t SlotLengthMask = 0xffffffff;
+
+    /// @brief Constructor, use Create or Attach
+    SharedRing() = default;
+
+    /// @brief Opens and maps the ring file, growing it to size when size is not zero
+    void map(const std::string & path, int flags, std::size_t size)
+    {
+        const auto fd = open(path.c_str(), flags | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "kvalog: open " + path);
+        }
+
+        struct stat status = {};
+        if (size > 0 && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            const auto error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "kvalog: ftruncate " + path);
+        }
+        if (size == 0) {
+            fstat(fd, &status);
+            size = static_cast<std::size_t>(status.st_size);
+        }
+        if (size < SharedRingHeader::Size) {
+            close(fd);
+            throw std::runtime_error("kvalog: not an initialized shared ring: " + path);
+        }
+
+        this->mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const auto error = errno;
+        close(fd);
+        if (this->mapping == MAP_FAILED) {
+            this->mapping = nullptr;
+            throw std::system_error(error, std::generic_category(), "kvalog: mmap " + path);
+        }
+
+        this->mappedSize = size;
+        this->data = static_cast<std::uint8_t *>(this->mapping) + SharedRingHeader::Size;
+    }
+
+    /// @brief Publishes a slot by storing its word
+    void publish(std::uint64_t position, SlotKind kind, std::size_t length)
+    {
+        auto * slot = this->data + (position & (this->capacity - 1));
+        const auto word = (static_cast<std::uint64_t>(kind) << SlotKindShift) |
+                          static_cast<std::uint64_t>(length);
+        std::atomic_ref<std::uint64_t>(*reinterpret_cast<std::uint64_t *>(slot))
+            .store(word, std::memory_order_release);
+    }
+
+    /// @brief Rounds a length up to the slot alignment
+    static std::size_t alignUp(std::size_t length)
+    {
+        return (length + SlotHeaderSize - 1) & ~(SlotHeaderSize - 1);
+    }
+
+    /// [Properties]
+
+    /// @brief Mapped file
+    void * mapping = nullptr;
+    /// @brief Size of the mapping
+    std::size_t mappedSize = 0;
+    /// @brief Start of the ring data
+    std::uint8_t * data = nullptr;
+    /// @brief Ring data size
+    std::size_t capacity = 0;
+};
+
+///
+/// @brief
+/// SharedRingAdapter hands records to an out-of-process shipper through a shared ring.
+/// Sending is a copy into shared memory; when the shipper falls behind or is not running,
+/// records are dropped and counted in the ring header rather than blocking the logger.
+///
+class SharedRingAdapter : public INetworkSink
+{
+public:
+    /// [Fabric Methods]
+
+    /// @brief Creates an adapter producing into the ring file at the given path
+    static std::shared_ptr<SharedRingAdapter> Create(
+        const std::string & path = DefaultSharedRingPath,
+        std::size_t capacity = DefaultSharedRingCapacity)
+    {
+        return std::make_shared<SharedRingAdapter>(SharedRing::Create(path, capacity));
+    }
+
+    /// [Construction & Destruction]
+
+#pragma region SharedRingAdapter::Construct
+
+    /// @brief Constructor with a ring created as producer
+    /// @warning Avoid using this constructor since class has static fabric methods
+    explicit SharedRingAdapter(std::unique_ptr<SharedRing> initialRing)
+        : ring(std::move(initialRing))
+    {
+    }
+
+#pragma endregion
+
+    /// [INetworkSink]
+
+    /// @brief Copies the record into the ring
+    void SendLog(const std::string & jsonLog) override
+    {
+        this->ring->TryWrite(jsonLog);
+    }
+
+    /// @brief The ring is always writable, records are dropped when it is full
+    bool IsConnected() const override
+    {
+        return true;
+    }
+
+    /// [Statistics]
+
+    /// @brief Returns the number of records dropped because the ring was full
+    std::uint64_t DroppedRecords() const
+    {
+        return this->ring->Header().droppedRecords.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// [Properties]
+
+    /// @brief Ring shared with the shipper
+    std::unique_ptr<SharedRing> ring;
+};
+
+}  // namespace kvalog
+
+#endif
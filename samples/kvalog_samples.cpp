@@ -1,11 +1,41 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <tuple>
 
 #include "kvalog.hpp"
+#include "kvalog_columnar.hpp"
+#include "kvalog_network.hpp"
+#include "kvalog_pipe.hpp"
+#include "kvalog_reader.hpp"
+#include "kvalog_shm.hpp"
 
 using namespace kvalog;
 
+// Results checked by the samples; a failed check makes the samples exit with a failure status
+int failedChecks = 0;
+
+void check(bool condition, const std::string & what)
+{
+    if (!condition) {
+        std::cout << "CHECK FAILED: " << what << std::endl;
+        failedChecks += 1;
+    }
+}
+
 // Example HTTP network adapter
 class HttpNetworkAdapter : public INetworkSink
 {
@@ -53,6 +83,204 @@ private:
     bool connected = false;
 };
 
+// Network adapter that only counts what it receives, used by the benchmarks
+class CountingNetworkAdapter : public INetworkSink
+{
+public:
+    void SendLog(const std::string & jsonLog) override
+    {
+        this->records += 1;
+        this->bytes += jsonLog.size();
+    }
+
+    bool IsConnected() const override
+    {
+        return true;
+    }
+
+    std::size_t records = 0;
+    std::size_t bytes = 0;
+};
+
+// Network adapter that keeps the last record it receives, used to inspect binary output
+class CapturingNetworkAdapter : public INetworkSink
+{
+public:
+    void SendLog(const std::string & jsonLog) override
+    {
+        this->last = jsonLog;
+    }
+
+    bool IsConnected() const override
+    {
+        return true;
+    }
+
+    std::string last;
+};
+
+// Network adapter standing in for a collector that takes a while to acknowledge each record
+class SlowNetworkAdapter : public INetworkSink
+{
+public:
+    void SendLog(const std::string &) override
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+
+    bool IsConnected() const override
+    {
+        return true;
+    }
+};
+
+// Structured sink recording how long records take from the call site to the worker
+class LatencySink : public IStructuredSink
+{
+public:
+    void WriteRecord(const LogRecord & record, std::string_view, std::string_view) override
+    {
+        this->latencies.push_back(TscClock::ReadRealtimeNanoseconds() - record.timestamp);
+    }
+
+    std::vector<std::int64_t> latencies;
+};
+
+// Stand-in for a local OTLP collector: receives batches and decodes the OTLP/JSON envelope
+class OtlpCollectorAdapter : public INetworkSink
+{
+public:
+    void SendLog(const std::string & jsonLog) override
+    {
+        this->SendBatch(jsonLog, 1);
+    }
+
+    void SendBatch(const std::string & batch, std::size_t recordCount) override
+    {
+        const auto request = nlohmann::json::parse(batch);
+        const auto & resourceLogs = request.at("resourceLogs").at(0);
+        const auto & scopeLogs = resourceLogs.at("scopeLogs").at(0);
+
+        std::cout << "[OTLP collector] batch of " << recordCount << " records, " << batch.size()
+                  << " bytes, service.name="
+                  << resourceLogs.at("resource").at("attributes").at(0).at("value") << ", scope="
+                  << scopeLogs.at("scope").at("name") << ", decoded "
+                  << scopeLogs.at("logRecords").size() << " records" << std::endl;
+
+        if (this->batches++ == 0) {
+            std::cout << request.dump() << std::endl;
+        }
+    }
+
+    bool IsConnected() const override
+    {
+        return true;
+    }
+
+    std::size_t batches = 0;
+};
+
+#if defined(__linux__)
+// Local listener standing in for a log collector: counts the records and bytes it receives
+class LoopbackListener
+{
+public:
+    LoopbackListener(SocketTransport transport, const std::string & path = std::string())
+        : datagram(transport == SocketTransport::Udp || transport == SocketTransport::UnixDatagram)
+    {
+        const auto type = this->datagram ? SOCK_DGRAM : SOCK_STREAM;
+        if (path.empty()) {
+            this->listenFd = socket(AF_INET, type, 0);
+            auto address = sockaddr_in{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            bind(this->listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+            auto length = socklen_t(sizeof(address));
+            getsockname(this->listenFd, reinterpret_cast<sockaddr *>(&address), &length);
+            this->port = ntohs(address.sin_port);
+        } else {
+            unlink(path.c_str());
+            this->listenFd = socket(AF_UNIX, type, 0);
+            auto address = sockaddr_un{};
+            address.sun_family = AF_UNIX;
+            std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+            bind(this->listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+            this->path = path;
+        }
+
+        if (!this->datagram) {
+            listen(this->listenFd, 4);
+        }
+        this->receiver = std::thread([this]() { this->receive(); });
+    }
+
+    ~LoopbackListener()
+    {
+        this->Stop();
+    }
+
+    // Stops receiving; stream connections still open are read to the end first
+    void Stop()
+    {
+        if (!this->receiver.joinable()) {
+            return;
+        }
+        this->stopping = true;
+        shutdown(this->listenFd, SHUT_RDWR);
+        this->receiver.join();
+        close(this->listenFd);
+        if (!this->path.empty()) {
+            unlink(this->path.c_str());
+        }
+    }
+
+    std::uint16_t port = 0;
+    std::atomic<std::size_t> records = 0;
+    std::atomic<std::size_t> bytes = 0;
+    // Everything received, complete once stopped
+    std::string data;
+
+private:
+    void receive()
+    {
+        auto buffer = std::vector<char>(64 * 1024);
+        if (this->datagram) {
+            while (!this->stopping) {
+                const auto received = recv(this->listenFd, buffer.data(), buffer.size(), 0);
+                if (received > 0) {
+                    this->data.append(buffer.data(), static_cast<std::size_t>(received));
+                    this->records += 1;
+                    this->bytes += static_cast<std::size_t>(received);
+                }
+            }
+            return;
+        }
+
+        while (!this->stopping) {
+            const auto connection = accept(this->listenFd, nullptr, nullptr);
+            if (connection < 0) {
+                return;
+            }
+            auto received = recv(connection, buffer.data(), buffer.size(), 0);
+            while (received > 0) {
+                this->data.append(buffer.data(), static_cast<std::size_t>(received));
+                this->records += static_cast<std::size_t>(
+                    std::count(buffer.data(), buffer.data() + received, '\n'));
+                this->bytes += static_cast<std::size_t>(received);
+                received = recv(connection, buffer.data(), buffer.size(), 0);
+            }
+            close(connection);
+        }
+    }
+
+    bool datagram = false;
+    int listenFd = -1;
+    std::string path;
+    std::atomic<bool> stopping = false;
+    std::thread receiver;
+};
+#endif
+
 void sampleBasicUsage()
 {
     std::cout << "\n=== Basic Usage Sample ===" << std::endl;
@@ -211,6 +439,479 @@ void sampleAsyncLogging()
     logger->Flush();
 }
 
+void sampleSequenceNumbers()
+{
+#if defined(__linux__)
+    std::cout << "\n=== Sequence Numbers Sample ===" << std::endl;
+
+    constexpr auto modules = 4;
+    constexpr auto producers = 2;
+    constexpr auto records = 2000;
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto pathOf = [&directory](int module) {
+        return directory / ("kvalog_sequence_" + std::to_string(module) + ".log");
+    };
+
+    // Four loggers share four workers, one each, so their sinks run in parallel
+    auto config = MakeProfileConfig(LogProfile::Json);
+    config.logToConsole = false;
+    config.fields.includeSequence = true;
+    config.asyncMode = Logger::Mode::Async;
+    config.asyncThreadCount = modules;
+    {
+        auto loggers = std::vector<LoggerPtr>();
+        for (auto module = 0; module < modules; ++module) {
+            config.logFilePath = pathOf(module).string();
+            loggers.push_back(Logger::Create(
+                config, Logger::Context{ .appName = "Shop",
+                                         .moduleName = "Module" + std::to_string(module) }));
+        }
+
+        auto threads = std::vector<std::thread>();
+        for (auto module = 0; module < modules; ++module) {
+            for (auto producer = 0; producer < producers; ++producer) {
+                threads.emplace_back([&logger = loggers[module], producer] {
+                    for (auto i = 0; i < records; ++i) {
+                        logger->Info("producer {} item {}", producer, i);
+                    }
+                });
+            }
+        }
+        for (auto & thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Every producer's items stay in order and the sequence has no gaps
+    auto ordered = true;
+    auto complete = true;
+    for (auto module = 0; module < modules; ++module) {
+        auto nextItem = std::array<int, producers>();
+        auto seen = std::vector<bool>(producers * records + 1);
+        auto input = std::ifstream(pathOf(module));
+        for (auto line = std::string(); std::getline(input, line);) {
+            const auto message = std::string(TextScan::JsonValue(line, "message").value_or(""));
+            auto producer = 0;
+            auto item = 0;
+            std::sscanf(message.c_str(), "producer %d item %d", &producer, &item);
+            ordered = ordered && item == nextItem[producer]++;
+            const auto sequence = TextScan::RecordSequence(line).value_or(0);
+            if (sequence > 0 && sequence < seen.size()) {
+                seen[sequence] = true;
+            }
+        }
+        complete = complete && std::find(seen.begin() + 1, seen.end(), false) == seen.end();
+        std::filesystem::remove(pathOf(module));
+    }
+    std::cout << "Async with " << modules << " workers: per-producer order "
+              << (ordered ? "kept" : "broken") << ", sequence " << (complete ? "complete" : "gaps")
+              << std::endl;
+
+    // A small queue dropping its oldest records under a burst, the gaps show what was lost
+    config.asyncQueueSize = 64;
+    config.asyncThreadCount = 1;
+    config.asyncOverflow = AsyncOverflow::DropOldest;
+    config.logFilePath = pathOf(0).string();
+    {
+        auto logger = Logger::Create(config, Logger::Context{ .appName = "Shop" });
+        for (auto i = 0; i < records; ++i) {
+            logger->Info("burst item {}", i);
+        }
+    }
+
+    auto written = std::uint64_t(0);
+    auto gaps = std::uint64_t(0);
+    auto last = std::uint64_t(0);
+    auto input = std::ifstream(pathOf(0));
+    for (auto line = std::string(); std::getline(input, line);) {
+        const auto sequence = TextScan::RecordSequence(line).value_or(last + 1);
+        gaps += sequence - last - 1;
+        last = sequence;
+        written += 1;
+    }
+    gaps += records - last;
+    input.close();
+    std::filesystem::remove(pathOf(0));
+    std::cout << "DropOldest: " << written << " of " << records << " records written, " << gaps
+              << " detected missing from sequence gaps" << std::endl;
+#endif
+}
+
+void sampleSinkQueues()
+{
+    std::cout << "\n=== Sink Queues Sample ===" << std::endl;
+
+    constexpr auto records = 1000;
+    const auto path = std::filesystem::temp_directory_path() / "kvalog_sink_queues.log";
+    const auto fileComplete = [&path] {
+        auto input = std::ifstream(path);
+        return std::count(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>(),
+                          '\n') >= records;
+    };
+
+    // A file and a slow network sink, written by one worker or each by its own
+    for (const auto queued : { false, true }) {
+        auto config = MakeProfileConfig(LogProfile::Json);
+        config.logToConsole = false;
+        config.logFilePath = path.string();
+        config.networkAdapter = std::make_shared<SlowNetworkAdapter>();
+        config.asyncMode = Logger::Mode::Async;
+        config.sinkQueueing.queueSize = queued ? records : 0;
+        auto logger = Logger::Create(config, Logger::Context{ .appName = "Shop" });
+
+        const auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i < records; ++i) {
+            logger->Info("Order {} shipped", i);
+        }
+        // The flush is queued behind the records, the file is complete once they are written
+        logger->Flush();
+        while (!fileComplete()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << (queued ? "Queued sinks: " : "Shared worker: ") << "file complete after "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+                  << " ms" << std::endl;
+        for (const auto & stats : logger->SinkStats()) {
+            std::cout << "  " << stats.name << ": " << stats.queuedRecords << " queued, peak "
+                      << stats.peakQueuedRecords << ", lag "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(stats.lag).count()
+                      << " ms" << std::endl;
+        }
+    }
+
+    std::filesystem::remove(path);
+}
+
+void sampleIdleStrategies()
+{
+    std::cout << "\n=== Idle Strategies Sample ===" << std::endl;
+
+    constexpr auto records = 2000;
+    const auto cores = std::thread::hardware_concurrency();
+    const auto strategies = std::array{ std::pair{ IdleStrategy::Park, "Park" },
+                                        std::pair{ IdleStrategy::SpinThenYield, "SpinThenYield" },
+                                        std::pair{ IdleStrategy::BusySpin, "BusySpin" } };
+
+    for (const auto & [strategy, name] : strategies) {
+        // A busy-spinning worker needs a core of its own
+        if (strategy == IdleStrategy::BusySpin && cores < 2) {
+            std::cout << name << ": skipped on a single CPU" << std::endl;
+            continue;
+        }
+
+        auto sink = std::make_shared<LatencySink>();
+        auto config = Logger::Config();
+        config.logToConsole = false;
+        config.structuredSink = sink;
+        config.asyncMode = Logger::Mode::Async;
+        config.asyncThreading.idle = strategy;
+        if (cores > 1) {
+            config.asyncThreading.cpus = { static_cast<int>(cores) - 1 };
+        }
+        {
+            auto logger = Logger::Create(config, Logger::Context{ .appName = "Shop" });
+            for (auto i = 0; i < records; ++i) {
+                logger->Info("Quote {} updated", i);
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+
+        auto & latencies = sink->latencies;
+        std::sort(latencies.begin(), latencies.end());
+        std::cout << name << ": p50 " << latencies[latencies.size() / 2] / 1000 << " us, p99 "
+                  << latencies[latencies.size() * 99 / 100] / 1000 << " us" << std::endl;
+    }
+}
+
+void sampleHugePages()
+{
+    std::cout << "\n=== Huge Pages Sample ===" << std::endl;
+
+    constexpr auto records = 1 << 18;
+    const auto backingNames = std::array{ "base pages", "transparent huge pages", "hugetlbfs" };
+    const auto probe = PageMemory(HugePageSize, true, -1);
+    std::cout << "Huge page blocks here use "
+              << backingNames[static_cast<std::size_t>(probe.Backing())] << std::endl;
+
+    for (const auto hugePages : { false, true }) {
+        auto sink = std::make_shared<LatencySink>();
+        sink->latencies.reserve(records);
+        auto config = Logger::Config();
+        config.logToConsole = false;
+        config.structuredSink = sink;
+        config.asyncMode = Logger::Mode::Async;
+        // The ring holds the whole burst, so producers never wait for the worker
+        config.asyncQueueSize = records;
+        config.asyncThreading.hugePages = hugePages;
+
+        auto start = std::chrono::steady_clock::time_point();
+        auto queued = std::chrono::steady_clock::duration();
+        {
+            auto logger = Logger::Create(config, Logger::Context{ .appName = "Shop" });
+            start = std::chrono::steady_clock::now();
+            for (auto i = 0; i < records; ++i) {
+                logger->Info("Quote {} updated", i);
+            }
+            queued = std::chrono::steady_clock::now() - start;
+        }
+        // The worker writes the queued records before the logger is gone
+        const auto drained = std::chrono::steady_clock::now() - start;
+
+        std::cout << (hugePages ? "Huge pages: " : "Base pages: ") << records
+                  << " records queued in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(queued).count()
+                  << " ms, written in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(drained).count()
+                  << " ms" << std::endl;
+    }
+}
+
+void sampleMemoryBudget()
+{
+    std::cout << "\n=== Memory Budget Sample ===" << std::endl;
+
+    constexpr auto records = 200;
+    constexpr auto budgetBytes = std::size_t(1) << 20;
+    const auto frame = std::string(std::size_t(64) * 1024, 'x');
+
+    // A burst of 64 KB records towards a slow collector, without a cap, then capped at 1 MB
+    const auto unbounded = std::numeric_limits<std::size_t>::max();
+    const auto runs =
+        std::array{ std::tuple{ "Unbounded", unbounded, AsyncOverflow::Block },
+                    std::tuple{ "Block", budgetBytes, AsyncOverflow::Block },
+                    std::tuple{ "DropOldest", budgetBytes, AsyncOverflow::DropOldest } };
+    for (const auto & [name, limit, overflow] : runs) {
+        auto config = MakeProfileConfig(LogProfile::Json);
+        config.logToConsole = false;
+        config.networkAdapter = std::make_shared<SlowNetworkAdapter>();
+        config.asyncMode = Logger::Mode::Async;
+        config.asyncOverflow = overflow;
+        config.memoryBudget = MemoryBudget::Create(limit);
+        {
+            auto logger = Logger::Create(config, Logger::Context{ .appName = "Gateway" });
+            for (auto i = 0; i < records; ++i) {
+                logger->Debug("Frame {}: {}", i, frame);
+            }
+        }
+
+        const auto stats = config.memoryBudget->Stats();
+        std::cout << name << ": peak " << stats.peakBytes / 1024 << " KB in flight, "
+                  << stats.droppedRecords << " dropped, " << stats.currentBytes
+                  << " bytes left after shutdown" << std::endl;
+    }
+}
+
+void sampleMessageLimits()
+{
+    std::cout << "\n=== Message Limits Sample ===" << std::endl;
+
+    const auto path = std::filesystem::temp_directory_path() / "kvalog_message_limits.log";
+    const auto dump = std::string(std::size_t(4) << 20, 'z');
+    auto collector = std::make_shared<CapturingNetworkAdapter>();
+
+    auto config = MakeProfileConfig(LogProfile::Json);
+    config.logToConsole = false;
+    config.logFilePath = path.string();
+    config.networkAdapter = collector;
+    config.messageLimits.maxRecordBytes = std::size_t(64) * 1024;
+    config.messageLimits.streamChunkBytes = std::size_t(16) * 1024;
+    {
+        auto logger = Logger::Create(config, Logger::Context{ .appName = "Gateway" });
+        logger->Info("Payload {}", dump);
+        std::cout << "Network record cut to " << collector->last.size() << " bytes" << std::endl;
+
+        // Cut at the call site, the rest of the payload is never copied
+        logger->SetMessageLimits(MessageLimits{ .maxMessageBytes = 48 });
+        logger->Info("Payload {}", dump);
+        std::cout << "Capped at the call site: " << collector->last;
+
+        // The other fields alone exceed this limit, cutting them would break the JSON
+        logger->SetMessageLimits(MessageLimits{ .maxRecordBytes = 32 });
+        const auto previous = collector->last;
+        logger->Info("Payload {}", dump);
+        std::cout << "Oversized records dropped: " << logger->OversizedRecords() << std::endl;
+        check(logger->OversizedRecords() == 1 && collector->last == previous,
+              "A record that cannot fit maxRecordBytes is dropped and counted");
+    }
+
+    auto input = std::ifstream(path);
+    auto line = std::string();
+    std::getline(input, line);
+    const auto record = nlohmann::json::parse(line);
+    std::cout << "Log file record: " << line.size() << " bytes, streamed whole, message of "
+              << record.at("message").get<std::string>().size() << " bytes" << std::endl;
+    std::filesystem::remove(path);
+}
+
+void sampleDebugHex()
+{
+    std::cout << "\n=== Debug Hex Sample ===" << std::endl;
+
+    // A request line followed by binary fields
+    auto frame = std::vector<std::byte>();
+    for (const auto character : std::string_view("GET /status HTTP/1.1\r\n")) {
+        frame.push_back(static_cast<std::byte>(character));
+    }
+    for (auto value = 0; value < 18; ++value) {
+        frame.push_back(static_cast<std::byte>(value * 15));
+    }
+
+    auto config = Logger::Config();
+    config.format = OutputFormat::Terminal;
+    config.fields.includeProcessId = false;
+    {
+        auto logger = Logger::Create(config, Logger::Context{ .appName = "Proxy" });
+        logger->DebugHex("frame", frame);
+        logger->DebugHex("frame", frame, 16);
+    }
+
+    auto collector = std::make_shared<CapturingNetworkAdapter>();
+    config = MakeProfileConfig(LogProfile::Json);
+    config.logToConsole = false;
+    config.networkAdapter = collector;
+    config.binaryEncoding = BinaryEncoding::Base64;
+    {
+        auto logger = Logger::Create(config, Logger::Context{ .appName = "Proxy" });
+        logger->DebugHex("frame", frame);
+        std::cout << "Base64: " << collector->last;
+    }
+
+    // Encoding on the backend against a hex string built at the call site
+    constexpr auto records = 2000;
+    const auto block = std::vector<std::byte>(512, std::byte{ 0xa5 });
+    config = MakeProfileConfig(LogProfile::Json);
+    config.logToConsole = false;
+    config.asyncMode = Logger::Mode::Async;
+    auto logger = Logger::Create(config, Logger::Context{ .appName = "Proxy" });
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto index = 0; index < records; ++index) {
+        auto text = std::string();
+        for (const auto byte : block) {
+            text += fmt::format("{:02x}", static_cast<unsigned>(byte));
+        }
+        logger->Debug("block {}", text);
+    }
+    const auto byHand = std::chrono::steady_clock::now() - start;
+    logger->Flush();
+
+    start = std::chrono::steady_clock::now();
+    for (auto index = 0; index < records; ++index) {
+        logger->DebugHex("block", block);
+    }
+    const auto lazy = std::chrono::steady_clock::now() - start;
+    logger->Flush();
+
+    logger->SetLevel(LogLevel::Info);
+    start = std::chrono::steady_clock::now();
+    for (auto index = 0; index < records; ++index) {
+        logger->DebugHex("block", block);
+    }
+    const auto disabled = std::chrono::steady_clock::now() - start;
+
+    const auto toMicroseconds = [](auto duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    };
+    std::cout << "Call site time for " << records << " blocks: hex built by hand "
+              << toMicroseconds(byHand) << "us, DebugHex " << toMicroseconds(lazy)
+              << "us, level disabled " << toMicroseconds(disabled) << "us" << std::endl;
+}
+
+void sampleStructuredFields()
+{
+    std::cout << "\n=== Structured Fields Sample ===" << std::endl;
+
+    auto ids = std::vector<int>(100000);
+    std::iota(ids.begin(), ids.end(), 1);
+    const auto shards = std::map<std::string, int>{ { "eu", 12 }, { "us", 30 }, { "ap", 7 } };
+
+    auto config = MakeProfileConfig(LogProfile::Json);
+    config.fields.includeProcessId = false;
+    {
+        auto logger = Logger::Create(config, Logger::Context{ .appName = "Indexer" });
+        logger->Info("Batch {} indexed", 42, kv("ids", limited(ids, 8)),
+                     kv("shards", limited(shards, 2)), kv("complete", true));
+    }
+    config.format = OutputFormat::Logfmt;
+    {
+        auto logger = Logger::Create(config, Logger::Context{ .appName = "Indexer" });
+        logger->Info("Batch {} indexed", 42, kv("ids", limited(ids, 4)), kv("owner", "search"));
+    }
+
+    // The whole container formatted into the message against its first 16 elements as a field
+    constexpr auto records = 50;
+    auto collector = std::make_shared<CapturingNetworkAdapter>();
+    config = MakeProfileConfig(LogProfile::Json);
+    config.logToConsole = false;
+    config.networkAdapter = collector;
+    config.asyncMode = Logger::Mode::Async;
+    const auto timeRecords = [&config](const auto & logRecord) {
+        auto logger = Logger::Create(config, Logger::Context{ .appName = "Indexer" });
+        const auto start = std::chrono::steady_clock::now();
+        for (auto index = 0; index < records; ++index) {
+            logRecord(*logger);
+        }
+        return std::chrono::steady_clock::now() - start;
+    };
+
+    const auto whole =
+        timeRecords([&ids](Logger & logger) { logger.Info("ids [{}]", fmt::join(ids, ",")); });
+    const auto wholeBytes = collector->last.size();
+    const auto bounded =
+        timeRecords([&ids](Logger & logger) { logger.Info("ids", kv("ids", limited(ids, 16))); });
+
+    const auto toMicroseconds = [](auto duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    };
+    std::cout << "Call site time for " << records << " records of " << ids.size()
+              << " ids: whole " << toMicroseconds(whole) << "us (" << wholeBytes
+              << " byte records), limited " << toMicroseconds(bounded) << "us ("
+              << collector->last.size() << " byte records)" << std::endl;
+}
+
+void sampleLazyArguments()
+{
+    std::cout << "\n=== Lazy Arguments Sample ===" << std::endl;
+
+    auto dumps = 0;
+    const auto dumpState = [&dumps] {
+        ++dumps;
+        auto state = std::string();
+        for (auto index = 0; index < 64; ++index) {
+            state += fmt::format("s{}=idle;", index);
+        }
+        return state;
+    };
+
+    auto config = Logger::Config();
+    config.fields.includeProcessId = false;
+    auto logger = Logger::Create(config, Logger::Context{ .appName = "Machine" });
+    logger->SetLevel(LogLevel::Info);
+
+    constexpr auto records = 10000;
+    for (auto index = 0; index < records; ++index) {
+        logger->Debug("State {}", lazy(dumpState));
+    }
+    std::cout << "Debug disabled: " << records << " records, " << dumps << " state dumps"
+              << std::endl;
+
+    const auto payload = std::string_view("frame payload");
+    const auto checksum = [payload] {
+        return std::accumulate(payload.begin(), payload.end(), 0U);
+    };
+    logger->Info("Frame sent", kv("checksum", lazy(checksum)), kv("bytes", payload.size()));
+
+    // Guard code that is more than one argument
+    logger->SetLevel(LogLevel::Debug);
+    if (logger->IsEnabled(LogLevel::Debug)) {
+        const auto state = dumpState();
+        logger->Debug("State has {} bytes", state.size());
+    }
+    std::cout << "State dumps after enabling Debug: " << dumps << std::endl;
+}
+
 void sampleCopyConfig()
 {
     std::cout << "\n=== Copy Config Sample ===" << std::endl;
@@ -404,6 +1105,895 @@ void sampleProfiles()
     json->Warning("Latency spike: {}ms", 250);
 }
 
+void sampleRuntimeReconfiguration()
+{
+    std::cout << "\n=== Runtime Reconfiguration Sample ===" << std::endl;
+
+    const auto context = Logger::Context{ .appName = "ReconfigApp", .moduleName = "Main" };
+    auto logger = kvalog::CreateLogger(LogProfile::Default, context);
+
+    auto running = std::atomic<bool>(true);
+    auto worker = std::thread([&logger, &running]() {
+        auto iteration = 0;
+        while (running.load()) {
+            logger->Info("Worker iteration {}", iteration++);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    });
+
+    // Writers publish new snapshots while the worker keeps logging without locks
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    logger->SetOutputFormat(OutputFormat::Json);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    logger->SetFieldConfig(MakeProfileConfig(LogProfile::Minimal).fields);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    running.store(false);
+    worker.join();
+}
+
+void sampleTerminalPatterns()
+{
+    std::cout << "\n=== Terminal Patterns Sample ===" << std::endl;
+
+    const auto context = Logger::Context{ .appName = "PatternApp", .moduleName = "Net" };
+
+    // Parsed once during compilation; a malformed pattern fails to build
+    auto config = MakeProfileConfig(LogProfile::Verbose);
+    config.terminalPattern =
+        TerminalPattern::Compile<"{time} {level:>5} [{module:^7}] {file}: {msg}">();
+
+    auto logger = Logger::Create(config, context);
+    logger->Info("Listening on port {}", 8080);
+    logger->Warning("Slow handshake with {}", "10.0.0.7");
+
+    // Parsed once when set, never per record
+    logger->SetTerminalPattern(TerminalPattern::Parse("{{{pid}/{tid:0>8}}} {level} {msg}"));
+    logger->Info("Runtime pattern applied");
+
+    logger->SetTerminalPattern(std::nullopt);
+    logger->Info("Back to the default layout");
+}
+
+void sampleTscClock()
+{
+    std::cout << "\n=== TSC Clock Sample ===" << std::endl;
+
+    if (!TscClock::IsInvariant()) {
+        std::cout << "No invariant TSC, ClockSource::Tsc falls back to the coarse realtime clock"
+                  << std::endl;
+    } else {
+        constexpr auto iterations = 100000;
+        auto & clock = TscClock::Instance();
+
+        // Call-site cost of each clock
+        const auto measure = [](auto && read) {
+            const auto start = std::chrono::steady_clock::now();
+            auto sink = std::uint64_t(0);
+            for (auto i = 0; i < iterations; ++i) {
+                sink += static_cast<std::uint64_t>(read());
+            }
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            static_cast<void>(sink);
+            return static_cast<double>(
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+                   iterations;
+        };
+        std::cout << "rdtsc:             " << measure(TscClock::ReadTicks) << " ns/read"
+                  << std::endl;
+        std::cout << "realtime coarse:   " << measure(TscClock::ReadCoarseNanoseconds)
+                  << " ns/read" << std::endl;
+        std::cout << "system_clock::now: " << measure(TscClock::ReadRealtimeNanoseconds)
+                  << " ns/read" << std::endl;
+
+        // Conversion error against the realtime clock read right after the TSC
+        auto maxError = std::int64_t(0);
+        auto totalError = std::int64_t(0);
+        for (auto i = 0; i < iterations; ++i) {
+            const auto ticks = TscClock::ReadTicks();
+            const auto realtime = TscClock::ReadRealtimeNanoseconds();
+            const auto error = std::abs(clock.ToNanoseconds(ticks) - realtime);
+            maxError = std::max(maxError, error);
+            totalError += error;
+        }
+
+        const auto calibration = clock.GetCalibration();
+        std::cout << "TSC frequency:     " << 1.0 / calibration.nanosecondsPerTick << " GHz"
+                  << std::endl;
+        std::cout << "anchor error:      " << calibration.anchorErrorNanoseconds << " ns"
+                  << std::endl;
+        std::cout << "conversion error:  mean " << totalError / iterations << " ns, max "
+                  << maxError << " ns" << std::endl;
+    }
+
+    auto config = MakeProfileConfig(LogProfile::Detailed);
+    config.clock = ClockSource::Tsc;
+
+    const auto context = Logger::Context{ .appName = "TscApp", .moduleName = "Main" };
+    auto logger = Logger::Create(config, context);
+    logger->Info("Timestamped with rdtsc, converted where the record is formatted");
+}
+
+void sampleTimestampStyles()
+{
+    std::cout << "\n=== Timestamp Styles Sample ===" << std::endl;
+
+    const auto context = Logger::Context{ .appName = "TimeApp", .moduleName = "Main" };
+    auto logger = kvalog::CreateLogger(LogProfile::Json, context);
+
+    auto fields = MakeProfileConfig(LogProfile::Json).fields;
+    fields.includeFile = false;
+    fields.includeProcessId = false;
+    fields.includeThreadId = false;
+
+    for (const auto style :
+         { TimestampStyle::Local, TimestampStyle::UtcIso8601, TimestampStyle::Rfc3339,
+           TimestampStyle::EpochSeconds, TimestampStyle::EpochMilliseconds,
+           TimestampStyle::EpochMicroseconds, TimestampStyle::EpochNanoseconds }) {
+        fields.timestampStyle = style;
+        logger->SetFieldConfig(fields);
+        logger->Info("Timestamp style {}", static_cast<int>(style));
+    }
+}
+
+void sampleCompactJsonBenchmark()
+{
+    std::cout << "\n=== Compact JSON Benchmark ===" << std::endl;
+
+    constexpr auto iterations = 200000;
+    const auto context = Logger::Context{ .appName = "BenchApp", .moduleName = "Orders" };
+
+    const auto run = [&context](LogProfile profile, const char * name) {
+        auto adapter = std::make_shared<CountingNetworkAdapter>();
+        auto config = MakeProfileConfig(profile);
+        config.logToConsole = false;
+        config.networkAdapter = adapter;
+        auto logger = Logger::Create(config, context);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i < iterations; ++i) {
+            logger->Info("Order {} accepted for customer {}", i, 4242);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        // Records reach the adapter with their trailing line terminator
+        const auto bytesPerRecord =
+            static_cast<double>(adapter->bytes) / static_cast<double>(adapter->records);
+        const auto nanosecondsPerRecord =
+            static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+            iterations;
+        std::cout << name << ": " << bytesPerRecord << " bytes/record, " << nanosecondsPerRecord
+                  << " ns/record" << std::endl;
+    };
+
+    run(LogProfile::Json, "Json       ");
+    run(LogProfile::CompactJson, "CompactJson");
+
+    std::cout << "\n--- CompactJson output ---" << std::endl;
+    auto compact = kvalog::CreateLogger(LogProfile::CompactJson, context);
+    compact->Warning("Order {} rejected", 17);
+}
+
+void sampleLogfmt()
+{
+    std::cout << "\n=== Logfmt Sample ===" << std::endl;
+
+    auto config = MakeProfileConfig(LogProfile::Verbose);
+    config.format = OutputFormat::Logfmt;
+    config.keys.message = "msg";
+
+    const auto context = Logger::Context{ .appName = "LogfmtApp", .moduleName = "net" };
+    auto logger = Logger::Create(config, context);
+
+    logger->Info("connected");
+    logger->Warning("peer {} sent \"{}\"", "10.0.0.7", "bad=frame");
+
+    auto fields = config.fields;
+    fields.timestampStyle = TimestampStyle::UtcIso8601;
+    logger->SetFieldConfig(fields);
+    logger->Error("handshake timeout");
+}
+
+void sampleMessagePack()
+{
+    std::cout << "\n=== MessagePack Sample ===" << std::endl;
+
+    const auto context = Logger::Context{ .appName = "BinaryApp", .moduleName = "Collector" };
+    const auto capture = [&context](OutputFormat format) {
+        auto adapter = std::make_shared<CapturingNetworkAdapter>();
+        auto config = MakeProfileConfig(LogProfile::Json);
+        config.format = format;
+        config.logToConsole = false;
+        config.networkAdapter = adapter;
+        config.fields.timestampStyle = TimestampStyle::EpochMilliseconds;
+        config.json.numericIds = true;
+
+        auto logger = Logger::Create(config, context);
+        logger->Info("Order {} \"shipped\"\tto {}", 17, "Zürich");
+        return adapter->last;
+    };
+
+    const auto json = capture(OutputFormat::Json);
+    const auto binary = capture(OutputFormat::MessagePack);
+
+    // Round trip: the decoded map matches the JSON record field for field, time aside
+    auto decoded = nlohmann::json::from_msgpack(binary);
+    auto expected = nlohmann::json::parse(json);
+    decoded.erase("time");
+    expected.erase("time");
+
+    std::cout << "JSON:        " << json.size() << " bytes" << std::endl;
+    std::cout << "MessagePack: " << binary.size() << " bytes" << std::endl;
+    std::cout << "Decoded:     " << nlohmann::json::from_msgpack(binary).dump() << std::endl;
+    std::cout << "Round trip:  " << (decoded == expected ? "match" : "MISMATCH") << std::endl;
+    check(decoded == expected, "MessagePack record decodes to the JSON record");
+}
+
+void sampleOtlp()
+{
+    std::cout << "\n=== OTLP Sample ===" << std::endl;
+
+    auto config = MakeProfileConfig(LogProfile::Json);
+    config.format = OutputFormat::Otlp;
+    config.logToConsole = false;
+    config.networkAdapter = std::make_shared<OtlpCollectorAdapter>();
+    config.networkBatching = NetworkBatching{ .maxRecords = 4,
+                                              .maxBytes = 64 * 1024,
+                                              .maxDelay = std::chrono::milliseconds(50) };
+
+    const auto context = Logger::Context{ .appName = "OtlpApp", .moduleName = "checkout" };
+    auto logger = Logger::Create(config, context);
+
+    for (auto i = 0; i < 6; ++i) {
+        logger->Info("Cart {} checked out", i);
+    }
+    logger->Error("Payment gateway returned {}", 502);
+
+    // The last partial batch goes out after maxDelay or on flush
+    logger->Flush();
+}
+
+void sampleSocketAdapters()
+{
+#if defined(__linux__)
+    std::cout << "\n=== Socket Adapters Sample ===" << std::endl;
+
+    constexpr auto recordCount = 2000;
+    constexpr auto paceRecords = 100;
+    const auto context = Logger::Context{ .appName = "SocketApp", .moduleName = "Shipping" };
+
+    const auto run = [&context](const std::string & name, const SocketOptions & options,
+                                LoopbackListener & listener) {
+        auto adapter = SocketNetworkAdapter::Create(options);
+        {
+            auto config = MakeProfileConfig(LogProfile::Json);
+            config.logToConsole = false;
+            config.networkAdapter = adapter;
+            auto logger = Logger::Create(config, context);
+            for (auto i = 0; i < recordCount; ++i) {
+                logger->Info("Parcel {} dispatched", i);
+                // UDP has no flow control, so let the listener catch up before its receive
+                // buffer overflows
+                for (auto wait = 0; (i + 1) % paceRecords == 0 && wait < 1000 &&
+                                    listener.records < static_cast<std::size_t>(i + 1);
+                     ++wait) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        }
+
+        // The sender thread writes in the background; wait for it to catch up
+        auto statistics = adapter->GetStatistics();
+        for (auto attempt = 0;
+             attempt < 100 && statistics.sentRecords + statistics.droppedRecords < recordCount;
+             ++attempt) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            statistics = adapter->GetStatistics();
+        }
+        const auto connected = adapter->IsConnected();
+        adapter.reset();
+        listener.Stop();
+
+        std::cout << name << ": connected=" << connected << ", sent=" << statistics.sentRecords
+                  << ", dropped=" << statistics.droppedRecords
+                  << ", listener received=" << listener.records << " records, "
+                  << listener.bytes << " bytes" << std::endl;
+
+        // Every record arrives once, in order and intact
+        check(connected, name + " adapter connected");
+        check(statistics.sentRecords == recordCount && statistics.droppedRecords == 0,
+              name + " adapter sent every record");
+        auto lines = std::istringstream(listener.data);
+        auto line = std::string();
+        auto received = 0;
+        auto intact = 0;
+        while (std::getline(lines, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            const auto record = nlohmann::json::parse(line, nullptr, false);
+            if (!record.is_discarded() && record.value("message", std::string()) ==
+                                              fmt::format("Parcel {} dispatched", received)) {
+                intact += 1;
+            }
+            received += 1;
+        }
+        check(received == recordCount, name + " listener received every record");
+        check(intact == received, name + " records intact and in order");
+    };
+
+    auto tcp = LoopbackListener(SocketTransport::Tcp);
+    run("TCP ", SocketOptions::Tcp("127.0.0.1", tcp.port), tcp);
+
+    // UDP gives no delivery guarantee; paced as above, nothing is lost on loopback
+    auto udp = LoopbackListener(SocketTransport::Udp);
+    run("UDP ", SocketOptions::Udp("127.0.0.1", udp.port), udp);
+
+    const auto socketPath = std::string("/tmp/kvalog_sample.sock");
+    auto unixStream = LoopbackListener(SocketTransport::UnixStream, socketPath);
+    run("Unix", SocketOptions::Unix(socketPath), unixStream);
+
+    // Reconnect: the adapter starts without a listener and connects once one appears
+    auto options = SocketOptions::Unix(socketPath);
+    options.reconnectDelay = std::chrono::milliseconds(20);
+    auto adapter = SocketNetworkAdapter::Create(options);
+    std::cout << "Before listener: connected=" << adapter->IsConnected() << std::endl;
+    auto late = LoopbackListener(SocketTransport::UnixStream, socketPath);
+    for (auto attempt = 0; attempt < 50 && !adapter->IsConnected(); ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::cout << "After listener:  connected=" << adapter->IsConnected()
+              << ", connects=" << adapter->GetStatistics().connects << std::endl;
+    check(adapter->IsConnected() && adapter->GetStatistics().connects == 1,
+          "Adapter connected once the listener appeared");
+    adapter.reset();
+#endif
+}
+
+void sampleSyslogAndGelf()
+{
+#if defined(__linux__)
+    std::cout << "\n=== Syslog and GELF Sample ===" << std::endl;
+
+    const auto context = Logger::Context{ .appName = "LegacyApp", .moduleName = "billing" };
+
+    // Syslog collector stand-in: TCP with RFC 6587 octet counting
+    const auto listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    auto address = sockaddr_in{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    auto length = socklen_t(sizeof(address));
+    getsockname(listenFd, reinterpret_cast<sockaddr *>(&address), &length);
+    listen(listenFd, 1);
+
+    {
+        auto options = SocketOptions::Tcp("127.0.0.1", ntohs(address.sin_port));
+        options.framing = SocketFraming::OctetCounting;
+
+        auto config = MakeProfileConfig(LogProfile::Verbose);
+        config.format = OutputFormat::Syslog;
+        config.syslogFacility = SyslogFacility::Local0;
+        config.logToConsole = false;
+        config.networkAdapter = SocketNetworkAdapter::Create(options);
+
+        auto logger = Logger::Create(config, context);
+        logger->Info("Invoice {} issued", 1001);
+        logger->Error("Payment for invoice {} failed: \"card declined\"", 1002);
+    }
+
+    const auto connection = accept(listenFd, nullptr, nullptr);
+    auto stream = std::string();
+    auto buffer = std::array<char, 4096>();
+    for (auto received = recv(connection, buffer.data(), buffer.size(), 0); received > 0;
+         received = recv(connection, buffer.data(), buffer.size(), 0)) {
+        stream.append(buffer.data(), static_cast<std::size_t>(received));
+    }
+    close(connection);
+    close(listenFd);
+
+    auto frames = std::vector<std::string>();
+    for (auto position = std::size_t(0); position < stream.size();) {
+        const auto space = stream.find(' ', position);
+        if (space == std::string::npos) {
+            break;
+        }
+        const auto frameLength = std::stoul(stream.substr(position, space - position));
+        frames.push_back(stream.substr(space + 1, frameLength));
+        std::cout << "[syslog collector] " << frames.back() << std::endl;
+        position = space + 1 + frameLength;
+    }
+    check(frames.size() == 2, "Syslog collector received both frames");
+    check(frames.size() == 2 && frames[0].starts_with("<134>1 ") &&
+              frames[0].ends_with("] Invoice 1001 issued"),
+          "Syslog info frame intact");
+    check(frames.size() == 2 && frames[1].starts_with("<131>1 ") &&
+              frames[1].ends_with("] Payment for invoice 1002 failed: \"card declined\""),
+          "Syslog error frame intact");
+
+    // GELF collector stand-in: UDP with chunked messages reassembled by message id
+    const auto gelfFd = socket(AF_INET, SOCK_DGRAM, 0);
+    address.sin_port = 0;
+    bind(gelfFd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    length = socklen_t(sizeof(address));
+    getsockname(gelfFd, reinterpret_cast<sockaddr *>(&address), &length);
+
+    {
+        auto options = SocketOptions::Udp("127.0.0.1", ntohs(address.sin_port));
+        options.gelfChunkSize = 256;
+
+        auto config = MakeProfileConfig(LogProfile::Verbose);
+        config.format = OutputFormat::Gelf;
+        config.logToConsole = false;
+        config.networkAdapter = SocketNetworkAdapter::Create(options);
+
+        auto logger = Logger::Create(config, context);
+        logger->Warning("Retrying invoice {}", 1002);
+        logger->Info("Batch report: {}", std::string(600, '#'));
+    }
+
+    auto timeout = timeval{ .tv_sec = 0, .tv_usec = 200000 };
+    setsockopt(gelfFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    auto chunks = std::map<std::string, std::map<int, std::string>>();
+    auto messages = std::vector<nlohmann::json>();
+    auto datagram = std::array<char, 65536>();
+    for (auto received = recv(gelfFd, datagram.data(), datagram.size(), 0); received > 0;
+         received = recv(gelfFd, datagram.data(), datagram.size(), 0)) {
+        auto message = std::string(datagram.data(), static_cast<std::size_t>(received));
+        if (message.size() < 12 || message[0] != 0x1e || message[1] != 0x0f) {
+            messages.push_back(nlohmann::json::parse(message, nullptr, false));
+            std::cout << "[GELF collector] " << messages.back().dump() << std::endl;
+            continue;
+        }
+
+        const auto count = static_cast<std::size_t>(static_cast<unsigned char>(message[11]));
+        auto & parts = chunks[message.substr(2, 8)];
+        parts[static_cast<unsigned char>(message[10])] = message.substr(12);
+        if (parts.size() == count) {
+            auto whole = std::string();
+            for (const auto & [sequence, part] : parts) {
+                whole += part;
+            }
+            messages.push_back(nlohmann::json::parse(whole, nullptr, false));
+            std::cout << "[GELF collector] reassembled " << count << " chunks: level "
+                      << messages.back().value("level", 0) << ", short_message of "
+                      << messages.back().value("short_message", std::string()).size()
+                      << " bytes" << std::endl;
+        }
+    }
+    close(gelfFd);
+
+    check(messages.size() == 2, "GELF collector received both messages");
+    check(messages.size() == 2 && messages[0].value("level", 0) == 4 &&
+              messages[0].value("short_message", std::string()) == "Retrying invoice 1002",
+          "GELF warning intact");
+    check(messages.size() == 2 && messages[1].value("level", 0) == 6 &&
+              messages[1].value("short_message", std::string()) ==
+                  "Batch report: " + std::string(600, '#'),
+          "GELF chunked message reassembled intact");
+#endif
+}
+
+void sampleSharedRing()
+{
+#if defined(__linux__)
+    std::cout << "\n=== Shared Ring Sample ===" << std::endl;
+
+    const auto path = std::string("/dev/shm/kvalog_sample.ring");
+    const auto context = Logger::Context{ .appName = "RingApp", .moduleName = "Matching" };
+
+    auto config = MakeProfileConfig(LogProfile::CompactJson);
+    config.logToConsole = false;
+    config.networkAdapter = SharedRingAdapter::Create(path, 64 * 1024);
+    auto logger = Logger::Create(config, context);
+
+    // The shipper would normally be the kvalog_shipper process; here it is a reader in-process
+    auto forwarded = std::size_t(0);
+    auto first = std::string();
+    const auto forward = [&forwarded, &first](std::string_view record) {
+        if (forwarded++ == 0) {
+            first = record;
+        }
+    };
+
+    for (auto i = 0; i < 200; ++i) {
+        logger->Info("Order {} matched", i);
+    }
+    {
+        auto shipper = SharedRing::Attach(path);
+        shipper->Poll(forward, 150);
+        std::cout << "Shipper forwarded " << forwarded << ", then stopped with "
+                  << shipper->Backlog() << " bytes unread" << std::endl;
+    }
+
+    // The logger keeps writing while no shipper runs; a full ring drops instead of blocking
+    for (auto i = 200; i < 2000; ++i) {
+        logger->Info("Order {} matched", i);
+    }
+
+    auto restarted = SharedRing::Attach(path);
+    restarted->Poll(forward, std::numeric_limits<std::size_t>::max());
+    std::cout << "Restarted shipper resumed, forwarded " << forwarded << " in total, dropped "
+              << restarted->Header().droppedRecords.load() << std::endl;
+    std::cout << "First record: " << first;
+
+    logger.reset();
+    unlink(path.c_str());
+#endif
+}
+
+#if defined(__linux__)
+/// @brief Streaming consumer: moves everything from the pipe into a file without copying it
+/// through user space, until the write end is closed
+std::size_t splicePipeInto(int pipeReadFd, int outputFd)
+{
+    auto total = std::size_t(0);
+    for (;;) {
+        const auto moved = splice(pipeReadFd, nullptr, outputFd, nullptr, std::size_t(1) << 20,
+                                  SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (moved <= 0) {
+            return total;
+        }
+        total += static_cast<std::size_t>(moved);
+    }
+}
+#endif
+
+void samplePipe()
+{
+#if defined(__linux__)
+    std::cout << "\n=== Pipe Sample ===" << std::endl;
+
+    const auto context = Logger::Context{ .appName = "PipeApp", .moduleName = "Ingest" };
+    const auto path = std::string("/tmp/kvalog_pipe_sample.log");
+
+    auto ends = std::array<int, 2>();
+    if (pipe2(ends.data(), O_CLOEXEC) != 0) {
+        return;
+    }
+    const auto output = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    auto spliced = std::size_t(0);
+    auto consumer = std::thread([&spliced, &ends, output] {
+        spliced = splicePipeInto(ends[0], output);
+    });
+
+    {
+        auto config = MakeProfileConfig(LogProfile::CompactJson);
+        config.logToConsole = false;
+        config.networkAdapter = PipeAdapter::Create(PipeOptions{ .fd = ends[1] });
+        auto logger = Logger::Create(config, context);
+        for (auto i = 0; i < 1000; ++i) {
+            logger->Info("Chunk {} ingested", i);
+        }
+    }
+    close(ends[1]);
+    consumer.join();
+    close(ends[0]);
+    close(output);
+    std::cout << "Consumer spliced " << spliced << " bytes into " << path << std::endl;
+
+    // Throughput of vmsplice staging against a plain write of the same payloads; small records
+    // only benefit once NetworkBatching hands the adapter several of them at a time
+    constexpr auto totalBytes = std::size_t(256) << 20;
+    const auto run = [totalBytes](std::size_t recordSize, std::size_t batch, bool useVmsplice) {
+        auto fds = std::array<int, 2>();
+        pipe2(fds.data(), O_CLOEXEC);
+        fcntl(fds[1], F_SETPIPE_SZ, 1 << 20);
+        const auto sink = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        auto drain = std::thread([&fds, sink] { splicePipeInto(fds[0], sink); });
+
+        auto payload = std::string();
+        for (auto i = std::size_t(0); i < batch; ++i) {
+            payload += std::string(recordSize - 1, 'x') + "\n";
+        }
+        const auto calls = totalBytes / payload.size();
+        auto adapter = PipeAdapter::Create(PipeOptions{ .fd = fds[1] });
+        const auto start = std::chrono::steady_clock::now();
+        for (auto i = std::size_t(0); i < calls; ++i) {
+            if (useVmsplice) {
+                adapter->SendLog(payload);
+            } else if (write(fds[1], payload.data(), payload.size()) < 0) {
+                break;
+            }
+        }
+        const auto elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+        adapter.reset();
+        close(fds[1]);
+        drain.join();
+        close(fds[0]);
+        close(sink);
+        return static_cast<int>(static_cast<double>(calls * payload.size()) / (1 << 20) /
+                                elapsed.count());
+    };
+
+    const auto report = [&run](const char * name, std::size_t recordSize, std::size_t batch) {
+        const auto written = run(recordSize, batch, false);
+        const auto vmspliced = run(recordSize, batch, true);
+        std::cout << name << ": write " << written << " MB/s, vmsplice " << vmspliced << " MB/s"
+                  << std::endl;
+    };
+    report("256 B records        ", 256, 1);
+    report("256 B records x 128  ", 256, 128);
+    report("32 KiB records       ", 32768, 1);
+#endif
+}
+
+void sampleColumnarSegments()
+{
+    std::cout << "\n=== Columnar Segments Sample ===" << std::endl;
+
+    constexpr auto recordsPerModule = 30000;
+    const auto directory = std::filesystem::temp_directory_path() / "kvalog_columnar_sample";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    // Every logger writes its module to a JSON file and all of them into one columnar store
+    auto segments = ColumnarSegmentSink::Create(ColumnarOptions{ .directory = directory });
+    auto jsonFiles = std::vector<std::filesystem::path>();
+    {
+        auto loggers = std::vector<LoggerPtr>();
+        for (const auto * module : { "Orders", "Payments", "Shipping" }) {
+            auto config = MakeProfileConfig(LogProfile::Json);
+            config.logToConsole = false;
+            config.logFilePath = (directory / (std::string(module) + ".json")).string();
+            config.structuredSink = segments;
+            jsonFiles.emplace_back(*config.logFilePath);
+            loggers.push_back(
+                Logger::Create(config, Logger::Context{ .appName = "Shop", .moduleName = module }));
+        }
+
+        for (auto i = 0; i < recordsPerModule; ++i) {
+            loggers[0]->Info("Order {} accepted for customer {}", i, i % 977);
+            if (i % 50 == 0) {
+                loggers[1]->Error("Payment {} failed: gateway timeout after {} ms", i, 3000);
+            } else {
+                loggers[1]->Info("Payment {} captured", i);
+            }
+            loggers[2]->Debug("Parcel {} labelled", i);
+        }
+        for (const auto & logger : loggers) {
+            logger->Flush();
+        }
+    }
+
+    auto jsonBytes = std::uintmax_t(0);
+    for (const auto & file : jsonFiles) {
+        jsonBytes += std::filesystem::file_size(file);
+    }
+    auto columnarBytes = std::uintmax_t(0);
+    for (const auto & segment : segments->Segments()) {
+        columnarBytes += std::filesystem::file_size(segment);
+    }
+    std::cout << "JSON files: " << jsonBytes / 1024 << " KiB, columnar segments: "
+              << columnarBytes / 1024 << " KiB in " << segments->Segments().size() << " segments"
+              << std::endl;
+
+    // Errors of the Payments module mentioning a timeout
+    const auto jsonStart = std::chrono::steady_clock::now();
+    auto jsonMatches = 0;
+    for (const auto & file : jsonFiles) {
+        auto input = std::ifstream(file);
+        for (auto line = std::string(); std::getline(input, line);) {
+            const auto record = nlohmann::json::parse(line);
+            jsonMatches += record["level"] == "ERR" && record["module"] == "Payments" &&
+                           record["message"].get<std::string>().find("timeout") !=
+                               std::string::npos;
+        }
+    }
+    const auto jsonElapsed = std::chrono::steady_clock::now() - jsonStart;
+
+    const auto columnarStart = std::chrono::steady_clock::now();
+    auto columnarMatches = std::size_t(0);
+    const auto query = SegmentQuery{
+        .minLevel = LogLevel::Error, .module = "Payments", .contains = "timeout" };
+    for (const auto & segment : segments->Segments()) {
+        columnarMatches += ColumnarSegmentReader::Open(segment)->Select(query).size();
+    }
+    const auto columnarElapsed = std::chrono::steady_clock::now() - columnarStart;
+
+    const auto milliseconds = [](auto elapsed) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    };
+    std::cout << "JSON scan: " << jsonMatches << " matches in " << milliseconds(jsonElapsed)
+              << " ms, columnar scan: " << columnarMatches << " matches in "
+              << milliseconds(columnarElapsed) << " ms" << std::endl;
+
+    segments.reset();
+    std::filesystem::remove_all(directory);
+}
+
+void sampleFileIndex()
+{
+    std::cout << "\n=== File Index Sample ===" << std::endl;
+
+    constexpr auto records = 200000;
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto context = Logger::Context{ .appName = "IndexApp", .moduleName = "Payments" };
+    const auto now = [] {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    };
+
+    // The same records with and without an index, the difference is the cost of indexing
+    auto windowStart = std::int64_t(0);
+    auto windowEnd = std::int64_t(0);
+    const auto write = [&](const std::filesystem::path & path, std::size_t blockSize) {
+        auto config = MakeProfileConfig(LogProfile::CompactJson);
+        config.logToConsole = false;
+        config.logFilePath = path.string();
+        config.logFileIndex = FileIndexing{ .blockSize = blockSize };
+        auto logger = Logger::Create(config, context);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i < records; ++i) {
+            if (i == records / 2) {
+                windowStart = now();
+            }
+            if (i % 1000 == 0) {
+                logger->Error("Payment {} failed: gateway timeout", i);
+            } else {
+                logger->Info("Payment {} captured", i);
+            }
+            if (i == records / 2 + records / 100) {
+                windowEnd = now();
+            }
+        }
+        logger->Flush();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - start)
+                   .count() /
+               records;
+    };
+
+    const auto plainPath = directory / "kvalog_index_plain.log";
+    const auto indexedPath = directory / "kvalog_index_sample.log";
+    const auto plainCost = write(plainPath, 0);
+    const auto indexedCost = write(indexedPath, DefaultFileIndexBlockSize);
+    auto indexPath = indexedPath;
+    indexPath += FileIndexExtension;
+    std::cout << "Write cost: " << plainCost << " ns/record plain, " << indexedCost
+              << " ns/record indexed; index of " << std::filesystem::file_size(indexPath)
+              << " bytes for " << std::filesystem::file_size(indexedPath) / 1024
+              << " KiB of log" << std::endl;
+
+    // Errors within a 1% time window, found by scanning the whole file and by the index
+    const auto isError = [](std::string_view line) {
+        return line.find("\"l\":5") != std::string_view::npos;
+    };
+    auto scanned = 0;
+    auto scannedErrors = 0;
+    {
+        auto input = std::ifstream(indexedPath);
+        for (auto line = std::string(); std::getline(input, line); ++scanned) {
+            scannedErrors += isError(line);
+        }
+    }
+
+    const auto index = LogFileIndex::Open(indexedPath);
+    const auto ranges = index->Ranges(FileIndexQuery{
+        .minLevel = LogLevel::Error, .since = windowStart, .until = windowEnd });
+    auto visited = 0;
+    auto windowErrors = 0;
+    index->ForEachLine(ranges, [&visited, &windowErrors, &isError](std::string_view line) {
+        ++visited;
+        windowErrors += isError(line);
+    });
+    std::cout << "Full scan: " << scanned << " lines, " << scannedErrors << " errors; index: "
+              << index->Blocks().size() << " blocks, " << ranges.size() << " ranges, " << visited
+              << " lines read, " << windowErrors << " errors near the window" << std::endl;
+
+    std::filesystem::remove(plainPath);
+    std::filesystem::remove(indexedPath);
+    std::filesystem::remove(indexPath);
+}
+
+void sampleTextQuery()
+{
+#if defined(__linux__)
+    std::cout << "\n=== Text Query Sample ===" << std::endl;
+
+    constexpr auto records = 100000;
+    const auto path = std::filesystem::temp_directory_path() / "kvalog_query_sample.log";
+    {
+        auto config = MakeProfileConfig(LogProfile::Json);
+        config.logToConsole = false;
+        config.logFilePath = path.string();
+        auto logger =
+            Logger::Create(config, Logger::Context{ .appName = "Shop", .moduleName = "Payments" });
+        for (auto i = 0; i < records; ++i) {
+            if (i % 1000 == 0) {
+                logger->Error("Payment {} failed: gateway timeout", i);
+            } else {
+                logger->Info("Payment {} captured", i);
+            }
+        }
+    }
+
+    const auto milliseconds = [](auto elapsed) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / 1000.0;
+    };
+
+    // Parsing every record, what a jq pipeline does
+    const auto parseStart = std::chrono::steady_clock::now();
+    auto parsed = 0;
+    {
+        auto input = std::ifstream(path);
+        for (auto line = std::string(); std::getline(input, line);) {
+            const auto record = nlohmann::json::parse(line);
+            parsed += record["level"] == "ERR" && record["module"] == "Payments";
+        }
+    }
+    const auto parseElapsed = std::chrono::steady_clock::now() - parseStart;
+
+    // Locating the two keys in the mapped file, split across the cores
+    const auto scanStart = std::chrono::steady_clock::now();
+    const auto file = MappedFile::Open(path);
+    const auto filter = TextRecordFilter(
+        TextLogQuery{ .minLevel = LogLevel::Error, .module = "Payments" });
+    auto counts = std::vector<int>(std::max(1U, std::thread::hardware_concurrency()));
+    TextScan::ForEachLineParallel(file->View(), counts.size(),
+                                  [&filter, &counts](std::size_t part, std::string_view line) {
+                                      counts[part] += filter.Matches(line);
+                                  });
+    const auto scanElapsed = std::chrono::steady_clock::now() - scanStart;
+
+    std::cout << "Parsed JSON: " << parsed << " errors in " << milliseconds(parseElapsed)
+              << " ms, key scan: " << std::accumulate(counts.begin(), counts.end(), 0)
+              << " errors in " << milliseconds(scanElapsed) << " ms" << std::endl;
+
+    std::filesystem::remove(path);
+#endif
+}
+
+void sampleMergeInputs()
+{
+#if defined(__linux__)
+    std::cout << "\n=== Merge Inputs Sample ===" << std::endl;
+
+    // Two workers of one service, one writing JSON and the other the terminal layout
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto paths = std::array{ directory / "kvalog_merge_worker1.log",
+                                   directory / "kvalog_merge_worker2.log" };
+    for (auto worker = std::size_t(0); worker < paths.size(); ++worker) {
+        auto config = MakeProfileConfig(worker == 0 ? LogProfile::Json : LogProfile::Detailed);
+        config.logToConsole = false;
+        config.logFilePath = paths[worker].string();
+        auto logger =
+            Logger::Create(config, Logger::Context{ .appName = "Shop", .moduleName = "Worker" });
+        for (auto i = 0; i < 1000; ++i) {
+            logger->Info("Worker {} handled request {}", worker + 1, i);
+        }
+    }
+
+    // kvalog_merge needs every record timed and every file in time order on its own
+    for (const auto & path : paths) {
+        const auto file = MappedFile::Open(path);
+        auto timed = 0;
+        auto ordered = true;
+        auto last = std::int64_t(0);
+        TextScan::ForEachLine(file->View(), [&timed, &ordered, &last](std::string_view line) {
+            if (const auto time = TextScan::RecordTime(line)) {
+                timed += 1;
+                ordered = ordered && *time >= last;
+                last = *time;
+            }
+        });
+        std::cout << path.filename().string() << ": " << timed << " timed records, "
+                  << (ordered ? "in order" : "out of order") << std::endl;
+    }
+    std::cout << "Merge with: kvalog_merge " << paths[0].string() << " " << paths[1].string()
+              << std::endl;
+
+    for (const auto & path : paths) {
+        std::filesystem::remove(path);
+    }
+#endif
+}
+
 int main()
 {
     std::cout << "=== Unified Logger Samples ===" << std::endl;
@@ -414,6 +2004,15 @@ int main()
     sampleFileLogging();
     sampleNetworkLogging();
     sampleAsyncLogging();
+    sampleSequenceNumbers();
+    sampleSinkQueues();
+    sampleIdleStrategies();
+    sampleHugePages();
+    sampleMemoryBudget();
+    sampleMessageLimits();
+    sampleDebugHex();
+    sampleStructuredFields();
+    sampleLazyArguments();
     sampleCopyConfig();
     sampleMultipleSinks();
     sampleLogLevels();
@@ -421,8 +2020,28 @@ int main()
     sampleFormattedLogging();
     sampleFabricMethods();
     sampleProfiles();
+    sampleRuntimeReconfiguration();
+    sampleTerminalPatterns();
+    sampleTscClock();
+    sampleTimestampStyles();
+    sampleCompactJsonBenchmark();
+    sampleLogfmt();
+    sampleMessagePack();
+    sampleOtlp();
+    sampleSocketAdapters();
+    sampleSyslogAndGelf();
+    sampleSharedRing();
+    samplePipe();
+    sampleColumnarSegments();
+    sampleFileIndex();
+    sampleTextQuery();
+    sampleMergeInputs();
 
     std::cout << "\n=== All Samples Completed ===" << std::endl;
 
+    if (failedChecks > 0) {
+        std::cout << failedChecks << " sample checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
     return 0;
 }
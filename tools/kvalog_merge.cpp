@@ -0,0 +1,236 @@
+// kvalog_merge: merges kvalog log files by record time.
+//
+// Usage:
+//   kvalog_merge [--output PATH] FILE...
+//
+// Files may be written in the JSON or the terminal format, also mixed, each in time order as a
+// single logger writes it. Records are printed verbatim. Records with equal times are ordered by
+// their sequence number when they carry one, then by the order of the files on the command
+// line. Lines without a time, such as the continuation of a multi-line message, stay attached
+// to the record before them.
+//
+// Files are mapped and every file decodes its next batch of records on its own thread while the
+// current batch is merged, so memory stays at two batches per file.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "kvalog_reader.hpp"
+
+using namespace kvalog;
+
+namespace
+{
+
+/// @brief Records decoded per batch
+constexpr std::size_t BatchRecords = 8192;
+/// @brief Output buffer size
+constexpr std::size_t OutputBufferSize = std::size_t(1) << 20;
+/// @brief Sequence of records without one, after every numbered record of the same time
+constexpr auto NoSequence = std::numeric_limits<std::uint64_t>::max();
+
+/// @brief Record with its merge key
+struct DecodedRecord {
+    std::int64_t time = 0;
+    std::uint64_t sequence = NoSequence;
+    /// @brief The record line and its continuation lines, without the final newline
+    std::string_view text;
+};
+
+///
+/// @brief
+/// RecordStream walks the records of one mapped file, decoding the next batch in the background
+///
+class RecordStream
+{
+public:
+    RecordStream(const std::filesystem::path & path, std::size_t initialFileIndex)
+        : file(MappedFile::Open(path)), remaining(file->View()), fileIndex(initialFileIndex)
+    {
+        this->batch = this->decode();
+        this->next = std::async(std::launch::async, [this] { return this->decode(); });
+    }
+
+    RecordStream(const RecordStream &) = delete;
+    RecordStream & operator=(const RecordStream &) = delete;
+
+    ~RecordStream()
+    {
+        if (this->next.valid()) {
+            this->next.wait();
+        }
+    }
+
+    /// @brief Returns whether a current record exists
+    bool HasRecord() const
+    {
+        return this->position < this->batch.size();
+    }
+
+    /// @brief Returns the current record
+    const DecodedRecord & Current() const
+    {
+        return this->batch[this->position];
+    }
+
+    /// @brief Returns the position of the file on the command line
+    std::size_t FileIndex() const
+    {
+        return this->fileIndex;
+    }
+
+    /// @brief Moves to the next record, switching to the prefetched batch at the end of one
+    void Advance()
+    {
+        if (++this->position < this->batch.size()) {
+            return;
+        }
+        this->position = 0;
+        this->batch = this->next.get();
+        if (!this->batch.empty()) {
+            this->next = std::async(std::launch::async, [this] { return this->decode(); });
+        }
+    }
+
+private:
+    /// @brief Decodes the next batch of records from the unread part of the file
+    std::vector<DecodedRecord> decode()
+    {
+        auto records = std::vector<DecodedRecord>();
+        records.reserve(BatchRecords);
+
+        const auto * cursor = this->remaining.data();
+        const auto * end = this->remaining.data() + this->remaining.size();
+        while (cursor < end) {
+            const auto * newline = TextScan::FindNewline(cursor, end);
+            const auto line = std::string_view(cursor, static_cast<std::size_t>(newline - cursor));
+            const auto time = TextScan::RecordTime(line);
+
+            if (!time && !records.empty()) {
+                // A continuation line, the lines are contiguous in the mapping
+                auto & last = records.back();
+                last.text = std::string_view(last.text.data(),
+                                             static_cast<std::size_t>(newline - last.text.data()));
+            } else if (records.size() == BatchRecords) {
+                break;
+            } else {
+                this->lastTime = time.value_or(this->lastTime);
+                records.push_back(DecodedRecord{
+                    .time = this->lastTime,
+                    .sequence = TextScan::RecordSequence(line).value_or(NoSequence),
+                    .text = line });
+            }
+            cursor = std::min(end, newline + 1);
+        }
+
+        this->remaining = std::string_view(cursor, static_cast<std::size_t>(end - cursor));
+        return records;
+    }
+
+    /// @brief Mapped file
+    std::unique_ptr<MappedFile> file;
+    /// @brief Part of the file not decoded yet
+    std::string_view remaining;
+    /// @brief Position of the file on the command line
+    std::size_t fileIndex = 0;
+    /// @brief Time of the last timed record, inherited by records without one
+    std::int64_t lastTime = std::numeric_limits<std::int64_t>::min();
+
+    /// @brief Batch being merged and the position in it
+    std::vector<DecodedRecord> batch;
+    std::size_t position = 0;
+    /// @brief Batch decoded in the background
+    std::future<std::vector<DecodedRecord>> next;
+};
+
+/// @brief Orders streams by their current record, the earliest on top of the heap
+struct LaterRecord {
+    bool operator()(const RecordStream * left, const RecordStream * right) const
+    {
+        const auto & a = left->Current();
+        const auto & b = right->Current();
+        if (a.time != b.time) {
+            return a.time > b.time;
+        }
+        if (a.sequence != b.sequence) {
+            return a.sequence > b.sequence;
+        }
+        return left->FileIndex() > right->FileIndex();
+    }
+};
+
+void printUsage()
+{
+    std::cerr << "usage: kvalog_merge [--output PATH] FILE...\n";
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    auto outputPath = std::string();
+    auto paths = std::vector<std::filesystem::path>();
+    for (auto index = 1; index < argc; ++index) {
+        const auto argument = std::string(argv[index]);
+        if (argument == "--output" && index + 1 < argc) {
+            outputPath = argv[++index];
+        } else if (argument.starts_with("--")) {
+            printUsage();
+            return EXIT_FAILURE;
+        } else {
+            paths.emplace_back(argument);
+        }
+    }
+    if (paths.empty()) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    auto * output = outputPath.empty() ? stdout : std::fopen(outputPath.c_str(), "wb");
+    if (output == nullptr) {
+        std::perror(outputPath.c_str());
+        return EXIT_FAILURE;
+    }
+    std::setvbuf(output, nullptr, _IOFBF, OutputBufferSize);
+
+    auto streams = std::vector<std::unique_ptr<RecordStream>>();
+    auto heap = std::priority_queue<RecordStream *, std::vector<RecordStream *>, LaterRecord>();
+    for (const auto & path : paths) {
+        try {
+            streams.push_back(std::make_unique<RecordStream>(path, streams.size()));
+        } catch (const std::exception & error) {
+            std::cerr << "kvalog_merge: " << error.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (streams.back()->HasRecord()) {
+            heap.push(streams.back().get());
+        }
+    }
+
+    while (!heap.empty()) {
+        auto * stream = heap.top();
+        heap.pop();
+        const auto & record = stream->Current();
+        std::fwrite(record.text.data(), 1, record.text.size(), output);
+        std::fputc('\n', output);
+
+        stream->Advance();
+        if (stream->HasRecord()) {
+            heap.push(stream);
+        }
+    }
+
+    if (output != stdout) {
+        std::fclose(output);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,269 @@
+// kvalog_query: filters records stored in kvalog columnar segments and kvalog text logs.
+//
+// Usage:
+//   kvalog_query [--level LEVEL] [--app NAME] [--module NAME] [--since TIME] [--until TIME]
+//                [--grep TEXT] [--threads N] [--count] PATH...
+//
+// PATH is a segment file, a directory of segments, or a log file written in the JSON or the
+// terminal format. TIME is either milliseconds since the Unix epoch or a UTC time such as
+// 2025-10-06T21:58:46.529. Matching segment records are printed as JSON lines, matching text
+// records verbatim; with --count only their number is printed.
+//
+// Log files are mapped and scanned in parallel, and only the blocks selected by their .kvx
+// index when one exists. --grep matches the message of segment records and the whole line of
+// text records.
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "kvalog_columnar.hpp"
+#include "kvalog_reader.hpp"
+
+using namespace kvalog;
+
+namespace
+{
+
+struct Arguments {
+    SegmentQuery query;
+    bool countOnly = false;
+    std::size_t threads = std::max(1U, std::thread::hardware_concurrency());
+    std::vector<std::filesystem::path> paths;
+};
+
+void printUsage()
+{
+    std::cerr << "usage: kvalog_query [--level LEVEL] [--app NAME] [--module NAME] "
+                 "[--since TIME] [--until TIME] [--grep TEXT] [--threads N] [--count] PATH...\n";
+}
+
+std::optional<LogLevel> parseLevel(const std::string & name)
+{
+    constexpr auto names = std::array{ "trace", "debug", "info", "warning", "error", "critical" };
+    const auto position = std::find(names.begin(), names.end(), name);
+    if (position == names.end()) {
+        return std::nullopt;
+    }
+    return static_cast<LogLevel>(static_cast<int>(LogLevel::Trace) + (position - names.begin()));
+}
+
+/// @brief Parses milliseconds since the epoch or a time into nanoseconds since the epoch
+/// @note Times without an offset are UTC; fractions may have any number of digits
+std::optional<std::int64_t> parseTime(const std::string & text)
+{
+    if (!text.empty() && text.find_first_not_of("0123456789") == std::string::npos) {
+        return std::stoll(text) * 1'000'000;
+    }
+    if (text.size() < 19) {
+        return std::nullopt;
+    }
+
+    const auto zoned = text.find_first_of("Z+-", 19) != std::string::npos;
+    return TextScan::ParseTime(zoned ? text : text + "Z");
+}
+
+/// @brief Adds a file, or every segment of a directory in name order
+void addPaths(const std::filesystem::path & path, std::vector<std::filesystem::path> & output)
+{
+    if (!std::filesystem::is_directory(path)) {
+        output.push_back(path);
+        return;
+    }
+
+    auto segments = std::vector<std::filesystem::path>();
+    for (const auto & entry : std::filesystem::directory_iterator(path)) {
+        if (entry.is_regular_file() && entry.path().extension() == SegmentExtension) {
+            segments.push_back(entry.path());
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+    output.insert(output.end(), segments.begin(), segments.end());
+}
+
+std::optional<Arguments> parseArguments(int argc, char ** argv)
+{
+    auto arguments = Arguments();
+    for (auto index = 1; index < argc; ++index) {
+        const auto option = std::string(argv[index]);
+        if (option == "--count") {
+            arguments.countOnly = true;
+            continue;
+        }
+        if (!option.starts_with("--")) {
+            addPaths(option, arguments.paths);
+            continue;
+        }
+        if (index + 1 >= argc) {
+            return std::nullopt;
+        }
+
+        const auto value = std::string(argv[++index]);
+        if (option == "--level") {
+            arguments.query.minLevel = parseLevel(value);
+            if (!arguments.query.minLevel) {
+                return std::nullopt;
+            }
+        } else if (option == "--app") {
+            arguments.query.app = value;
+        } else if (option == "--module") {
+            arguments.query.module = value;
+        } else if (option == "--since" || option == "--until") {
+            const auto time = parseTime(value);
+            if (!time) {
+                return std::nullopt;
+            }
+            (option == "--since" ? arguments.query.since : arguments.query.until) = time;
+        } else if (option == "--grep") {
+            arguments.query.contains = value;
+        } else if (option == "--threads") {
+            arguments.threads = std::max(1UL, std::strtoul(value.c_str(), nullptr, 10));
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    if (arguments.paths.empty()) {
+        return std::nullopt;
+    }
+    return arguments;
+}
+
+/// @brief Prints the selected rows of a segment as JSON lines
+void printRows(const ColumnarSegmentReader & segment, const std::vector<std::uint32_t> & rows)
+{
+    constexpr auto levelNames =
+        std::array{ "off", "trace", "debug", "info", "warning", "error", "critical" };
+
+    const auto times = segment.Times();
+    const auto levels = segment.Levels();
+    const auto threads = segment.Threads();
+    const auto apps = segment.Apps();
+    const auto modules = segment.Modules();
+    const auto callSites = segment.CallSites();
+    const auto messages = segment.Messages();
+
+    for (const auto row : rows) {
+        const auto & site = callSites.sites[callSites.ids[row]];
+        const auto seconds = static_cast<std::time_t>(times[row] / 1'000'000'000);
+        auto parts = std::tm();
+        gmtime_r(&seconds, &parts);
+
+        auto record = nlohmann::ordered_json();
+        record["time"] = fmt::format("{:04}-{:02}-{:02}T{:02}:{:02}:{:02}.{:03}Z",
+                                     parts.tm_year + 1900, parts.tm_mon + 1, parts.tm_mday,
+                                     parts.tm_hour, parts.tm_min, parts.tm_sec,
+                                     times[row] / 1'000'000 % 1000);
+        record["level"] = levelNames.at(static_cast<std::size_t>(levels[row]));
+        record["app"] = apps.values[apps.ids[row]];
+        record["module"] = modules.values[modules.ids[row]];
+        record["file"] = fmt::format("{}:{}", callSites.files[site.file], site.line);
+        record["thread"] = threads[row];
+        record["message"] = messages.At(row);
+        std::cout << record.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace)
+                  << '\n';
+    }
+}
+
+/// @brief Filters a columnar segment, returns the number of matching records
+std::uint64_t querySegment(const std::filesystem::path & path, const Arguments & arguments)
+{
+    const auto segment = ColumnarSegmentReader::Open(path);
+    const auto rows = segment->Select(arguments.query);
+    if (!arguments.countOnly && !rows.empty()) {
+        printRows(*segment, rows);
+    }
+    return rows.size();
+}
+
+/// @brief Returns the parts of a log file worth scanning, narrowed by its index when present
+std::vector<std::string_view> textRanges(const std::filesystem::path & path,
+                                         const MappedFile & file, const SegmentQuery & query)
+{
+    auto indexPath = path;
+    indexPath += FileIndexExtension;
+    if (!std::filesystem::exists(indexPath)) {
+        return { file.View() };
+    }
+
+    const auto index = LogFileIndex::Open(path);
+    auto views = std::vector<std::string_view>();
+    for (const auto & range : index->Ranges(FileIndexQuery{ .minLevel = query.minLevel,
+                                                            .module = query.module,
+                                                            .since = query.since,
+                                                            .until = query.until })) {
+        views.push_back(file.View(range.offset, range.length));
+    }
+    return views;
+}
+
+/// @brief Filters a JSON or terminal log file, returns the number of matching records
+std::uint64_t queryText(const std::filesystem::path & path, const Arguments & arguments)
+{
+    const auto & query = arguments.query;
+    const auto filter = TextRecordFilter(TextLogQuery{ .minLevel = query.minLevel,
+                                                       .app = query.app,
+                                                       .module = query.module,
+                                                       .since = query.since,
+                                                       .until = query.until,
+                                                       .contains = query.contains });
+    const auto file = MappedFile::Open(path);
+
+    auto matched = std::uint64_t(0);
+    for (const auto text : textRanges(path, *file, query)) {
+        // Each part collects its matches, parts are printed in file order
+        auto outputs = std::vector<std::string>(arguments.threads);
+        auto counts = std::vector<std::uint64_t>(arguments.threads);
+        TextScan::ForEachLineParallel(
+            text, arguments.threads,
+            [&filter, &outputs, &counts, &arguments](std::size_t part, std::string_view line) {
+                if (!filter.Matches(line)) {
+                    return;
+                }
+                counts[part] += 1;
+                if (!arguments.countOnly) {
+                    outputs[part].append(line);
+                    outputs[part].push_back('\n');
+                }
+            });
+
+        for (auto part = std::size_t(0); part < outputs.size(); ++part) {
+            matched += counts[part];
+            std::fwrite(outputs[part].data(), 1, outputs[part].size(), stdout);
+        }
+    }
+    return matched;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    const auto arguments = parseArguments(argc, argv);
+    if (!arguments) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    auto matched = std::uint64_t(0);
+    for (const auto & path : arguments->paths) {
+        try {
+            matched += path.extension() == SegmentExtension ? querySegment(path, *arguments)
+                                                            : queryText(path, *arguments);
+        } catch (const std::exception & error) {
+            std::cerr << "kvalog_query: " << path.string() << ": " << error.what() << std::endl;
+        }
+    }
+
+    if (arguments->countOnly) {
+        std::cout << matched << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
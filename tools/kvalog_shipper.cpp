@@ -0,0 +1,234 @@
+// kvalog_shipper: forwards records from a kvalog shared ring to a file or a socket.
+//
+// Usage:
+//   kvalog_shipper [--ring PATH] --file PATH
+//   kvalog_shipper [--ring PATH] (--tcp HOST:PORT | --udp HOST:PORT | --unix PATH)
+//                  [--framing none|length|octet|null]
+//
+// The shipper can be stopped and restarted at any time: the read position lives in the ring,
+// so a restarted shipper continues with the first record it has not forwarded yet. Records
+// stay in the ring while the socket is down or its send queue is more than half full; the ring
+// then fills up and the producer drops and counts new records instead of the shipper.
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "kvalog_network.hpp"
+#include "kvalog_shm.hpp"
+
+using namespace kvalog;
+
+namespace
+{
+
+/// @brief Most records handed to the output per poll
+constexpr std::size_t PollBatch = 1024;
+/// @brief Part of the socket queue limit that must be free before more records are polled
+constexpr std::size_t QueueHeadroomDivisor = 2;
+/// @brief Longest sleep while the ring is empty
+constexpr auto MaxIdleSleep = std::chrono::milliseconds(10);
+/// @brief Delay between attempts to attach to a ring that does not exist yet
+constexpr auto AttachRetryDelay = std::chrono::milliseconds(200);
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int)
+{
+    stopRequested = 1;
+}
+
+struct Arguments {
+    std::string ring = DefaultSharedRingPath;
+    std::string file;
+    std::optional<SocketOptions> socket;
+};
+
+void printUsage()
+{
+    std::cerr << "usage: kvalog_shipper [--ring PATH] --file PATH\n"
+                 "       kvalog_shipper [--ring PATH] (--tcp HOST:PORT | --udp HOST:PORT | "
+                 "--unix PATH) [--framing none|length|octet|null]\n";
+}
+
+std::optional<SocketOptions> parseEndpoint(const std::string & option, const std::string & value)
+{
+    if (option == "--unix") {
+        return SocketOptions::Unix(value);
+    }
+
+    const auto colon = value.rfind(':');
+    if (colon == std::string::npos) {
+        return std::nullopt;
+    }
+    const auto host = value.substr(0, colon);
+    const auto port =
+        static_cast<std::uint16_t>(std::strtoul(value.c_str() + colon + 1, nullptr, 10));
+    return option == "--tcp" ? SocketOptions::Tcp(host, port) : SocketOptions::Udp(host, port);
+}
+
+std::optional<Arguments> parseArguments(int argc, char ** argv)
+{
+    auto arguments = Arguments();
+    auto framing = SocketFraming::None;
+
+    for (auto index = 1; index + 1 < argc; index += 2) {
+        const auto option = std::string(argv[index]);
+        const auto value = std::string(argv[index + 1]);
+        if (option == "--ring") {
+            arguments.ring = value;
+        } else if (option == "--file") {
+            arguments.file = value;
+        } else if (option == "--tcp" || option == "--udp" || option == "--unix") {
+            arguments.socket = parseEndpoint(option, value);
+            if (!arguments.socket) {
+                return std::nullopt;
+            }
+        } else if (option == "--framing") {
+            if (value == "length") {
+                framing = SocketFraming::LengthPrefix;
+            } else if (value == "octet") {
+                framing = SocketFraming::OctetCounting;
+            } else if (value == "null") {
+                framing = SocketFraming::NullTerminated;
+            } else if (value != "none") {
+                return std::nullopt;
+            }
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    if (argc % 2 == 0 || arguments.file.empty() == !arguments.socket.has_value()) {
+        return std::nullopt;
+    }
+    if (arguments.socket) {
+        arguments.socket->framing = framing;
+    }
+    return arguments;
+}
+
+/// @brief Attaches to the ring, waiting for the producer to create it
+std::unique_ptr<SharedRing> attach(const std::string & path)
+{
+    while (stopRequested == 0) {
+        try {
+            return SharedRing::Attach(path);
+        } catch (const std::exception &) {
+            std::this_thread::sleep_for(AttachRetryDelay);
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+    const auto arguments = parseArguments(argc, argv);
+    if (!arguments) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    auto file = std::unique_ptr<std::FILE, int (*)(std::FILE *)>(nullptr, std::fclose);
+    auto adapter = std::shared_ptr<SocketNetworkAdapter>();
+    if (arguments->socket) {
+        adapter = SocketNetworkAdapter::Create(*arguments->socket);
+    } else {
+        file.reset(std::fopen(arguments->file.c_str(), "ab"));
+        if (!file) {
+            std::perror(arguments->file.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto writeFailed = false;
+    const auto forward = [&file, &adapter, &writeFailed](std::string_view record) {
+        if (file) {
+            writeFailed = std::fwrite(record.data(), 1, record.size(), file.get()) != record.size();
+        } else {
+            adapter->SendLog(std::string(record));
+        }
+    };
+
+    // Records are taken from the ring only while the output can accept them
+    const auto queueLimit = arguments->socket ? arguments->socket->maxQueuedBytes : 0;
+    const auto ready = [&file, &adapter, &writeFailed, queueLimit] {
+        if (file) {
+            return !writeFailed;
+        }
+        return adapter->IsConnected() &&
+               adapter->QueuedBytes() < queueLimit / QueueHeadroomDivisor;
+    };
+
+    auto ring = attach(arguments->ring);
+    const auto poll = [&ring, &forward, &ready](std::size_t maxRecords) {
+        auto handled = std::size_t(0);
+        while (handled < maxRecords && ready() && ring->Poll(forward, 1) > 0) {
+            handled += 1;
+        }
+        return handled;
+    };
+
+    auto generation = ring ? ring->Header().generation.load() : 0;
+    auto idleSleep = std::chrono::milliseconds(0);
+    auto handled = std::uint64_t(0);
+
+    while (ring && stopRequested == 0) {
+        // A restarted producer re-initializes the ring, possibly with another capacity
+        if (ring->Header().generation.load(std::memory_order_acquire) != generation) {
+            ring = attach(arguments->ring);
+            generation = ring ? ring->Header().generation.load() : 0;
+            std::cerr << "kvalog_shipper: producer restarted, generation " << generation
+                      << std::endl;
+            continue;
+        }
+
+        const auto polled = poll(PollBatch);
+        handled += polled;
+        if (polled > 0) {
+            idleSleep = std::chrono::milliseconds(0);
+            continue;
+        }
+        if (file && (writeFailed || std::fflush(file.get()) != 0)) {
+            writeFailed = true;
+            break;
+        }
+
+        // The ring is empty, or the output cannot take more records yet
+        idleSleep = std::min(idleSleep + std::chrono::milliseconds(1), MaxIdleSleep);
+        std::this_thread::sleep_for(idleSleep);
+    }
+
+    if (!ring) {
+        return EXIT_SUCCESS;
+    }
+
+    // Records the output cannot take stay in the ring for the next shipper
+    handled += poll(std::numeric_limits<std::size_t>::max());
+    if (file && !writeFailed && std::fflush(file.get()) != 0) {
+        writeFailed = true;
+    }
+    if (writeFailed) {
+        std::perror(arguments->file.c_str());
+    }
+
+    const auto adapterDropped = adapter ? adapter->GetStatistics().droppedRecords : 0;
+    std::cerr << "kvalog_shipper: forwarded " << handled - std::min(handled, adapterDropped)
+              << " records, socket adapter dropped " << adapterDropped << ", producer dropped "
+              << ring->Header().droppedRecords.load() << ", " << ring->Backlog()
+              << " bytes left in the ring" << std::endl;
+    return writeFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}